@@ -1,4 +1,11 @@
 #include "BloomFilter.h"
+#include "../MurmurHash3/MurmurHash3.h"
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define BLOOM_SSE2
+#endif
 
 /*
     * Format zapisa:
@@ -9,6 +16,11 @@
     * h2_seed - 8 bajta, size_t pretpostavljeno 64-bitno
     * bitSet bajtovi (m + 7) / 8 bajtova
 
+    * Blokirani filter ima isto zaglavlje, samo sa drugim znacenjem polja:
+    * m = BLOCKED_MARKER_ODD, k, p, timeConst (seed za MurmurHash3), na mestu h2_seed broj blokova (8 bajta)
+    * (BLOCKED_MARKER je stariji zapis sa korakom probanja koji je mogao biti paran, i dalje se cita)
+    * zatim blokovi, po 64 bajta
+
     memcpy() - is used to copy a block of memory from one location to another.
     => copies the specified number of bytes from one memory location to another regardless of data type stored
     in <string.h>
@@ -25,17 +37,28 @@ using namespace std;
 
 BloomFilter::BloomFilter() {};
 
-BloomFilter::BloomFilter(unsigned int n, double falsePositiveRate) {
+BloomFilter::BloomFilter(unsigned int n, double falsePositiveRate, bool useBlocks) {
 	// Calculate size of bit set
     m = calculateSizeOfBitSet(n, falsePositiveRate);
 	// Calculate number of hash functions
     k = calculateNumberOfHashFunctions(n, m);
     p = falsePositiveRate;
-	// Initialize bit set - na pocetku su svi bitovi postavljeni na 0
-    bitSet = vector<bool>(m, false);
 	// Seed for generating hash functions
     timeConst = static_cast<unsigned int>(time(nullptr));
 
+    if (useBlocks) {
+        // m zaokruzujemo na cele blokove, hash funkcije ne trebaju
+        blocked = true;
+        numBlocks = std::max<uint64_t>(1, (static_cast<uint64_t>(m) + 511) / 512);
+        m = static_cast<unsigned int>(numBlocks * 512);
+        h2_seed = 0;
+        blocks.assign(numBlocks * WORDS_PER_BLOCK, 0);
+        return;
+    }
+
+	// Initialize bit set - na pocetku su svi bitovi postavljeni na 0
+    bitSet = vector<bool>(m, false);
+
 	// Koristimo double hashing tehniku => trebaju nam dve hash funkcije
 	// h1 = hash(key)
 	// h2 = hash(to_string(h2_seed) + key)
@@ -64,7 +87,55 @@ BloomFilter::BloomFilter(unsigned int n, double falsePositiveRate) {
     }
 }
 
+void BloomFilter::blockMask(const string& elem, uint64_t& block, uint64_t mask[WORDS_PER_BLOCK]) const {
+    uint64_t h[2];
+    MurmurHash3_x64_128(elem.data(), static_cast<int>(elem.size()), timeConst, h);
+    uint64_t hash = h[0];
+
+    // Blok biramo gornjih 32 bita (mnozenje i shift umesto %), bitove u bloku donjih 32 bita
+    block = ((hash >> 32) * numBlocks) >> 32;
+
+    // Double hashing: i-ti bit je h1 + i * delta (mod 512)
+    uint32_t h1 = static_cast<uint32_t>(hash);
+    uint32_t delta = (h1 >> 17) | (h1 << 15);
+    // Neparan korak je uzajamno prost sa 512, pa k <= 512 probanja pogadja k razlicitih bitova
+    if (oddStep) {
+        delta |= 1;
+    }
+
+    memset(mask, 0, WORDS_PER_BLOCK * sizeof(uint64_t));
+    for (unsigned int i = 0; i < k; ++i) {
+        uint32_t bit = h1 & 511;
+        mask[bit >> 6] |= uint64_t(1) << (bit & 63);
+        h1 += delta;
+    }
+}
+
 bool BloomFilter::possiblyContains(const string& elem) const {
+    if (blocked) {
+        uint64_t block;
+        alignas(64) uint64_t mask[WORDS_PER_BLOCK];
+        blockMask(elem, block, mask);
+        const uint64_t* words = blocks.data() + block * WORDS_PER_BLOCK;
+
+        // Kljuc je mozda u skupu ako su svi bitovi maske postavljeni i u bloku: (~blok & maska) == 0
+#ifdef BLOOM_SSE2
+        __m128i missing = _mm_setzero_si128();
+        for (unsigned int i = 0; i < WORDS_PER_BLOCK; i += 2) {
+            __m128i w = _mm_load_si128(reinterpret_cast<const __m128i*>(words + i));
+            __m128i bits = _mm_load_si128(reinterpret_cast<const __m128i*>(mask + i));
+            missing = _mm_or_si128(missing, _mm_andnot_si128(w, bits));
+        }
+        return _mm_movemask_epi8(_mm_cmpeq_epi8(missing, _mm_setzero_si128())) == 0xFFFF;
+#else
+        uint64_t missing = 0;
+        for (unsigned int i = 0; i < WORDS_PER_BLOCK; ++i) {
+            missing |= mask[i] & ~words[i];
+        }
+        return missing == 0;
+#endif
+    }
+
 	// Proveravamo da li je element u skupu
 	// Ako je bar jedan bit postavljen na 0, onda element sigurno nije u skupu
 	// Ako su svi bitovi postavljeni na 1, onda element mozda jeste u skupu
@@ -80,12 +151,44 @@ bool BloomFilter::possiblyContains(const string& elem) const {
 }
 
 void BloomFilter::add(const string& elem) {
+    if (blocked) {
+        uint64_t block;
+        uint64_t mask[WORDS_PER_BLOCK];
+        blockMask(elem, block, mask);
+        uint64_t* words = blocks.data() + block * WORDS_PER_BLOCK;
+        for (unsigned int i = 0; i < WORDS_PER_BLOCK; ++i) {
+            words[i] |= mask[i];
+        }
+        return;
+    }
+
     for (const auto& hashFunction : hashFunctions) {
         bitSet[hashFunction(elem)] = true;
     }
 }
 
 vector<byte> BloomFilter::serialize() const {
+    if (blocked) {
+        size_t blockBytes = blocks.size() * sizeof(uint64_t);
+        vector<byte> data(sizeof(m) + sizeof(k) + sizeof(p) + sizeof(timeConst) + sizeof(numBlocks) + blockBytes);
+        size_t offset = 0;
+
+        unsigned int marker = oddStep ? BLOCKED_MARKER_ODD : BLOCKED_MARKER;
+        memcpy(data.data() + offset, &marker, sizeof(marker));
+        offset += sizeof(marker);
+        memcpy(data.data() + offset, &k, sizeof(k));
+        offset += sizeof(k);
+        memcpy(data.data() + offset, &p, sizeof(p));
+        offset += sizeof(p);
+        memcpy(data.data() + offset, &timeConst, sizeof(timeConst));
+        offset += sizeof(timeConst);
+        memcpy(data.data() + offset, &numBlocks, sizeof(numBlocks));
+        offset += sizeof(numBlocks);
+        memcpy(data.data() + offset, blocks.data(), blockBytes);
+
+        return data;
+    }
+
     // Izracunamo koliko bajtova treba za bitSet
     size_t bitBytes = (m + 7) / 8;
     size_t totalSize = sizeof(m) + sizeof(k) + sizeof(p) + sizeof(timeConst) + sizeof(h2_seed) + bitBytes;
@@ -129,6 +232,43 @@ vector<byte> BloomFilter::serialize() const {
 }
 
 BloomFilter BloomFilter::deserialize(const vector<byte>& data) {
+    unsigned int firstField = 0;
+    if (data.size() >= sizeof(firstField)) {
+        memcpy(&firstField, data.data(), sizeof(firstField));
+    }
+
+    if (firstField == BLOCKED_MARKER || firstField == BLOCKED_MARKER_ODD) {
+        BloomFilter bf;
+        bf.blocked = true;
+        bf.oddStep = firstField == BLOCKED_MARKER_ODD;
+
+        size_t offset = sizeof(firstField);
+        size_t headerSize = offset + sizeof(bf.k) + sizeof(bf.p) + sizeof(bf.timeConst) + sizeof(bf.numBlocks);
+        if (data.size() < headerSize) {
+            throw runtime_error("[BloomFilter] Nepotpuno zaglavlje blokiranog filtera");
+        }
+
+        memcpy(&bf.k, data.data() + offset, sizeof(bf.k));
+        offset += sizeof(bf.k);
+        memcpy(&bf.p, data.data() + offset, sizeof(bf.p));
+        offset += sizeof(bf.p);
+        memcpy(&bf.timeConst, data.data() + offset, sizeof(bf.timeConst));
+        offset += sizeof(bf.timeConst);
+        memcpy(&bf.numBlocks, data.data() + offset, sizeof(bf.numBlocks));
+        offset += sizeof(bf.numBlocks);
+
+        size_t blockBytes = bf.numBlocks * WORDS_PER_BLOCK * sizeof(uint64_t);
+        if (bf.numBlocks == 0 || data.size() - offset < blockBytes) {
+            throw runtime_error("[BloomFilter] Nepotpuni blokovi filtera");
+        }
+
+        bf.m = static_cast<unsigned int>(bf.numBlocks * 512);
+        bf.h2_seed = 0;
+        bf.blocks.resize(bf.numBlocks * WORDS_PER_BLOCK);
+        memcpy(bf.blocks.data(), data.data() + offset, blockBytes);
+        return bf;
+    }
+
     BloomFilter bf(1, 0.01); // Kreiramo privremeni, odmah cemo ga prepisati
     // Ovaj konstruktor nije bitan, jer cemo sve parametre prepisati iz data
     // a potom ponovo kreirati hashFunctions.
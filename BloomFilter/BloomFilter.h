@@ -8,6 +8,24 @@
 #include <cstring>
 #include <stdexcept>
 #include <random>
+#include <cstdint>
+#include <cstddef>
+#include <new>
+
+// Alokator koji poravnava niz na kes liniju (64 bajta), da jedan blok filtera bude tacno jedna linija
+template <typename T>
+struct CacheLineAllocator {
+    using value_type = T;
+
+    CacheLineAllocator() = default;
+    template <typename U> CacheLineAllocator(const CacheLineAllocator<U>&) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(::operator new(n * sizeof(T), std::align_val_t(64))); }
+    void deallocate(T* ptr, size_t) { ::operator delete(ptr, std::align_val_t(64)); }
+
+    template <typename U> bool operator==(const CacheLineAllocator<U>&) const { return true; }
+    template <typename U> bool operator!=(const CacheLineAllocator<U>&) const { return false; }
+};
 
 class BloomFilter {
 private:
@@ -19,10 +37,26 @@ private:
     unsigned int timeConst; // Seed for generating hash functions
     size_t h2_seed;         // Seed for the second hash function
 
+    // Blokirani filter: svih k bitova jednog kljuca je u istom bloku od 512 bitova (jedna kes linija).
+    // Provera je jedan MurmurHash3 i jedan pristup memoriji umesto k hash funkcija i k promasaja kesa,
+    // po cenu nesto vise laznih pozitivnih za isti m.
+    static constexpr unsigned int BLOCKED_MARKER = 0xFFFFFFFF; // stoji umesto m u serijalizovanom zaglavlju (stari zapis, korak moze biti paran)
+    static constexpr unsigned int BLOCKED_MARKER_ODD = 0xFFFFFFFD; // isto, ali je korak probanja neparan (0xFFFFFFFE je XorFilter)
+    static constexpr unsigned int WORDS_PER_BLOCK = 8;         // 8 * 64 bita = 64 bajta
+    bool blocked = false;
+    bool oddStep = true;     // false samo za filtere ucitane sa BLOCKED_MARKER
+    uint64_t numBlocks = 0;
+    std::vector<uint64_t, CacheLineAllocator<uint64_t>> blocks;
+
+    // Indeks bloka i maska bitova kljuca unutar bloka
+    void blockMask(const std::string& elem, uint64_t& block, uint64_t mask[WORDS_PER_BLOCK]) const;
+
 public:
     // Constructor
     BloomFilter();
-    BloomFilter(unsigned int n, double falsePositiveRate);
+    BloomFilter(unsigned int n, double falsePositiveRate, bool useBlocks = false);
+
+    bool isBlocked() const { return blocked; }
 
     // Add an element to the Bloom Filter
     void add(const std::string& elem);
@@ -0,0 +1,316 @@
+#include "RangeFilter.h"
+#include <algorithm>
+#include <bitset>
+#include <cstring>
+#include <deque>
+#include <stdexcept>
+
+/*
+    * Format zapisa:
+    * keyCount - 4 bajta
+    * nodeCount - 4 bajta
+    * labelCount - 4 bajta
+    * labels - labelCount bajtova
+    * hasChild, louds - po (labelCount + 63) / 64 reci od 8 bajtova
+    * prefixKey - (nodeCount + 63) / 64 reci od 8 bajtova
+    * suffixes - po bajt za svaki list (grana sa hasChild = 0)
+*/
+
+using namespace std;
+
+static size_t popcount(uint64_t w) {
+    return bitset<64>(w).count();
+}
+
+void RangeFilter::BitVector::push(bool bit) {
+    if (numBits % 64 == 0) words.push_back(0);
+    if (bit) words.back() |= 1ULL << (numBits % 64);
+    numBits++;
+}
+
+bool RangeFilter::BitVector::get(size_t pos) const {
+    return (words[pos / 64] >> (pos % 64)) & 1;
+}
+
+void RangeFilter::BitVector::buildRank() {
+    blockRank.assign(words.size() / 8 + 1, 0);
+    uint32_t ones = 0;
+    for (size_t w = 0; w < words.size(); ++w) {
+        if (w % 8 == 0) blockRank[w / 8] = ones;
+        ones += static_cast<uint32_t>(popcount(words[w]));
+    }
+    if (words.size() % 8 == 0) blockRank[words.size() / 8] = ones;
+}
+
+size_t RangeFilter::BitVector::rank1(size_t pos) const {
+    size_t w = pos / 64;
+    size_t ones = blockRank[w / 8];
+    for (size_t i = w / 8 * 8; i < w; ++i) {
+        ones += popcount(words[i]);
+    }
+    if (pos % 64 != 0) {
+        ones += popcount(words[w] & ((1ULL << (pos % 64)) - 1));
+    }
+    return ones;
+}
+
+size_t RangeFilter::BitVector::select1(size_t k) const {
+    // Poslednji blok koji pre sebe ima manje od k jedinica
+    size_t block = upper_bound(blockRank.begin(), blockRank.end(), static_cast<uint32_t>(k - 1)) - blockRank.begin() - 1;
+    size_t ones = blockRank[block];
+
+    size_t w = block * 8;
+    while (ones + popcount(words[w]) < k) {
+        ones += popcount(words[w]);
+        ++w;
+    }
+
+    uint64_t word = words[w];
+    for (size_t bit = 0;; ++bit) {
+        if ((word >> bit) & 1) {
+            if (++ones == k) return w * 64 + bit;
+        }
+    }
+}
+
+RangeFilter::RangeFilter(const vector<string>& sortedKeys) {
+    vector<string> keys;
+    keys.reserve(sortedKeys.size());
+    for (const auto& key : sortedKeys) {
+        if (keys.empty() || keys.back() != key) keys.push_back(key);
+    }
+    keyCount = static_cast<uint32_t>(keys.size());
+    if (keys.empty()) return;
+
+    auto commonPrefix = [&](size_t i) {
+        const string& a = keys[i - 1];
+        const string& b = keys[i];
+        size_t n = 0;
+        while (n < a.size() && n < b.size() && a[n] == b[n]) ++n;
+        return n;
+    };
+
+    // Skraceni kljuc: jedan bajt vise od najduzeg zajednickog prefiksa sa susedima
+    vector<string> truncated(keys.size());
+    size_t lcpPrev = 0;
+    for (size_t i = 0; i < keys.size(); ++i) {
+        size_t lcpNext = i + 1 < keys.size() ? commonPrefix(i + 1) : 0;
+        size_t len = min(keys[i].size(), max(lcpPrev, lcpNext) + 1);
+        truncated[i] = keys[i].substr(0, len);
+        lcpPrev = lcpNext;
+    }
+
+    // Cvorovi redom po nivoima; cvor je opseg skracenih kljuceva sa zajednickih depth bajtova
+    struct Node { size_t lo, hi, depth; };
+    deque<Node> queue;
+    queue.push_back({ 0, truncated.size(), 0 });
+
+    while (!queue.empty()) {
+        Node node = queue.front();
+        queue.pop_front();
+        nodeCount++;
+
+        // Sortirano je, pa je kljuc koji se zavrsava bas u ovom cvoru prvi
+        bool endsHere = truncated[node.lo].size() == node.depth;
+        prefixKey.push(endsHere);
+
+        bool first = true;
+        for (size_t i = node.lo + (endsHere ? 1 : 0); i < node.hi;) {
+            uint8_t label = static_cast<uint8_t>(truncated[i][node.depth]);
+            size_t j = i;
+            while (j < node.hi && static_cast<uint8_t>(truncated[j][node.depth]) == label) ++j;
+
+            bool leaf = j - i == 1 && truncated[i].size() == node.depth + 1;
+            labels.push_back(label);
+            louds.push(first);
+            hasChild.push(!leaf);
+            if (!leaf) queue.push_back({ i, j, node.depth + 1 });
+            else suffixes.push_back(keys[i].size() > node.depth + 1 ? static_cast<uint8_t>(keys[i][node.depth + 1]) : 0);
+
+            first = false;
+            i = j;
+        }
+    }
+
+    hasChild.buildRank();
+    louds.buildRank();
+    prefixKey.buildRank();
+}
+
+size_t RangeFilter::nodeStart(size_t node) const {
+    return louds.select1(node + 1);
+}
+
+size_t RangeFilter::nodeEnd(size_t node) const {
+    return node + 1 < nodeCount ? louds.select1(node + 2) : labels.size();
+}
+
+size_t RangeFilter::childOf(size_t pos) const {
+    // Koren je cvor 0, a cvorovi su numerisani redom kojim grane sa decom idu u labels
+    return hasChild.rank1(pos + 1);
+}
+
+size_t RangeFilter::leafOf(size_t pos) const {
+    return pos - hasChild.rank1(pos);
+}
+
+void RangeFilter::appendLeftmost(size_t pos, string& out) const {
+    while (hasChild.get(pos)) {
+        size_t child = childOf(pos);
+        if (prefixKey.get(child)) return;
+        pos = nodeStart(child);
+        out.push_back(static_cast<char>(labels[pos]));
+    }
+
+    // Sufiks 0 moze znaciti i da kljuc nema vise bajtova, pa ga ne dodajemo (ostajemo <= originala)
+    uint8_t suffix = suffixes[leafOf(pos)];
+    if (suffix != 0) out.push_back(static_cast<char>(suffix));
+}
+
+bool RangeFilter::nextAfter(vector<pair<size_t, size_t>>& path, const string& key, string& out) const {
+    while (!path.empty()) {
+        auto step = path.back(); // (grana, kraj cvora)
+        path.pop_back();
+        if (step.first + 1 < step.second) {
+            out.assign(key, 0, path.size());
+            out.push_back(static_cast<char>(labels[step.first + 1]));
+            appendLeftmost(step.first + 1, out);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool RangeFilter::lowerBound(const string& key, string& out) const {
+    vector<pair<size_t, size_t>> path; // (grana, kraj cvora) na svakoj dubini
+
+    size_t node = 0;
+    while (true) {
+        size_t depth = path.size();
+        size_t start = nodeStart(node);
+        size_t end = nodeEnd(node);
+
+        if (depth == key.size()) {
+            // Ceo key je put do ovog cvora, pa je sve u podstablu >= key
+            out.assign(key);
+            if (!prefixKey.get(node)) {
+                out.push_back(static_cast<char>(labels[start]));
+                appendLeftmost(start, out);
+            }
+            return true;
+        }
+
+        // Kljuc koji se zavrsava u ovom cvoru je pravi prefiks od key, dakle manji: preskacemo ga
+        uint8_t c = static_cast<uint8_t>(key[depth]);
+        size_t pos = lower_bound(labels.begin() + start, labels.begin() + end, c) - labels.begin();
+
+        if (pos < end && labels[pos] == c) {
+            if (!hasChild.get(pos)) {
+                // Skraceni kljuc je prefiks od key: o originalu odlucuje sledeci bajt
+                out.assign(key, 0, depth + 1);
+                if (depth + 1 == key.size()) return true;
+
+                uint8_t suffix = suffixes[leafOf(pos)];
+                uint8_t next = static_cast<uint8_t>(key[depth + 1]);
+                if (suffix > next) {
+                    out.push_back(static_cast<char>(suffix));
+                    return true;
+                }
+                if (suffix == next) return true;
+
+                // Originalni kljuc je manji od key, trazimo sledeci
+                path.push_back({ pos, end });
+                return nextAfter(path, key, out);
+            }
+            path.push_back({ pos, end });
+            node = childOf(pos);
+            continue;
+        }
+
+        if (pos < end) {
+            out.assign(key, 0, depth);
+            out.push_back(static_cast<char>(labels[pos]));
+            appendLeftmost(pos, out);
+            return true;
+        }
+
+        // U ovom cvoru nema vece grane: vracamo se do pretka koji ima sledecu
+        return nextAfter(path, key, out);
+    }
+}
+
+bool RangeFilter::mayContainRange(const string& from, const string& to) const {
+    if (keyCount == 0) return true;
+    if (to < from) return false;
+
+    // Jedini kljuc je prazan string, pa trie nema nijednu granu
+    if (labels.empty()) return from.empty();
+
+    // Originalni kljuc pocinje skracenim, pa je >= njega: ako je skraceni > to, nista ne upada
+    string candidate;
+    if (!lowerBound(from, candidate)) return false;
+    return candidate <= to;
+}
+
+vector<byte> RangeFilter::serialize() const {
+    uint32_t labelCount = static_cast<uint32_t>(labels.size());
+    size_t labelWords = (labels.size() + 63) / 64;
+    size_t nodeWords = (nodeCount + 63) / 64;
+
+    vector<byte> data(3 * sizeof(uint32_t) + labels.size() + (2 * labelWords + nodeWords) * sizeof(uint64_t) + suffixes.size());
+    size_t offset = 0;
+
+    auto put = [&](const void* src, size_t len) {
+        if (len > 0) memcpy(data.data() + offset, src, len);
+        offset += len;
+    };
+
+    put(&keyCount, sizeof(keyCount));
+    put(&nodeCount, sizeof(nodeCount));
+    put(&labelCount, sizeof(labelCount));
+    put(labels.data(), labels.size());
+    put(hasChild.words.data(), labelWords * sizeof(uint64_t));
+    put(louds.words.data(), labelWords * sizeof(uint64_t));
+    put(prefixKey.words.data(), nodeWords * sizeof(uint64_t));
+    put(suffixes.data(), suffixes.size());
+
+    return data;
+}
+
+RangeFilter RangeFilter::deserialize(const vector<byte>& data) {
+    RangeFilter rf;
+    uint32_t labelCount = 0;
+    size_t offset = 0;
+
+    auto take = [&](void* dst, size_t len) {
+        if (data.size() - offset < len) {
+            throw runtime_error("[RangeFilter] Nepotpun zapis filtera");
+        }
+        if (len > 0) memcpy(dst, data.data() + offset, len);
+        offset += len;
+    };
+    auto takeBits = [&](BitVector& bits, size_t numBits) {
+        bits.numBits = numBits;
+        bits.words.resize((numBits + 63) / 64);
+        take(bits.words.data(), bits.words.size() * sizeof(uint64_t));
+        bits.buildRank();
+    };
+
+    if (data.size() < 3 * sizeof(uint32_t)) {
+        throw runtime_error("[RangeFilter] Neispravno zaglavlje filtera");
+    }
+    take(&rf.keyCount, sizeof(rf.keyCount));
+    take(&rf.nodeCount, sizeof(rf.nodeCount));
+    take(&labelCount, sizeof(labelCount));
+
+    rf.labels.resize(labelCount);
+    take(rf.labels.data(), labelCount);
+    takeBits(rf.hasChild, labelCount);
+    takeBits(rf.louds, labelCount);
+    takeBits(rf.prefixKey, rf.nodeCount);
+
+    rf.suffixes.resize(labelCount - rf.hasChild.rank1(labelCount));
+    take(rf.suffixes.data(), rf.suffixes.size());
+
+    return rf;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+
+/*
+    * Range filter po uzoru na SuRF-Real (Zhang i dr.): sazet trie nad skracenim kljucevima.
+    *
+    * Svaki kljuc se skrati na najkraci prefiks koji ga razlikuje od suseda u sortiranom nizu,
+    * pa trie ima onoliko listova koliko kljuceva, ali samo cvorove do mesta gde se kljucevi razilaze.
+    * Trie je zapisan nivo po nivo (LOUDS-Sparse):
+    *  - labels:    jedan bajt po grani
+    *  - hasChild:  1 ako grana vodi u cvor, 0 ako je list (skraceni kljuc)
+    *  - louds:     1 na prvoj grani svakog cvora
+    *  - prefixKey: po cvoru, 1 ako je put do cvora ujedno i ceo kljuc (kljuc je prefiks drugog kljuca)
+    *  - suffixes:  po listu, prvi odseceni bajt kljuca (0 ako ga nema)
+    * Kretanje kroz trie je rank/select nad bit vektorima, ~10 bita po grani i 8 po kljucu.
+    *
+    * Pitanje "ima li kljuca u [from, to]": nadji najmanji skraceni kljuc koji moze biti >= from
+    * i proveri da li je <= to. Nema laznih negativnih; lazni pozitivni su opsezi koji padnu
+    * izmedju kljuceva sa istim skracenim prefiksom i istim sledecim bajtom.
+*/
+class RangeFilter {
+public:
+    RangeFilter() = default;
+    // Kljucevi moraju biti sortirani
+    explicit RangeFilter(const std::vector<std::string>& sortedKeys);
+
+    // Filter koji nije napravljen za svaki opseg kaze "mozda"
+    bool mayContainRange(const std::string& from, const std::string& to) const;
+
+    std::vector<std::byte> serialize() const;
+    static RangeFilter deserialize(const std::vector<std::byte>& data);
+
+private:
+    // Bit vektor sa rank/select; rank se cuva na svakih 512 bita
+    struct BitVector {
+        std::vector<uint64_t> words;
+        std::vector<uint32_t> blockRank; // broj jedinica pre svakog bloka od 8 reci
+        size_t numBits = 0;
+
+        void push(bool bit);
+        bool get(size_t pos) const;
+        void buildRank();
+        size_t rank1(size_t pos) const;   // jedinice u [0, pos)
+        size_t select1(size_t k) const;   // pozicija k-te jedinice, k >= 1
+    };
+
+    uint32_t keyCount = 0;
+    uint32_t nodeCount = 0;
+    std::vector<uint8_t> labels;
+    BitVector hasChild;
+    BitVector louds;
+    BitVector prefixKey;
+    std::vector<uint8_t> suffixes;
+
+    size_t nodeStart(size_t node) const;
+    size_t nodeEnd(size_t node) const;
+    size_t childOf(size_t pos) const;
+    size_t leafOf(size_t pos) const;
+
+    // Dopisuje u out najmanji skraceni kljuc u podstablu grane pos (oznaka pos je vec u out)
+    void appendLeftmost(size_t pos, std::string& out) const;
+    // Sledeci skraceni kljuc posle grane na vrhu path-a (path je put kroz key)
+    bool nextAfter(std::vector<std::pair<size_t, size_t>>& path, const std::string& key, std::string& out) const;
+    // Najmanji skraceni kljuc ciji originalni kljuc moze biti >= key
+    bool lowerBound(const std::string& key, std::string& out) const;
+};
@@ -0,0 +1,193 @@
+#include "XorFilter.h"
+#include "../MurmurHash3/MurmurHash3.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <stdexcept>
+
+/*
+    * Format zapisa:
+    * XOR_MARKER - 4 bajta
+    * seed - 8 bajta
+    * blockLength - 4 bajta
+    * keyCount - 4 bajta
+    * otisci - 3 * blockLength bajtova
+*/
+
+using namespace std;
+
+uint64_t XorFilter::keyHash(const string& elem) {
+    uint64_t h[2];
+    MurmurHash3_x64_128(elem.data(), static_cast<int>(elem.size()), 0, h);
+    return h[0];
+}
+
+uint64_t XorFilter::mix(uint64_t h, uint64_t seed) {
+    // MurmurHash3 fmix64: svaki pokusaj konstrukcije dobija nove pozicije bez ponovnog hesiranja kljuceva
+    h += seed;
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ULL;
+    h ^= h >> 33;
+    return h;
+}
+
+uint8_t XorFilter::fingerprint(uint64_t h) {
+    return static_cast<uint8_t>(h ^ (h >> 32));
+}
+
+uint32_t XorFilter::position(uint64_t h, int segment) const {
+    // Za svaki segment drugi deo hash-a, pa mnozenje i shift umesto %
+    uint64_t rotated = segment == 0 ? h : ((h << (21 * segment)) | (h >> (64 - 21 * segment)));
+    uint32_t r = static_cast<uint32_t>(rotated);
+    return static_cast<uint32_t>((static_cast<uint64_t>(r) * blockLength) >> 32) + segment * blockLength;
+}
+
+XorFilter::XorFilter(const vector<string>& keys) {
+    vector<uint64_t> hashes;
+    hashes.reserve(keys.size());
+    for (const auto& key : keys) {
+        hashes.push_back(keyHash(key));
+    }
+
+    // Isti hash dvaput onemogucava ljustenje, a za filter je svejedno da li je kljuc upisan jednom ili dvaput
+    sort(hashes.begin(), hashes.end());
+    hashes.erase(unique(hashes.begin(), hashes.end()), hashes.end());
+
+    keyCount = static_cast<uint32_t>(hashes.size());
+    size_t capacity = 32 + static_cast<size_t>(ceil(1.23 * hashes.size()));
+    blockLength = static_cast<uint32_t>(capacity / 3);
+    capacity = 3 * static_cast<size_t>(blockLength);
+
+    vector<uint64_t> xorMask(capacity);
+    vector<uint32_t> count(capacity);
+    vector<uint32_t> queue;
+    vector<pair<uint64_t, uint32_t>> stack; // (hash, pozicija) redom kojim su kljucevi oljusteni
+    queue.reserve(capacity);
+    stack.reserve(hashes.size());
+
+    mt19937_64 rng(hashes.size());
+    bool built = false;
+
+    for (int attempt = 0; attempt < 100 && !built; ++attempt) {
+        seed = rng();
+        fill(xorMask.begin(), xorMask.end(), 0);
+        fill(count.begin(), count.end(), 0);
+        queue.clear();
+        stack.clear();
+
+        for (uint64_t kh : hashes) {
+            uint64_t h = mix(kh, seed);
+            for (int j = 0; j < 3; ++j) {
+                uint32_t i = position(h, j);
+                xorMask[i] ^= h;
+                count[i]++;
+            }
+        }
+
+        for (uint32_t i = 0; i < capacity; ++i) {
+            if (count[i] == 1) queue.push_back(i);
+        }
+
+        // Ljustenje: pozicija sa tacno jednim kljucem odredjuje taj kljuc, koji se onda uklanja sa ostale dve
+        while (!queue.empty()) {
+            uint32_t i = queue.back();
+            queue.pop_back();
+            if (count[i] != 1) continue;
+
+            uint64_t h = xorMask[i];
+            stack.emplace_back(h, i);
+            for (int j = 0; j < 3; ++j) {
+                uint32_t other = position(h, j);
+                xorMask[other] ^= h;
+                if (--count[other] == 1) queue.push_back(other);
+            }
+        }
+
+        built = stack.size() == hashes.size();
+    }
+
+    if (!built) {
+        cerr << "[XorFilter] Konstrukcija nije uspela za " << keyCount << " kljuceva\n";
+        blockLength = 0;
+        return;
+    }
+
+    // Unazad: pozicija kljuca jos nije upisana, pa je biramo tako da xor tri pozicije da otisak
+    fingerprints.assign(capacity, 0);
+    for (auto it = stack.rbegin(); it != stack.rend(); ++it) {
+        uint64_t h = it->first;
+        fingerprints[it->second] = 0;
+        fingerprints[it->second] = fingerprint(h)
+            ^ fingerprints[position(h, 0)]
+            ^ fingerprints[position(h, 1)]
+            ^ fingerprints[position(h, 2)];
+    }
+}
+
+bool XorFilter::possiblyContains(const string& elem) const {
+    if (fingerprints.empty()) return true;
+
+    uint64_t h = mix(keyHash(elem), seed);
+    return fingerprint(h) == (fingerprints[position(h, 0)]
+        ^ fingerprints[position(h, 1)]
+        ^ fingerprints[position(h, 2)]);
+}
+
+vector<byte> XorFilter::serialize() const {
+    unsigned int marker = XOR_MARKER;
+    vector<byte> data(sizeof(marker) + sizeof(seed) + sizeof(blockLength) + sizeof(keyCount) + fingerprints.size());
+    size_t offset = 0;
+
+    memcpy(data.data() + offset, &marker, sizeof(marker));
+    offset += sizeof(marker);
+    memcpy(data.data() + offset, &seed, sizeof(seed));
+    offset += sizeof(seed);
+    memcpy(data.data() + offset, &blockLength, sizeof(blockLength));
+    offset += sizeof(blockLength);
+    memcpy(data.data() + offset, &keyCount, sizeof(keyCount));
+    offset += sizeof(keyCount);
+    if (!fingerprints.empty()) {
+        memcpy(data.data() + offset, fingerprints.data(), fingerprints.size());
+    }
+
+    return data;
+}
+
+bool XorFilter::isXorFilter(const vector<byte>& data) {
+    unsigned int marker = 0;
+    if (data.size() < sizeof(marker)) return false;
+    memcpy(&marker, data.data(), sizeof(marker));
+    return marker == XOR_MARKER;
+}
+
+XorFilter XorFilter::deserialize(const vector<byte>& data) {
+    XorFilter xf;
+    size_t offset = sizeof(unsigned int);
+    size_t headerSize = offset + sizeof(xf.seed) + sizeof(xf.blockLength) + sizeof(xf.keyCount);
+
+    if (!isXorFilter(data) || data.size() < headerSize) {
+        throw runtime_error("[XorFilter] Neispravno zaglavlje filtera");
+    }
+
+    memcpy(&xf.seed, data.data() + offset, sizeof(xf.seed));
+    offset += sizeof(xf.seed);
+    memcpy(&xf.blockLength, data.data() + offset, sizeof(xf.blockLength));
+    offset += sizeof(xf.blockLength);
+    memcpy(&xf.keyCount, data.data() + offset, sizeof(xf.keyCount));
+    offset += sizeof(xf.keyCount);
+
+    size_t capacity = 3 * static_cast<size_t>(xf.blockLength);
+    if (data.size() - offset < capacity) {
+        throw runtime_error("[XorFilter] Nepotpuni otisci filtera");
+    }
+
+    xf.fingerprints.resize(capacity);
+    if (capacity > 0) {
+        memcpy(xf.fingerprints.data(), data.data() + offset, capacity);
+    }
+    return xf;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/*
+    * Xor filter (Graf, Lemire) sa 8-bitnim otiscima.
+    *
+    * Staticki filter: pravi se jednom od svih kljuceva i posle se samo proverava (nema add),
+    * sto odgovara SSTabeli koja se posle build-a ne menja.
+    *  - niz od ~1.23 * n bajtova podeljen u tri segmenta, ~9.9 bita po kljucu za ~0.4% laznih pozitivnih
+    *    (Bloom filter za istu stopu trosi ~11.5 bita po kljucu)
+    *  - kljuc x je mozda u skupu ako je fingerprint(x) == B[h0(x)] ^ B[h1(x)] ^ B[h2(x)]
+    *  - provera je uvek jedan hash i tri citanja, bez k hash funkcija
+*/
+class XorFilter {
+public:
+    XorFilter() = default;
+    explicit XorFilter(const std::vector<std::string>& keys);
+
+    // Filter koji nije napravljen (ili nije uspeo da se napravi) za svaki kljuc kaze "mozda"
+    bool possiblyContains(const std::string& elem) const;
+
+    std::vector<std::byte> serialize() const;
+    static XorFilter deserialize(const std::vector<std::byte>& data);
+
+    // Serijalizovan xor filter pocinje markerom na mestu gde BloomFilter ima m
+    static bool isXorFilter(const std::vector<std::byte>& data);
+    static constexpr unsigned int XOR_MARKER = 0xFFFFFFFE;
+
+private:
+    uint64_t seed = 0;
+    uint32_t blockLength = 0;   // duzina jednog od tri segmenta
+    uint32_t keyCount = 0;
+    std::vector<uint8_t> fingerprints;
+
+    static uint64_t keyHash(const std::string& elem);
+    static uint64_t mix(uint64_t h, uint64_t seed);
+    static uint8_t fingerprint(uint64_t h);
+    uint32_t position(uint64_t h, int segment) const;
+};
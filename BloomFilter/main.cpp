@@ -1,10 +1,14 @@
 #include "BloomFilter.h"
+#include "XorFilter.h"
+#include "RangeFilter.h"
 #include <iostream>
 #include <iomanip>
 #include <string>
 #include <vector>
 #include <fstream>
 #include <algorithm>
+#include <chrono>
+#include <sstream>
 
 using namespace std;
 
@@ -116,9 +120,140 @@ void testirajSerijalizaciju() {
         << endl;
 }
 
+void uporediBlokiraniFilter() {
+    cout << "\n===== Klasicni i blokirani filter (100000 kljuceva, p = 0.01) =====\n";
+
+    const unsigned int n = 100000;
+    for (bool blokirani : { false, true }) {
+        BloomFilter bf(n, 0.01, blokirani);
+        for (unsigned int i = 0; i < n; i++) {
+            bf.add("key" + to_string(i));
+        }
+
+        // Serijalizovan i ucitan filter mora da da iste odgovore
+        BloomFilter ucitan = BloomFilter::deserialize(bf.serialize());
+
+        int lazniNegativni = 0;
+        for (unsigned int i = 0; i < n; i++) {
+            if (!ucitan.possiblyContains("key" + to_string(i))) lazniNegativni++;
+        }
+
+        vector<string> odsutni;
+        odsutni.reserve(n);
+        for (unsigned int i = 0; i < n; i++) {
+            odsutni.push_back("missing" + to_string(i));
+        }
+
+        int lazniPozitivni = 0;
+        auto start = chrono::steady_clock::now();
+        for (const auto& kljuc : odsutni) {
+            if (ucitan.possiblyContains(kljuc)) lazniPozitivni++;
+        }
+        auto trajanje = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+
+        cout << setw(10) << (blokirani ? "blokirani" : "klasicni")
+            << " | lazni negativni: " << lazniNegativni
+            << " | lazni pozitivni: " << (100.0 * lazniPozitivni / n) << "%"
+            << " | " << n << " provera: " << trajanje << " us\n";
+    }
+}
+
+// Velicina serijalizovanog filtera po kljucu, stopa laznih pozitivnih i vreme provere odsutnih kljuceva
+template <typename Filter>
+void izmeriFilter(const string& ime, const Filter& filter, size_t n, const vector<string>& prisutni, const vector<string>& odsutni) {
+    int lazniNegativni = 0;
+    for (const auto& kljuc : prisutni) {
+        if (!filter.possiblyContains(kljuc)) lazniNegativni++;
+    }
+
+    int lazniPozitivni = 0;
+    auto start = chrono::steady_clock::now();
+    for (const auto& kljuc : odsutni) {
+        if (filter.possiblyContains(kljuc)) lazniPozitivni++;
+    }
+    auto trajanje = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+
+    ostringstream red;
+    red << fixed << setprecision(2)
+        << setw(22) << ime
+        << " | bita po kljucu: " << setw(5) << (8.0 * filter.serialize().size() / n)
+        << " | lazni pozitivni: " << setw(5) << (100.0 * lazniPozitivni / odsutni.size()) << "%"
+        << " | lazni negativni: " << lazniNegativni
+        << " | provera: " << trajanje << " us";
+    cout << red.str() << "\n";
+}
+
+void uporediXorFilter() {
+    cout << "\n===== Bloom i xor filter: bita po kljucu i lazni pozitivni (100000 kljuceva) =====\n";
+
+    const unsigned int n = 100000;
+    vector<string> prisutni, odsutni;
+    prisutni.reserve(n);
+    odsutni.reserve(n);
+    for (unsigned int i = 0; i < n; i++) {
+        prisutni.push_back("key" + to_string(i));
+        odsutni.push_back("missing" + to_string(i));
+    }
+
+    for (double p : { 0.01, 0.004 }) {
+        for (bool blokirani : { false, true }) {
+            BloomFilter bf(n, p, blokirani);
+            for (const auto& kljuc : prisutni) bf.add(kljuc);
+
+            ostringstream ime;
+            ime << (blokirani ? "blokirani" : "Bloom") << " p=" << p;
+            izmeriFilter(ime.str(), bf, n, prisutni, odsutni);
+        }
+    }
+
+    // Xor filter nema parametar p: 8-bitni otisci daju ~1/256
+    XorFilter xf(prisutni);
+    izmeriFilter("xor (8 bita)", XorFilter::deserialize(xf.serialize()), n, prisutni, odsutni);
+}
+
+void uporediRangeFilter() {
+    cout << "\n===== Range filter: uski opsezi u prazninama izmedju kljuceva (100000 kljuceva) =====\n";
+
+    // Kljucevi sa korakom 10, pa je [10i+1, 10i+9] uvek prazan opseg
+    const int n = 100000;
+    auto kljuc = [](int broj) {
+        ostringstream s;
+        s << "user:" << setw(8) << setfill('0') << broj;
+        return s.str();
+    };
+
+    vector<string> kljucevi;
+    kljucevi.reserve(n);
+    for (int i = 0; i < n; i++) kljucevi.push_back(kljuc(i * 10));
+    RangeFilter rf = RangeFilter::deserialize(RangeFilter(kljucevi).serialize());
+
+    int lazniNegativni = 0;
+    int lazniPozitivni = 0;
+    int tackastiPozitivni = 0;
+    auto start = chrono::steady_clock::now();
+    for (int i = 0; i < n; i++) {
+        if (!rf.mayContainRange(kljuc(i * 10), kljuc(i * 10 + 3))) lazniNegativni++;
+        if (rf.mayContainRange(kljuc(i * 10 + 1), kljuc(i * 10 + 9))) lazniPozitivni++;
+        if (rf.mayContainRange(kljuc(i * 10 + 1), kljuc(i * 10 + 1))) tackastiPozitivni++;
+    }
+    auto trajanje = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+
+    ostringstream red;
+    red << fixed << setprecision(2)
+        << "bita po kljucu: " << (8.0 * rf.serialize().size() / n)
+        << " | lazni pozitivni [10i+1, 10i+9]: " << (100.0 * lazniPozitivni / n) << "%"
+        << " | [10i+1, 10i+1]: " << (100.0 * tackastiPozitivni / n) << "%"
+        << " | lazni negativni: " << lazniNegativni
+        << " | " << 3 * n << " provera: " << trajanje << " us";
+    cout << red.str() << "\n";
+}
+
 int main() {
     cout << "===== Testiranje Bloom filtera =====\n";
     testirajBloomFilter();
     testirajSerijalizaciju();
+    uporediBlokiraniFilter();
+    uporediXorFilter();
+    uporediRangeFilter();
     return 0;
 }
\ No newline at end of file
@@ -33,6 +33,19 @@ bool Config::compress_sstable = true;
 int Config::index_sparsity = 32;
 int Config::summary_sparsity = 64;
 bool Config::sstable_single_file = false; // Default je multi-file
+bool Config::sstable_block_format = false;
+int Config::block_restart_interval = 16;
+std::string Config::block_compression = "none";
+bool Config::block_hash_index = false;
+int Config::max_open_tables = 64;
+bool Config::bloom_filter_blocked = false;
+std::string Config::sstable_filter = "bloom";
+int Config::prefix_filter_length = 0;
+std::string Config::prefix_filter_delimiter = "";
+bool Config::sstable_range_filter = false;
+int Config::value_log_threshold = 0;
+int Config::value_log_file_size = 64 * 1024 * 1024;
+int Config::value_log_gc_percent = 50;
 
 int Config::max_tokens = 20;
 int Config::refill_interval = 10;
@@ -150,6 +163,51 @@ void Config::load_old_configuration() {
         else if (line.find("sstable_single_file") != std::string::npos) {
             sstable_single_file = (bool)getValueFromLine(line);
         }
+        else if (line.find("sstable_block_format") != std::string::npos) {
+            sstable_block_format = (bool)getValueFromLine(line);
+        }
+        else if (line.find("block_restart_interval") != std::string::npos) {
+            block_restart_interval = getValueFromLine(line);
+        }
+        else if (line.find("block_hash_index") != std::string::npos) {
+            block_hash_index = (bool)getValueFromLine(line);
+        }
+        else if (line.find("block_compression") != std::string::npos) {
+            block_compression = line.substr(line.find(':') + 1);
+            block_compression.erase(remove(block_compression.begin(), block_compression.end(), '\"'), block_compression.end());
+            remove_white_space_or_coma(block_compression);
+        }
+        else if (line.find("max_open_tables") != std::string::npos) {
+            max_open_tables = getValueFromLine(line);
+        }
+        else if (line.find("bloom_filter_blocked") != std::string::npos) {
+            bloom_filter_blocked = (bool)getValueFromLine(line);
+        }
+        else if (line.find("sstable_filter") != std::string::npos) {
+            sstable_filter = line.substr(line.find(':') + 1);
+            sstable_filter.erase(remove(sstable_filter.begin(), sstable_filter.end(), '\"'), sstable_filter.end());
+            remove_white_space_or_coma(sstable_filter);
+        }
+        else if (line.find("prefix_filter_length") != std::string::npos) {
+            prefix_filter_length = getValueFromLine(line);
+        }
+        else if (line.find("prefix_filter_delimiter") != std::string::npos) {
+            prefix_filter_delimiter = line.substr(line.find(':') + 1);
+            prefix_filter_delimiter.erase(remove(prefix_filter_delimiter.begin(), prefix_filter_delimiter.end(), '\"'), prefix_filter_delimiter.end());
+            remove_white_space_or_coma(prefix_filter_delimiter);
+        }
+        else if (line.find("sstable_range_filter") != std::string::npos) {
+            sstable_range_filter = (bool)getValueFromLine(line);
+        }
+        else if (line.find("value_log_threshold") != std::string::npos) {
+            value_log_threshold = getValueFromLine(line);
+        }
+        else if (line.find("value_log_file_size") != std::string::npos) {
+            value_log_file_size = getValueFromLine(line);
+        }
+        else if (line.find("value_log_gc_percent") != std::string::npos) {
+            value_log_gc_percent = getValueFromLine(line);
+        }
         else if (line.find("summary_sparsity") != std::string::npos) {
             summary_sparsity = getValueFromLine(line);
         }
@@ -184,6 +242,19 @@ void writeDefaultConfig() {
     out << "  \"summary_sparsity\": " << Config::summary_sparsity << ",\n";
     out << "  \"compress_sstable\": " << (Config::compress_sstable ? 1 : 0) << ",\n";
     out << "  \"sstable_single_file\": " << (Config::sstable_single_file ? 1 : 0) << ",\n";
+    out << "  \"sstable_block_format\": " << (Config::sstable_block_format ? 1 : 0) << ",\n";
+    out << "  \"block_restart_interval\": " << Config::block_restart_interval << ",\n";
+    out << "  \"block_compression\": \"" << Config::block_compression << "\",\n";
+    out << "  \"block_hash_index\": " << (Config::block_hash_index ? 1 : 0) << ",\n";
+    out << "  \"max_open_tables\": " << Config::max_open_tables << ",\n";
+    out << "  \"bloom_filter_blocked\": " << (Config::bloom_filter_blocked ? 1 : 0) << ",\n";
+    out << "  \"sstable_filter\": \"" << Config::sstable_filter << "\",\n";
+    out << "  \"prefix_filter_length\": " << Config::prefix_filter_length << ",\n";
+    out << "  \"prefix_filter_delimiter\": \"" << Config::prefix_filter_delimiter << "\",\n";
+    out << "  \"sstable_range_filter\": " << (Config::sstable_range_filter ? 1 : 0) << ",\n";
+    out << "  \"value_log_threshold\": " << Config::value_log_threshold << ",\n";
+    out << "  \"value_log_file_size\": " << Config::value_log_file_size << ",\n";
+    out << "  \"value_log_gc_percent\": " << Config::value_log_gc_percent << ",\n";
     out << "  \"max_tokens\": " << Config::max_tokens << ",\n";
     out << "  \"refill_interval\": " << Config::refill_interval << "\n";
     out << "}\n";
@@ -318,6 +389,64 @@ bool Config::load_init_configuration() {
             }
             sstable_single_file = new_int;
         }
+        // Podesavanja do value_log_gc_percent ne menjaju nacin na koji se citaju postojece tabele:
+        // tabela, blok ili zapis sam kaze kako je upisan, a novo podesavanje vazi za nove tabele.
+        // Zato promena ne postavlja new_configuration i ne brise podatke.
+        else if (line.find("sstable_block_format") != std::string::npos) {
+            // Format data dela je u TOC-u svake tabele (TOC_FLAG_BLOCK_FORMAT)
+            sstable_block_format = (bool)getValueFromLine(line);
+        }
+        else if (line.find("block_restart_interval") != std::string::npos) {
+            // Svaki blok cuva svoje restart tacke
+            block_restart_interval = getValueFromLine(line);
+        }
+        else if (line.find("block_hash_index") != std::string::npos) {
+            // Svaki blok sam kaze da li ima hes indeks
+            block_hash_index = (bool)getValueFromLine(line);
+        }
+        else if (line.find("block_compression") != std::string::npos) {
+            // Svaki blok u trailer-u nosi svoj kodek
+            block_compression = line.substr(line.find(':') + 1);
+            block_compression.erase(remove(block_compression.begin(), block_compression.end(), '\"'), block_compression.end());
+            remove_white_space_or_coma(block_compression);
+        }
+        else if (line.find("max_open_tables") != std::string::npos) {
+            // Samo velicina kesa otvorenih tabela u memoriji
+            max_open_tables = getValueFromLine(line);
+        }
+        else if (line.find("bloom_filter_blocked") != std::string::npos) {
+            // Filter u fajlu sam kaze koji je format
+            bloom_filter_blocked = (bool)getValueFromLine(line);
+        }
+        else if (line.find("sstable_filter") != std::string::npos) {
+            // Isto kao bloom_filter_blocked, svaka tabela cita filter koji je upisan
+            sstable_filter = line.substr(line.find(':') + 1);
+            sstable_filter.erase(remove(sstable_filter.begin(), sstable_filter.end(), '\"'), sstable_filter.end());
+            remove_white_space_or_coma(sstable_filter);
+        }
+        else if (line.find("prefix_filter_length") != std::string::npos) {
+            // Ekstraktor prefiksa (duzina ili delimiter) je upisan uz filter svake tabele
+            prefix_filter_length = getValueFromLine(line);
+        }
+        else if (line.find("prefix_filter_delimiter") != std::string::npos) {
+            prefix_filter_delimiter = line.substr(line.find(':') + 1);
+            prefix_filter_delimiter.erase(remove(prefix_filter_delimiter.begin(), prefix_filter_delimiter.end(), '\"'), prefix_filter_delimiter.end());
+            remove_white_space_or_coma(prefix_filter_delimiter);
+        }
+        else if (line.find("sstable_range_filter") != std::string::npos) {
+            // Tabela bez range filtera za svaki opseg kaze "mozda"
+            sstable_range_filter = (bool)getValueFromLine(line);
+        }
+        else if (line.find("value_log_threshold") != std::string::npos) {
+            // Svaki zapis sam kaze da li je vrednost u value logu
+            value_log_threshold = getValueFromLine(line);
+        }
+        else if (line.find("value_log_file_size") != std::string::npos) {
+            value_log_file_size = getValueFromLine(line);
+        }
+        else if (line.find("value_log_gc_percent") != std::string::npos) {
+            value_log_gc_percent = getValueFromLine(line);
+        }
         else if (line.find("summary_sparsity") != std::string::npos) {
             new_int = getValueFromLine(line);
             if (summary_sparsity != new_int) {
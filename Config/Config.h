@@ -42,6 +42,19 @@ public:
 	static int summary_sparsity;
 	static bool compress_sstable;
 	static bool sstable_single_file;
+	static bool sstable_block_format;	// blokovi sa prefiksno kompresovanim kljucevima (samo bez kompresije)
+	static int block_restart_interval;	// na koliko zapisa u bloku ide restart tacka
+	static std::string block_compression;	// kodek data blokova u blok formatu: "none" ili "lz"
+	static bool block_hash_index;		// data blokovi imaju hes indeks kljuceva za get (blok format)
+	static int max_open_tables;			// koliko otvorenih SSTabela SSTManager drzi u kesu
+	static bool bloom_filter_blocked;	// novi Bloom filteri su blokirani (jedna kes linija po kljucu)
+	static std::string sstable_filter;	// filter SSTabele: "bloom" ili "xor"
+	static int prefix_filter_length;			// > 0: prefiks filter nad prvih N bajtova kljuca
+	static std::string prefix_filter_delimiter;	// inace: prefiks filter do prvog ovog karaktera ("" iskljuceno)
+	static bool sstable_range_filter;	// nove SSTabele dobijaju range filter (sazet trie) za range scan
+	static int value_log_threshold;		// vrednosti od ovoliko bajtova idu u value log, u tabeli ostaje pokazivac (0 iskljuceno)
+	static int value_log_file_size;		// posle ovoliko bajtova value log prelazi na novi fajl (segment)
+	static int value_log_gc_percent;	// segment sa bar ovoliko % mrtvih bajtova GC prepisuje
 
 	// Token Bucket
 	static int max_tokens;
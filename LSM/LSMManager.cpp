@@ -38,15 +38,23 @@ static bool readAndPushNext(
 // k-way merge svih SSTable-ova na nivou
 // ulazi su pojedinacno sortirani po kljucu
 // cuvamo onaj sa najvecim timestampom
+// Brisanja opsega iz ulaza idu u rangeTombstones, a zapisi koje ona pokrivaju se izbacuju
 
-static std::vector<Record> kWayMerge(const std::vector<SSTable*>& inputs)
+static std::vector<Record> kWayMerge(const std::vector<SSTable*>& inputs, std::vector<RangeTombstone>& rangeTombstones)
 {
     std::vector<Record> out;
     out.reserve(1024); // Pre-alokacija za performanse
 
+    rangeTombstones.clear();
     const int n = static_cast<int>(inputs.size());
     if (n == 0) return out;
 
+    for (SSTable* input : inputs) {
+        const std::vector<RangeTombstone>& own = input->rangeTombstones();
+        rangeTombstones.insert(rangeTombstones.end(), own.begin(), own.end());
+    }
+    coalesceRangeTombstones(rangeTombstones);
+
     std::vector<uint64_t> offsets(n);
     for(int i = 0; i < n; ++i) {
         offsets[i] = inputs[i]->getDataStartOffset();
@@ -82,6 +90,11 @@ static std::vector<Record> kWayMerge(const std::vector<SSTable*>& inputs)
             readAndPushNext(same.srcIdx, inputs[same.srcIdx], offsets, heap);
         }
 
+        // Zapis stariji od brisanja opsega se ne prepisuje; brisanje opsega ide dalje u izlaz
+        if (!rangeTombstones.empty() && winner.timestamp < coveringTimestamp(rangeTombstones, currKey)) {
+            continue;
+        }
+
         // Dodaj pobednika u izlaz (tombstone se čuva da bi se propagiralo brisanje)
         out.push_back(std::move(winner));
     }
@@ -96,28 +109,10 @@ struct KeyRange {
     bool empty = true;
 };
 
-// Izracunaj opseg kljuceva skeniranjem cele tabele
-static KeyRange computeKeyRangeByScan(SSTable& t)
+// Opseg kljuceva tabele iz MANIFEST-a, bez citanja tabele
+static KeyRange keyRangeOf(const TableMeta& meta)
 {
-    uint64_t off = 0;
-    bool eof = false;
-    bool err = false;
-    KeyRange kr{};
-
-    Record first = t.getNextRecord(off, err, eof);
-    if (err) return kr; // Prazna tabela
-
-    kr.min_key = first.key;
-    kr.max_key = first.key;
-    kr.empty = false;
-
-    // Skeniraj do kraja; poslednji zapis ima najveći ključ
-    while (true) {
-        Record r = t.getNextRecord(off, err, eof);
-        if (err) break;
-        kr.max_key = r.key;
-    }
-    return kr;
+    return KeyRange{ meta.min_key, meta.max_key, false };
 }
 
 // Proveri da li se dva opsega kljuceva preklapaju (ukljucujuci granicne vrednosti)
@@ -127,6 +122,19 @@ static inline bool overlapsInclusive(const KeyRange& a, const KeyRange& b)
     return !(a.max_key < b.min_key || b.max_key < a.min_key);
 }
 
+// Izlaz na poslednjem nivou nema starijih verzija ispod sebe, pa brisanje opsega tu vise nista
+// ne sakriva, osim kljuceva u tabelama koje ostaju van kompakcije (untouched) i zato se cuva samo tada
+static void dropBottomRangeTombstones(std::vector<RangeTombstone>& rangeTombstones, const std::vector<KeyRange>& untouched)
+{
+    rangeTombstones.erase(std::remove_if(rangeTombstones.begin(), rangeTombstones.end(),
+        [&](const RangeTombstone& t) {
+            for (const KeyRange& r : untouched) {
+                if (!r.empty && r.min_key < t.end && !(r.max_key < t.begin)) return false;
+            }
+            return true;
+        }), rangeTombstones.end());
+}
+
 
 // Leveled: Limiti po nivou
 static long long fileLimitForLevel(int level, int l0_trigger, int multiplier)
@@ -151,6 +159,7 @@ static bool leveledCompactOneAtLevel(
     if (level >= maxLevels - 1) return false; // Poslednji nivo se ne kompaktuje
 
     auto tables_L = sstManager->getTablesFromLevel(level);
+    auto meta_L = sstManager->getLevelMeta(level);
     long long limit = fileLimitForLevel(level, Config::l0_compaction_trigger, Config::level_size_multiplier);
 
     if ((long long)tables_L.size() < limit) return false; // Nema potrebe za kompakcijom
@@ -158,20 +167,25 @@ static bool leveledCompactOneAtLevel(
 
     // Izaberi jednu tabelu sa nivoa L (ovde uzimamo prvu)
     auto chosen_table = std::move(tables_L.front());
-    KeyRange chosenKR = computeKeyRangeByScan(*chosen_table);
+    KeyRange chosenKR = keyRangeOf(meta_L.front());
 
     // Pronađi sve preklapajuće tabele na nivou L+1
     auto tables_L1 = sstManager->getTablesFromLevel(level + 1);
+    auto meta_L1 = sstManager->getLevelMeta(level + 1);
     std::vector<std::unique_ptr<SSTable>> overlapping_L1;
     std::vector<std::unique_ptr<SSTable>> non_overlapping_L1; // Ove ostaju na L+1
+    std::vector<KeyRange> untouched; // opsezi tabela na L i L+1 koje ne ulaze u kompakciju
+    for (size_t i = 1; i < meta_L.size(); ++i) {
+        untouched.push_back(keyRangeOf(meta_L[i]));
+    }
 
-    for (auto& table : tables_L1) {
-        KeyRange kr = computeKeyRangeByScan(*table);
-        if (overlapsInclusive(chosenKR, kr)) {
-            overlapping_L1.push_back(std::move(table));
+    for (size_t i = 0; i < tables_L1.size(); ++i) {
+        if (overlapsInclusive(chosenKR, keyRangeOf(meta_L1[i]))) {
+            overlapping_L1.push_back(std::move(tables_L1[i]));
         }
         else {
-            non_overlapping_L1.push_back(std::move(table));
+            non_overlapping_L1.push_back(std::move(tables_L1[i]));
+            untouched.push_back(keyRangeOf(meta_L1[i]));
         }
     }
 
@@ -183,11 +197,18 @@ static bool leveledCompactOneAtLevel(
     }
 
     // Spoji sve odabrane tabele
-    std::vector<Record> merged = kWayMerge(merge_group_ptrs);
+    std::vector<RangeTombstone> rangeTombstones;
+    std::vector<Record> merged = kWayMerge(merge_group_ptrs, rangeTombstones);
+    if (level + 1 == maxLevels - 1) {
+        dropBottomRangeTombstones(rangeTombstones, untouched);
+    }
+
+    // Upis izlaza i uklanjanje ulaza idu u MANIFEST kao jedna izmena
+    sstManager->beginEdit();
 
     // Upiši rezultat na nivo L+1
-    if (!merged.empty()) {
-        sstManager->write(merged, level + 1);
+    if (!merged.empty() || !rangeTombstones.empty()) {
+        sstManager->write(merged, level + 1, rangeTombstones);
     }
 
     // Obriši ulazne tabele
@@ -196,6 +217,8 @@ static bool leveledCompactOneAtLevel(
     sstManager->removeSSTables(to_del_L);
     sstManager->removeSSTables(overlapping_L1);
 
+    sstManager->commitEdit();
+
     return true;
 }
 // Kompaktuje ceo nivo L u jednu SSTabelu na nivou L+1 i briše stari nivo L.
@@ -219,16 +242,29 @@ static bool compactFullLevelOnce(
     }
 
     // Spoji sve tabele sa nivoa
-    std::vector<Record> merged = kWayMerge(group_ptrs);
+    std::vector<RangeTombstone> rangeTombstones;
+    std::vector<Record> merged = kWayMerge(group_ptrs, rangeTombstones);
+    if (level + 1 == maxLevels - 1) {
+        // Ceo nivo L ulazi u kompakciju; na L+1 ostaju sve postojece tabele
+        std::vector<KeyRange> untouched;
+        for (const TableMeta& meta : sstManager->getLevelMeta(level + 1)) {
+            untouched.push_back(keyRangeOf(meta));
+        }
+        dropBottomRangeTombstones(rangeTombstones, untouched);
+    }
+
+    sstManager->beginEdit();
 
     // Upiši rezultat na sledeći nivo
-    if (!merged.empty()) {
-        sstManager->write(merged, level + 1);
+    if (!merged.empty() || !rangeTombstones.empty()) {
+        sstManager->write(merged, level + 1, rangeTombstones);
     }
 
     // Obriši sve stare SSTabele sa nivoa L
     sstManager->removeSSTables(tables);
 
+    sstManager->commitEdit();
+
     return true;
 }
 
@@ -282,4 +318,7 @@ void LSMManager::triggerCompactionCheck()
             }
         } while (any_compaction); // Ponavljaj ceo proces ako je bilo koja kompakcija pokrenula kaskadnu
     }
+
+    // Kompakcija ostavlja stare verzije vrednosti u value logu; jedan korak GC-a po proveri
+    sstManager->collectValueLogGarbage();
 }
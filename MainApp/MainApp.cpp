@@ -1,5 +1,6 @@
 ﻿#include "MainApp.h"
 #include <limits>
+#include <stdexcept>
 
 using namespace std;
 
@@ -34,6 +35,7 @@ void MainApp::showMenu() {
     std::cout << "6. RANGE SCAN        - Scan for keys in a range\n";
     std::cout << "7. VALIDATE SSTABLES - Validate data integrity for a level\n";
     std::cout << "8. EXIT              - Exit program\n";
+    std::cout << "9. DELETE RANGE      - Mark all keys in [start, end) as deleted\n";
     std::cout << "======================================\n";
 }
 
@@ -78,6 +80,24 @@ void MainApp::handleDelete() {
     cout << "[DELETE] Marked as deleted: " << key << "\n";
 }
 
+void MainApp::handleDeleteRange() {
+    cout << "Enter start key: ";
+    std::string begin;
+    getline(cin, begin);
+
+    cout << "Enter end key (exclusive): ";
+    std::string end;
+    getline(cin, end);
+
+    // svi system_ kljucevi su u ["system_", "system`"), '`' je prvi znak posle '_'
+    if (begin < "system`" && end > "system_") {
+        cout << "\033[31m[SYSTEM ERROR] Range contains reserved system keys. Operation aborted.\n\033[0m";
+        return;
+    }
+    system->deleteRange(begin, end);
+    cout << "[DELETE RANGE] Marked as deleted: [" << begin << ", " << end << ")\n";
+}
+
 void MainApp::handleGet() {
     cout << "Enter key to get: ";
     getline(cin, key);
@@ -85,13 +105,20 @@ void MainApp::handleGet() {
         cout << "\033[31m[SYSTEM ERROR] Attempt to use reserved system key. Operation aborted.\n\033[0m";
         return;
     }
-    auto value = system->get(key);
+    // Vrednost se ispisuje direktno iz memtable / System bafera, bez kopije
+    string_view value;
     
-    if (value == nullopt) {
-        cout << "[GET] Key " << "\033[31m" << key << "\033[0m" << " doesnt exists\n";
+    try {
+        if (!system->getView(key, value)) {
+            cout << "[GET] Key " << "\033[31m" << key << "\033[0m" << " doesnt exists\n";
+        }
+        else {
+            cout << "[GET] Key " << "\033[31m" << key << "\033[0m" << " Value " << "\033[31m" << value << "\033[0m" << "\n";
+        }
     }
-    else {
-        cout << "[GET] Key " << "\033[31m" << key << "\033[0m" << " Value " << "\033[31m" << value.value() << "\033[0m" << "\n";
+    catch (const runtime_error& e) {
+        // npr. vrednost iz value loga ne moze da se procita; starija verzija se ne vraca umesto nje
+        cerr << "\033[31m[GET ERROR] " << e.what() << "\n\033[0m";
     }
 }
 
@@ -104,7 +131,12 @@ void MainApp::handlePrefixScan() {
     cin >> page_size;
     cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
 
-    system->prefixScan(prefix, page_size);
+    try {
+        system->prefixScan(prefix, page_size);
+    }
+    catch (const runtime_error& e) {
+        cerr << "\033[31m[PREFIX SCAN ERROR] " << e.what() << "\n\033[0m";
+    }
 }
 
 void MainApp::handleRangeScan() {
@@ -121,7 +153,12 @@ void MainApp::handleRangeScan() {
     cin >> page_size;
     cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n');
 
-    system->rangeScan(min_key, max_key, page_size);
+    try {
+        system->rangeScan(min_key, max_key, page_size);
+    }
+    catch (const runtime_error& e) {
+        cerr << "\033[31m[RANGE SCAN ERROR] " << e.what() << "\n\033[0m";
+    }
 }
 
 void MainApp::handleValidate() {
@@ -139,8 +176,21 @@ void MainApp::handleValidate() {
 
     cin.ignore(std::numeric_limits<std::streamsize>::max(), '\n'); // Čisti bafer
 
-    // Pozivamo novu funkciju iz System klase
-    system->validateSSTables(level);
+    // Prazan min key: proverava se ceo nivo
+    cout << "Enter min key (empty for whole level): ";
+    std::string min_key;
+    getline(cin, min_key);
+
+    if (min_key.empty()) {
+        system->validateSSTables(level);
+        return;
+    }
+
+    cout << "Enter max key: ";
+    std::string max_key;
+    getline(cin, max_key);
+
+    system->validateSSTables(level, min_key, max_key);
 }
 
 void MainApp::test_leveled() {
@@ -244,6 +294,7 @@ void MainApp::run() {
         case 8:
             cout << "Exiting...\n";
             return;
+        case 9: handleDeleteRange(); break;
         case 404:
             debugWal();
             debugMemtable();
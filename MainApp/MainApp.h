@@ -25,6 +25,7 @@ public:
 	void showMenu();
 	void handlePut();
 	void handleDelete();
+	void handleDeleteRange();
 	void handleGet();
 	void handlePrefixScan();
 	void handleRangeScan();
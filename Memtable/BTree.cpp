@@ -195,14 +195,23 @@ void BTree<ORDER>::put(const std::string& key, const Entry& entry) {
 template <int ORDER>
 void BTree<ORDER>::remove(const std::string& key)
 {
-    if (remove(root, key))
+    bool removed = remove(root, key);
+
+    // Posle spajanja dece koren moze ostati bez kljuceva, tada njegovo jedino dete postaje koren
+    if (root->numKeys == 0 && !root->isLeaf())
     {
-        --entryCount;
-        // Obrisali smo entry, dodajemo novi sa tombstone 1 da bi obrisali i one u SSTable.
-        // (Kada remove(BTreeNode, string) vrati false, on svakako dodaje novi entry u funkciji.)
-        Entry e = { "", true, currentTime() };
-        put(key, e);
+        BTreeNode* oldRoot = root;
+        root = root->children[0];
+        oldRoot->children[0] = nullptr;
+        delete oldRoot;
     }
+
+    if (removed)
+        --entryCount;
+
+    // Dodajemo novi entry sa tombstone 1 da bi obrisali i one u SSTable.
+    Entry e = { "", true, currentTime() };
+    put(key, e);
 }
 
 template <int ORDER>
@@ -234,17 +243,20 @@ bool BTree<ORDER>::remove(BTreeNode* x, const std::string& key)
             else
             {
                 if (i < x->numKeys)
+                {
                     mergeChild(x, i); // Merge sa desnim
+                    child = x->children[i];
+                }
                 else
+                {
                     mergeChild(x, i - 1); // Merge sa levim
-                child = x->children[i > 0 ? i - 1 : i];
+                    child = x->children[i - 1];
+                }
             }
         }
         return remove(child, key);
     }
 
-    Entry e = { "", true, currentTime() };
-    put(key, e);
     return false;
 }
 
@@ -271,8 +283,10 @@ void BTree<ORDER>::removeInner(BTreeNode* x, const int pos)
 
     else
     {
+        // Kljuc se posle spajanja spusta u levo dete, a na njegovo mesto u x dolazi sledeci kljuc
+        std::string key = x->keys[pos];
         mergeChild(x, pos);
-        remove(x->children[pos], x->keys[pos]);
+        remove(x->children[pos], key);
     }
 }
 
@@ -305,7 +319,7 @@ std::string BTree<ORDER>::findPred(BTreeNode* x, int pos, Entry& e)
 template <int ORDER>
 std::string BTree<ORDER>::findSuccessor(BTreeNode* x, int pos, Entry& e)
 {
-    BTreeNode* y = x->children[x->numKeys];
+    BTreeNode* y = x->children[pos + 1];
     while (!y->isLeaf())
     {
         y = y->children[0];
@@ -350,6 +364,10 @@ void BTree<ORDER>::mergeChild(BTreeNode* parent, int childPos)
 
     leftChild->numKeys += 1 + rightChild->numKeys;
 
+    // Deca desnog cvora sada pripadaju levom
+    for (int i = 0; i < ORDER; ++i)
+        rightChild->children[i] = nullptr;
+
     delete rightChild;
 }
 
@@ -418,18 +436,37 @@ void BTree<ORDER>::redistribute(BTreeNode* parent, int leftChildPos)
 }
 
 template <int ORDER>
-optional<std::string> BTree<ORDER>::get(const std::string& key) const
+optional<std::string> BTree<ORDER>::get(const std::string& key, bool& deleted) const
 {
+    deleted = false;
     int location;
     BTreeNode* n = findNode(root, key, location);
 
     if (n == nullptr) return std::nullopt;
 
-    if (n->entries[location].tombstone == true) return std::nullopt;
+    if (n->entries[location].tombstone == true)
+    {
+        deleted = true;
+        return std::nullopt;
+    }
 
     return n->entries[location].value;
 }
 
+template <int ORDER>
+bool BTree<ORDER>::getView(const std::string& key, std::string_view& value, bool& deleted) const
+{
+    int location;
+    BTreeNode* n = findNode(root, key, location);
+
+    deleted = n != nullptr && n->entries[location].tombstone;
+    if (n == nullptr || deleted)
+        return false;
+
+    value = n->entries[location].value;
+    return true;
+}
+
 template <int ORDER>
 size_t BTree<ORDER>::size() const
 {
@@ -518,4 +555,13 @@ std::vector<MemtableEntry> BTree<ORDER>::getSortedEntries() const
 {
     // inorder() obilazak garantuje da ce zapisi biti sortirani po kljču.
     return getAllMemtableEntries();
-}
\ No newline at end of file
+}
+
+template <int ORDER>
+std::unique_ptr<MemtableIterator> BTree<ORDER>::newIterator() const
+{
+    return std::make_unique<Iterator>(*this);
+}
+
+// Implementacija je u .cpp fajlu, pa eksplicitno instanciramo red koji koristi MemtableFactory
+template class BTree<16>;
@@ -10,6 +10,7 @@
 #include <iostream>
 #include <fstream>
 #include <stdexcept>
+#include <algorithm>
 
 template<int ORDER>
 class BTree : public IMemtable
@@ -32,10 +33,15 @@ class BTree : public IMemtable
 
         ~BTreeNode()
         {
-            for (int i = 0; i < ORDER; i++)
+            // Posle deljenja i spajanja iza poslednjeg deteta mogu ostati zastareli pokazivaci,
+            // pa brisemo samo decu koja zaista pripadaju cvoru
+            if (isLeaf())
+                return;
+
+            for (int i = 0; i <= numKeys; i++)
             {
-                delete children[i]; // Delete each child node if it exists
-                children[i] = nullptr; // Optional: Nullify pointer for safety
+                delete children[i];
+                children[i] = nullptr;
             }
         }
 
@@ -47,7 +53,7 @@ class BTree : public IMemtable
             }
         }
 
-        bool isLeaf()
+        bool isLeaf() const
         {
             return children[0] == nullptr;
         }
@@ -60,6 +66,83 @@ class BTree : public IMemtable
 
     void inorder(BTreeNode* node, std::vector<MemtableEntry>& entries) const;
 
+    // In-order iterator: stek cuva put od korena, a pos u svakom cvoru je sledeci kljuc za obilazak
+    class Iterator : public MemtableIterator
+    {
+        struct Frame {
+            const BTreeNode* node;
+            int pos;
+        };
+
+        const BTree& tree;
+        std::vector<Frame> stack;
+
+        void descendLeftmost(const BTreeNode* node)
+        {
+            while (node)
+            {
+                stack.push_back(Frame{ node, 0 });
+                node = node->isLeaf() ? nullptr : node->children[0];
+            }
+        }
+
+        // Skida cvorove ciji su kljucevi vec obidjeni
+        void settle()
+        {
+            while (!stack.empty() && stack.back().pos >= stack.back().node->numKeys)
+                stack.pop_back();
+        }
+
+        const Entry& current() const
+        {
+            return stack.back().node->entries[stack.back().pos];
+        }
+
+    public:
+        explicit Iterator(const BTree& t) : tree(t) {}
+
+        void seekToFirst() override
+        {
+            stack.clear();
+            descendLeftmost(tree.root);
+            settle();
+        }
+
+        void seek(const std::string& key) override
+        {
+            stack.clear();
+            const BTreeNode* node = tree.root;
+            while (node)
+            {
+                int i = static_cast<int>(std::lower_bound(node->keys, node->keys + node->numKeys, key) - node->keys);
+                stack.push_back(Frame{ node, i });
+                if (i < node->numKeys && node->keys[i] == key)
+                    break;
+                node = node->isLeaf() ? nullptr : node->children[i];
+            }
+            settle();
+        }
+
+        bool valid() const override
+        {
+            return !stack.empty();
+        }
+
+        void next() override
+        {
+            Frame& top = stack.back();
+            top.pos += 1;
+            if (!top.node->isLeaf())
+                descendLeftmost(top.node->children[top.pos]);
+            settle();
+        }
+
+        const std::string& key() const override { return stack.back().node->keys[stack.back().pos]; }
+        const std::string& value() const override { return current().value; }
+        bool tombstone() const override { return current().tombstone; }
+        uint64_t timestamp() const override { return current().timestamp; }
+    };
+
     void splitChild(BTreeNode* parent, BTreeNode* child, int childPos);
 
     void insert(const std::string& key, const Entry& entry);
@@ -100,7 +183,8 @@ public:
     void remove(const std::string& key) override;
     bool remove(BTreeNode* x, const std::string& key);
 
-    optional<std::string> get(const std::string& key) const override;
+    optional<std::string> get(const std::string& key, bool& deleted) const override;
+    bool getView(const std::string& key, std::string_view& value, bool& deleted) const override;
 
     size_t size() const override;
 
@@ -115,4 +199,6 @@ public:
 	void updateEntry(const std::string& key, const MemtableEntry& entry) override;
 
     virtual std::vector<MemtableEntry> getSortedEntries() const override;
+
+    std::unique_ptr<MemtableIterator> newIterator() const override;
 };
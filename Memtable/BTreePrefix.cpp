@@ -0,0 +1,290 @@
+#include "BTreePrefix.h"
+
+#include <utility>
+
+template <int ORDER>
+uint64_t BTreePrefix<ORDER>::keyPrefix(const std::string& key)
+{
+    uint64_t prefix = 0;
+    const size_t n = key.size() < 8 ? key.size() : 8;
+    for (size_t i = 0; i < n; ++i)
+    {
+        prefix |= static_cast<uint64_t>(static_cast<unsigned char>(key[i])) << (56 - 8 * i);
+    }
+    return prefix;
+}
+
+template <int ORDER>
+int BTreePrefix<ORDER>::lowerBound(const BTreeNode* node, uint64_t prefix, const std::string& key)
+{
+    // Brojimo prefikse manje od trazenog, bez grananja (kompajler ovo moze da vektorizuje)
+    int i = 0;
+    for (int j = 0; j < node->numKeys; ++j)
+    {
+        i += node->prefixes[j] < prefix;
+    }
+
+    // Samo kod istog prefiksa poredimo pune kljuceve
+    while (i < node->numKeys && node->prefixes[i] == prefix && node->keys[i] < key)
+    {
+        ++i;
+    }
+    return i;
+}
+
+template <int ORDER>
+typename BTreePrefix<ORDER>::BTreeNode* BTreePrefix<ORDER>::findNode(const std::string& key, int& location) const
+{
+    const uint64_t prefix = keyPrefix(key);
+    BTreeNode* x = root;
+
+    while (x)
+    {
+        int i = lowerBound(x, prefix, key);
+        if (i < x->numKeys && x->prefixes[i] == prefix && x->keys[i] == key)
+        {
+            location = i;
+            return x;
+        }
+        if (x->isLeaf())
+            break;
+        x = x->children[i];
+    }
+
+    location = -1;
+    return nullptr;
+}
+
+template <int ORDER>
+void BTreePrefix<ORDER>::splitChild(BTreeNode* parent, int childPos)
+{
+    //Kopiramo poslednjih t-1 kljuceva i poslednje t dece (2*t = order)
+    const int t = ORDER / 2;
+    BTreeNode* child = parent->children[childPos];
+    BTreeNode* newNode = new BTreeNode();
+    newNode->numKeys = t - 1;
+
+    for (int i = 0; i < t - 1; ++i)
+    {
+        newNode->prefixes[i] = child->prefixes[i + t];
+        newNode->keys[i] = std::move(child->keys[i + t]);
+        newNode->entries[i] = std::move(child->entries[i + t]);
+    }
+
+    if (!child->isLeaf())
+    {
+        for (int i = 0; i < t; ++i)
+        {
+            newNode->children[i] = child->children[i + t];
+            child->children[i + t] = nullptr;
+        }
+    }
+
+    child->numKeys = t - 1;
+
+    //Pravimo mesta za novi node i novi kljuc u roditelju
+    for (int i = parent->numKeys; i >= childPos + 1; --i)
+        parent->children[i + 1] = parent->children[i];
+    parent->children[childPos + 1] = newNode;
+
+    for (int i = parent->numKeys - 1; i >= childPos; --i)
+    {
+        parent->prefixes[i + 1] = parent->prefixes[i];
+        parent->keys[i + 1] = std::move(parent->keys[i]);
+        parent->entries[i + 1] = std::move(parent->entries[i]);
+    }
+
+    parent->prefixes[childPos] = child->prefixes[t - 1];
+    parent->keys[childPos] = std::move(child->keys[t - 1]);
+    parent->entries[childPos] = std::move(child->entries[t - 1]);
+    parent->numKeys += 1;
+}
+
+template <int ORDER>
+void BTreePrefix<ORDER>::insertNotFull(BTreeNode* x, uint64_t prefix, const std::string& key, const Entry& entry)
+{
+    while (!x->isLeaf())
+    {
+        int i = lowerBound(x, prefix, key);
+
+        //Preemptivno delimo puno dete da bismo u njega sigurno mogli da upisemo
+        if (x->children[i]->numKeys == ORDER - 1)
+        {
+            splitChild(x, i);
+            if (x->prefixes[i] < prefix || (x->prefixes[i] == prefix && x->keys[i] < key))
+                ++i;
+        }
+        x = x->children[i];
+    }
+
+    int pos = lowerBound(x, prefix, key);
+    for (int i = x->numKeys - 1; i >= pos; --i)
+    {
+        x->prefixes[i + 1] = x->prefixes[i];
+        x->keys[i + 1] = std::move(x->keys[i]);
+        x->entries[i + 1] = std::move(x->entries[i]);
+    }
+
+    x->prefixes[pos] = prefix;
+    x->keys[pos] = key;
+    x->entries[pos] = entry;
+    x->numKeys += 1;
+}
+
+template <int ORDER>
+void BTreePrefix<ORDER>::upsert(const std::string& key, const Entry& entry)
+{
+    int location;
+    BTreeNode* n = findNode(key, location);
+
+    //Update
+    if (n != nullptr)
+    {
+        n->entries[location] = entry;
+        return;
+    }
+
+    if (entryCount >= maxSize)
+    {
+        std::cerr << "[BTreePrefix] Max size reached, cannot insert new key: " << key << "\n";
+        return;
+    }
+
+    //Root je pun, splitujemo ga
+    if (root->numKeys == ORDER - 1)
+    {
+        BTreeNode* z = new BTreeNode();
+        z->children[0] = root;
+        root = z;
+        splitChild(z, 0);
+    }
+
+    insertNotFull(root, keyPrefix(key), key, entry);
+    ++entryCount;
+}
+
+template <int ORDER>
+void BTreePrefix<ORDER>::put(const std::string& key, const std::string& value)
+{
+    upsert(key, Entry{ value, false, currentTime() });
+}
+
+template <int ORDER>
+void BTreePrefix<ORDER>::remove(const std::string& key)
+{
+    // Zapis ostaje u stablu kao tombstone, da bi brisanje stiglo i do SSTabela
+    upsert(key, Entry{ "", true, currentTime() });
+}
+
+template <int ORDER>
+std::optional<std::string> BTreePrefix<ORDER>::get(const std::string& key, bool& deleted) const
+{
+    deleted = false;
+    int location;
+    BTreeNode* n = findNode(key, location);
+
+    if (n == nullptr) return std::nullopt;
+
+    if (n->entries[location].tombstone)
+    {
+        deleted = true;
+        return std::nullopt;
+    }
+
+    return n->entries[location].value;
+}
+
+template <int ORDER>
+bool BTreePrefix<ORDER>::getView(const std::string& key, std::string_view& value, bool& deleted) const
+{
+    int location;
+    BTreeNode* n = findNode(key, location);
+
+    deleted = n != nullptr && n->entries[location].tombstone;
+    if (n == nullptr || deleted)
+        return false;
+
+    value = n->entries[location].value;
+    return true;
+}
+
+template <int ORDER>
+size_t BTreePrefix<ORDER>::size() const
+{
+    return entryCount;
+}
+
+template <int ORDER>
+void BTreePrefix<ORDER>::setMaxSize(size_t newMaxSize)
+{
+    maxSize = newMaxSize;
+}
+
+template <int ORDER>
+void BTreePrefix<ORDER>::inorder(const BTreeNode* node, std::vector<MemtableEntry>& entries) const
+{
+    if (!node) return;
+
+    for (int i = 0; i < node->numKeys; ++i)
+    {
+        if (!node->isLeaf())
+            inorder(node->children[i], entries);
+
+        const Entry& e = node->entries[i];
+        entries.push_back(MemtableEntry{ node->keys[i], e.value, e.tombstone, e.timestamp });
+    }
+
+    // Najdesniji cvor
+    if (!node->isLeaf())
+        inorder(node->children[node->numKeys], entries);
+}
+
+template <int ORDER>
+std::vector<MemtableEntry> BTreePrefix<ORDER>::getAllMemtableEntries() const
+{
+    std::vector<MemtableEntry> result;
+    result.reserve(entryCount);
+    inorder(root, result);
+    return result;
+}
+
+template <int ORDER>
+std::optional<MemtableEntry> BTreePrefix<ORDER>::getEntry(const std::string& key) const
+{
+    int location;
+    BTreeNode* n = findNode(key, location);
+    if (n == nullptr) return std::nullopt;
+
+    const Entry& e = n->entries[location];
+    return MemtableEntry{ key, e.value, e.tombstone, e.timestamp };
+}
+
+template <int ORDER>
+void BTreePrefix<ORDER>::updateEntry(const std::string& key, const MemtableEntry& entry)
+{
+    int location;
+    BTreeNode* n = findNode(key, location);
+
+    if (n == nullptr) {
+        std::cerr << "[BTreePrefix] Key '" << key << "' not found for update.\n";
+        return;
+    }
+
+    n->entries[location] = Entry{ entry.value, entry.tombstone, entry.timestamp };
+}
+
+template <int ORDER>
+std::vector<MemtableEntry> BTreePrefix<ORDER>::getSortedEntries() const
+{
+    // inorder() obilazak garantuje da ce zapisi biti sortirani po kljucu
+    return getAllMemtableEntries();
+}
+
+template <int ORDER>
+std::unique_ptr<MemtableIterator> BTreePrefix<ORDER>::newIterator() const
+{
+    return std::make_unique<Iterator>(*this);
+}
+
+// Implementacija je u .cpp fajlu, pa eksplicitno instanciramo red koji koristi MemtableFactory
+template class BTreePrefix<16>;
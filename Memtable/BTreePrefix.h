@@ -0,0 +1,202 @@
+#pragma once
+
+#include <string>
+#include <optional>
+#include "IMemtable.h"
+#include <vector>
+#include <cstdint>
+#include <chrono>
+#include <iostream>
+
+/**
+ * B-stablo memtable sa kes-prijateljskim rasporedom cvora.
+ *
+ * Pored punih kljuceva, svaki cvor cuva niz `prefixes` - prvih 8 bajtova svakog kljuca
+ * kao big-endian broj (kraci kljucevi se dopunjuju nulama). Pretraga unutar cvora
+ * broji prefikse manje od trazenog bez grananja, a pun kljuc (std::string na heap-u)
+ * se cita samo kada su prefiksi jednaki. Za kljuceve sa kratkim zajednickim delom
+ * to znaci jedno poredjenje stringova po cvoru umesto log(ORDER).
+ *
+ * Brisanje upisuje tombstone (kao i ostale memtable), pa stablo nikad ne spaja cvorove.
+ */
+template<int ORDER>
+class BTreePrefix : public IMemtable
+{
+    static_assert(ORDER >= 4 && ORDER % 2 == 0, "ORDER mora biti paran i bar 4");
+
+    struct Entry {
+        std::string value;
+        bool tombstone;
+        uint64_t timestamp;
+    };
+
+    struct BTreeNode
+    {
+        uint64_t prefixes[ORDER - 1];
+        std::string keys[ORDER - 1];
+        Entry entries[ORDER - 1];
+
+        BTreeNode* children[ORDER];
+
+        int numKeys;
+
+        BTreeNode() : numKeys(0)
+        {
+            for (int i = 0; i < ORDER; i++)
+            {
+                children[i] = nullptr;
+            }
+        }
+
+        ~BTreeNode()
+        {
+            for (int i = 0; i < ORDER; i++)
+            {
+                delete children[i];
+            }
+        }
+
+        bool isLeaf() const
+        {
+            return children[0] == nullptr;
+        }
+    };
+
+    BTreeNode* root;
+    size_t entryCount;
+    size_t maxSize;
+
+    // Prvih 8 bajtova kljuca kao big-endian broj, tako da poredjenje brojeva prati leksikografski poredak
+    static uint64_t keyPrefix(const std::string& key);
+
+    // Prvi indeks i u cvoru za koji vazi keys[i] >= key
+    static int lowerBound(const BTreeNode* node, uint64_t prefix, const std::string& key);
+
+    //location je in-out
+    BTreeNode* findNode(const std::string& key, int& location) const;
+
+    void splitChild(BTreeNode* parent, int childPos);
+    void insertNotFull(BTreeNode* x, uint64_t prefix, const std::string& key, const Entry& entry);
+
+    // Upisuje novi ili menja postojeci zapis
+    void upsert(const std::string& key, const Entry& entry);
+
+    void inorder(const BTreeNode* node, std::vector<MemtableEntry>& entries) const;
+
+    // In-order iterator: stek cuva put od korena, a pos u svakom cvoru je sledeci kljuc za obilazak
+    class Iterator : public MemtableIterator
+    {
+        struct Frame {
+            const BTreeNode* node;
+            int pos;
+        };
+
+        const BTreePrefix& tree;
+        std::vector<Frame> stack;
+
+        void descendLeftmost(const BTreeNode* node)
+        {
+            while (node)
+            {
+                stack.push_back(Frame{ node, 0 });
+                node = node->isLeaf() ? nullptr : node->children[0];
+            }
+        }
+
+        // Skida cvorove ciji su kljucevi vec obidjeni
+        void settle()
+        {
+            while (!stack.empty() && stack.back().pos >= stack.back().node->numKeys)
+                stack.pop_back();
+        }
+
+        const Entry& current() const
+        {
+            return stack.back().node->entries[stack.back().pos];
+        }
+
+    public:
+        explicit Iterator(const BTreePrefix& t) : tree(t) {}
+
+        void seekToFirst() override
+        {
+            stack.clear();
+            descendLeftmost(tree.root);
+            settle();
+        }
+
+        void seek(const std::string& key) override
+        {
+            stack.clear();
+            const uint64_t prefix = keyPrefix(key);
+            const BTreeNode* node = tree.root;
+            while (node)
+            {
+                int i = lowerBound(node, prefix, key);
+                stack.push_back(Frame{ node, i });
+                if (i < node->numKeys && node->keys[i] == key)
+                    break;
+                node = node->isLeaf() ? nullptr : node->children[i];
+            }
+            settle();
+        }
+
+        bool valid() const override
+        {
+            return !stack.empty();
+        }
+
+        void next() override
+        {
+            Frame& top = stack.back();
+            top.pos += 1;
+            if (!top.node->isLeaf())
+                descendLeftmost(top.node->children[top.pos]);
+            settle();
+        }
+
+        const std::string& key() const override { return stack.back().node->keys[stack.back().pos]; }
+        const std::string& value() const override { return current().value; }
+        bool tombstone() const override { return current().tombstone; }
+        uint64_t timestamp() const override { return current().timestamp; }
+    };
+
+    static uint64_t currentTime() {
+        return static_cast<uint64_t>(
+            std::chrono::system_clock::now().time_since_epoch().count()
+            );
+    }
+
+public:
+    BTreePrefix(size_t maxSize_) : root(new BTreeNode()), entryCount(0), maxSize(maxSize_) {}
+
+    ~BTreePrefix() override
+    {
+        delete root;
+    }
+
+    BTreePrefix(const BTreePrefix&) = delete;
+    BTreePrefix& operator=(const BTreePrefix&) = delete;
+
+    void put(const std::string& key, const std::string& value) override;
+
+    void remove(const std::string& key) override;
+
+    std::optional<std::string> get(const std::string& key, bool& deleted) const override;
+
+    bool getView(const std::string& key, std::string_view& value, bool& deleted) const override;
+
+    size_t size() const override;
+
+    void setMaxSize(size_t maxSize) override;
+
+    std::vector<MemtableEntry> getAllMemtableEntries() const override;
+
+    std::optional<MemtableEntry> getEntry(const std::string& key) const override;
+
+    void updateEntry(const std::string& key, const MemtableEntry& entry) override;
+
+    std::vector<MemtableEntry> getSortedEntries() const override;
+
+    std::unique_ptr<MemtableIterator> newIterator() const override;
+};
@@ -4,6 +4,8 @@
 #include <optional>
 #include "../Wal/wal.h"
 #include <vector>
+#include <memory>
+#include <string_view>
 
 using namespace std;
 
@@ -24,6 +26,28 @@ struct MemtableEntry {
 	}
 };
 
+/**
+ * Iterator nad zapisima jedne memtable, u rastucem redosledu kljuceva.
+ * Zapisi se ne kopiraju - key()/value() vracaju reference koje vaze dok se memtable ne menja,
+ * pa kursor cita samo one zapise koje zaista vraca.
+ */
+class MemtableIterator {
+public:
+	virtual ~MemtableIterator() = default;
+
+	virtual void seekToFirst() = 0;
+	// Pozicionira iterator na prvi kljuc >= key
+	virtual void seek(const string& key) = 0;
+
+	virtual bool valid() const = 0;
+	virtual void next() = 0;
+
+	virtual const string& key() const = 0;
+	virtual const string& value() const = 0;
+	virtual bool tombstone() const = 0;
+	virtual uint64_t timestamp() const = 0;
+};
+
 class IMemtable {
 
 public:
@@ -34,6 +58,10 @@ public:
 	virtual void remove(const string& key) = 0;
 	virtual optional<string> get(const string& key, bool& deleted) const = 0;
 
+	// Kao get, ali bez kopiranja: value pokazuje na vrednost unutar memtable i vazi samo
+	// do sledece izmene ove memtable. Vraca true ako kljuc postoji i nije obrisan.
+	virtual bool getView(const string& key, std::string_view& value, bool& deleted) const = 0;
+
 	virtual size_t size() const = 0;
 	virtual void setMaxSize(size_t maxSize) = 0;
 	
@@ -51,4 +79,7 @@ public:
 
 	// Vraca sve MemtableEntry zapise sortirane po kljucu
 	virtual std::vector<MemtableEntry> getSortedEntries() const = 0;
+
+	// Novi iterator, inicijalno nije pozicioniran (pozvati seek ili seekToFirst)
+	virtual std::unique_ptr<MemtableIterator> newIterator() const = 0;
 };
\ No newline at end of file
@@ -0,0 +1,570 @@
+#include "MemtableART.h"
+#include <cstring>
+#include <utility>
+
+MemtableART::MemtableART()
+    : root_(nullptr), entryCount_(0), maxSize_(Config::memtable_max_size)
+{}
+
+MemtableART::~MemtableART() {
+    freeNode(root_);
+}
+
+void MemtableART::freeNode(Node* node) {
+    if (!node) return;
+
+    switch (node->type) {
+    case LEAF:
+        delete static_cast<Leaf*>(node);
+        return;
+    case NODE4: {
+        Node4* n = static_cast<Node4*>(node);
+        for (int i = 0; i < n->numChildren; ++i) freeNode(n->children[i]);
+        delete n->terminal;
+        delete n;
+        return;
+    }
+    case NODE16: {
+        Node16* n = static_cast<Node16*>(node);
+        for (int i = 0; i < n->numChildren; ++i) freeNode(n->children[i]);
+        delete n->terminal;
+        delete n;
+        return;
+    }
+    case NODE48: {
+        Node48* n = static_cast<Node48*>(node);
+        for (int i = 0; i < n->numChildren; ++i) freeNode(n->children[i]);
+        delete n->terminal;
+        delete n;
+        return;
+    }
+    case NODE256: {
+        Node256* n = static_cast<Node256*>(node);
+        for (int i = 0; i < 256; ++i) freeNode(n->children[i]);
+        delete n->terminal;
+        delete n;
+        return;
+    }
+    }
+}
+
+MemtableART::Node** MemtableART::findChild(Inner* node, uint8_t byte) {
+    switch (node->type) {
+    case NODE4: {
+        Node4* n = static_cast<Node4*>(node);
+        for (int i = 0; i < n->numChildren; ++i)
+            if (n->keys[i] == byte) return &n->children[i];
+        return nullptr;
+    }
+    case NODE16: {
+        Node16* n = static_cast<Node16*>(node);
+        for (int i = 0; i < n->numChildren; ++i)
+            if (n->keys[i] == byte) return &n->children[i];
+        return nullptr;
+    }
+    case NODE48: {
+        Node48* n = static_cast<Node48*>(node);
+        uint8_t idx = n->childIndex[byte];
+        return idx ? &n->children[idx - 1] : nullptr;
+    }
+    case NODE256: {
+        Node256* n = static_cast<Node256*>(node);
+        return n->children[byte] ? &n->children[byte] : nullptr;
+    }
+    default:
+        return nullptr;
+    }
+}
+
+void MemtableART::copyHeader(Inner* dst, const Inner* src) {
+    dst->numChildren = src->numChildren;
+    dst->prefix = src->prefix;
+    dst->terminal = src->terminal;
+}
+
+void MemtableART::addChild(Node*& nodeRef, uint8_t byte, Node* child) {
+    switch (nodeRef->type) {
+    case NODE4: {
+        Node4* n = static_cast<Node4*>(nodeRef);
+        if (n->numChildren < 4) {
+            // Deca ostaju sortirana po bajtu, zbog redosleda pri obilasku
+            int pos = 0;
+            while (pos < n->numChildren && n->keys[pos] < byte) ++pos;
+            for (int i = n->numChildren; i > pos; --i) {
+                n->keys[i] = n->keys[i - 1];
+                n->children[i] = n->children[i - 1];
+            }
+            n->keys[pos] = byte;
+            n->children[pos] = child;
+            n->numChildren++;
+            return;
+        }
+
+        Node16* grown = new Node16();
+        copyHeader(grown, n);
+        std::memcpy(grown->keys, n->keys, sizeof(n->keys));
+        std::memcpy(grown->children, n->children, sizeof(n->children));
+        delete n;
+        nodeRef = grown;
+        addChild(nodeRef, byte, child);
+        return;
+    }
+    case NODE16: {
+        Node16* n = static_cast<Node16*>(nodeRef);
+        if (n->numChildren < 16) {
+            int pos = 0;
+            while (pos < n->numChildren && n->keys[pos] < byte) ++pos;
+            for (int i = n->numChildren; i > pos; --i) {
+                n->keys[i] = n->keys[i - 1];
+                n->children[i] = n->children[i - 1];
+            }
+            n->keys[pos] = byte;
+            n->children[pos] = child;
+            n->numChildren++;
+            return;
+        }
+
+        Node48* grown = new Node48();
+        copyHeader(grown, n);
+        for (int i = 0; i < 16; ++i) {
+            grown->children[i] = n->children[i];
+            grown->childIndex[n->keys[i]] = static_cast<uint8_t>(i + 1);
+        }
+        delete n;
+        nodeRef = grown;
+        addChild(nodeRef, byte, child);
+        return;
+    }
+    case NODE48: {
+        Node48* n = static_cast<Node48*>(nodeRef);
+        if (n->numChildren < 48) {
+            // Deca se nikad ne brisu, pa je prvi slobodan slot uvek numChildren
+            n->children[n->numChildren] = child;
+            n->childIndex[byte] = static_cast<uint8_t>(n->numChildren + 1);
+            n->numChildren++;
+            return;
+        }
+
+        Node256* grown = new Node256();
+        copyHeader(grown, n);
+        for (int b = 0; b < 256; ++b) {
+            if (n->childIndex[b]) grown->children[b] = n->children[n->childIndex[b] - 1];
+        }
+        delete n;
+        nodeRef = grown;
+        addChild(nodeRef, byte, child);
+        return;
+    }
+    case NODE256: {
+        Node256* n = static_cast<Node256*>(nodeRef);
+        n->children[byte] = child;
+        n->numChildren++;
+        return;
+    }
+    default:
+        return;
+    }
+}
+
+MemtableART::Leaf* MemtableART::findLeaf(const std::string& key) const {
+    Node* node = root_;
+    size_t depth = 0;
+
+    while (node) {
+        if (node->type == LEAF) {
+            Leaf* leaf = static_cast<Leaf*>(node);
+            // Bajtove pre depth smo vec uporedili na putu do lista
+            if (leaf->key.size() == key.size() &&
+                std::memcmp(leaf->key.data() + depth, key.data() + depth, key.size() - depth) == 0) {
+                return leaf;
+            }
+            return nullptr;
+        }
+
+        Inner* in = static_cast<Inner*>(node);
+        const size_t plen = in->prefix.size();
+        if (key.size() - depth < plen || std::memcmp(key.data() + depth, in->prefix.data(), plen) != 0) {
+            return nullptr;
+        }
+        depth += plen;
+
+        if (depth == key.size()) return in->terminal;
+
+        Node** child = findChild(in, static_cast<uint8_t>(key[depth]));
+        if (!child) return nullptr;
+        node = *child;
+        ++depth;
+    }
+    return nullptr;
+}
+
+bool MemtableART::upsert(const std::string& key, const std::string& value, bool tombstone, uint64_t timestamp) {
+    // Update
+    if (Leaf* existing = findLeaf(key)) {
+        existing->value = value;
+        existing->tombstone = tombstone;
+        existing->timestamp = timestamp;
+        return true;
+    }
+
+    if (entryCount_ >= maxSize_) {
+        return false;
+    }
+
+    Leaf* leaf = new Leaf(key, value, tombstone, timestamp);
+    ++entryCount_;
+
+    Node** ref = &root_;
+    size_t depth = 0;
+
+    while (true) {
+        Node* node = *ref;
+
+        if (!node) {
+            *ref = leaf;
+            return true;
+        }
+
+        if (node->type == LEAF) {
+            // Dva razlicita kljuca se sreli u istom listu: pravimo Node4 sa njihovim zajednickim delom
+            Leaf* old = static_cast<Leaf*>(node);
+            size_t lcp = 0;
+            while (depth + lcp < key.size() && depth + lcp < old->key.size() &&
+                key[depth + lcp] == old->key[depth + lcp]) {
+                ++lcp;
+            }
+
+            Node4* n = new Node4();
+            n->prefix = key.substr(depth, lcp);
+            const size_t split = depth + lcp;
+
+            Node* newNode = n;
+            for (Leaf* l : { old, leaf }) {
+                if (l->key.size() == split) n->terminal = l;
+                else addChild(newNode, static_cast<uint8_t>(l->key[split]), l);
+            }
+            *ref = newNode;
+            return true;
+        }
+
+        Inner* in = static_cast<Inner*>(node);
+        size_t p = 0;
+        while (p < in->prefix.size() && depth + p < key.size() && in->prefix[p] == key[depth + p]) {
+            ++p;
+        }
+
+        if (p < in->prefix.size()) {
+            // Kljuc se razilazi usred sazete putanje: delimo prefiks na novi Node4 iznad postojeceg cvora
+            Node4* n = new Node4();
+            n->prefix = in->prefix.substr(0, p);
+            n->keys[0] = static_cast<uint8_t>(in->prefix[p]);
+            n->children[0] = in;
+            n->numChildren = 1;
+            in->prefix.erase(0, p + 1);
+
+            Node* newNode = n;
+            if (depth + p == key.size()) n->terminal = leaf;
+            else addChild(newNode, static_cast<uint8_t>(key[depth + p]), leaf);
+            *ref = newNode;
+            return true;
+        }
+
+        depth += in->prefix.size();
+
+        if (depth == key.size()) {
+            in->terminal = leaf;
+            return true;
+        }
+
+        Node** child = findChild(in, static_cast<uint8_t>(key[depth]));
+        if (!child) {
+            addChild(*ref, static_cast<uint8_t>(key[depth]), leaf);
+            return true;
+        }
+
+        ref = child;
+        ++depth;
+    }
+}
+
+void MemtableART::put(const std::string& key, const std::string& value) {
+    if (!upsert(key, value, false, currentTime())) {
+        std::cerr << "[MemtableART] Dostignut maxSize, ne moze se ubaciti novi kljuc: " << key << "\n";
+    }
+}
+
+void MemtableART::remove(const std::string& key) {
+    // Zapis ostaje u stablu kao tombstone, da bi brisanje stiglo i do SSTabela
+    if (!upsert(key, "", true, currentTime())) {
+        std::cerr << "[MemtableART] Dostignut maxSize, ne moze se ubaciti tombstone za kljuc: " << key << "\n";
+    }
+}
+
+std::optional<std::string> MemtableART::get(const std::string& key, bool& deleted) const {
+    deleted = false;
+    Leaf* leaf = findLeaf(key);
+    if (!leaf) return std::nullopt;
+
+    if (leaf->tombstone) {
+        deleted = true;
+        return std::nullopt;
+    }
+    return leaf->value;
+}
+
+bool MemtableART::getView(const std::string& key, std::string_view& value, bool& deleted) const {
+    Leaf* leaf = findLeaf(key);
+    deleted = leaf && leaf->tombstone;
+    if (!leaf || leaf->tombstone) return false;
+
+    value = leaf->value;
+    return true;
+}
+
+size_t MemtableART::size() const {
+    return entryCount_;
+}
+
+void MemtableART::setMaxSize(size_t maxSize) {
+    maxSize_ = maxSize;
+}
+
+void MemtableART::collect(const Node* node, std::vector<MemtableEntry>& out) const {
+    if (!node) return;
+
+    if (node->type == LEAF) {
+        const Leaf* l = static_cast<const Leaf*>(node);
+        out.push_back(MemtableEntry{ l->key, l->value, l->tombstone, l->timestamp });
+        return;
+    }
+
+    // Kljuc koji se zavrsava u ovom cvoru je prefiks svih ostalih ispod njega, pa ide prvi
+    const Inner* in = static_cast<const Inner*>(node);
+    if (in->terminal) collect(in->terminal, out);
+
+    switch (node->type) {
+    case NODE4: {
+        const Node4* n = static_cast<const Node4*>(node);
+        for (int i = 0; i < n->numChildren; ++i) collect(n->children[i], out);
+        break;
+    }
+    case NODE16: {
+        const Node16* n = static_cast<const Node16*>(node);
+        for (int i = 0; i < n->numChildren; ++i) collect(n->children[i], out);
+        break;
+    }
+    case NODE48: {
+        const Node48* n = static_cast<const Node48*>(node);
+        for (int b = 0; b < 256; ++b)
+            if (n->childIndex[b]) collect(n->children[n->childIndex[b] - 1], out);
+        break;
+    }
+    case NODE256: {
+        const Node256* n = static_cast<const Node256*>(node);
+        for (int b = 0; b < 256; ++b) collect(n->children[b], out);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+std::vector<MemtableEntry> MemtableART::getAllMemtableEntries() const {
+    std::vector<MemtableEntry> entries;
+    entries.reserve(entryCount_);
+    collect(root_, entries);
+    return entries;
+}
+
+std::optional<MemtableEntry> MemtableART::getEntry(const std::string& key) const {
+    Leaf* leaf = findLeaf(key);
+    if (!leaf) return std::nullopt;
+    return MemtableEntry{ leaf->key, leaf->value, leaf->tombstone, leaf->timestamp };
+}
+
+void MemtableART::updateEntry(const std::string& key, const MemtableEntry& entry) {
+    Leaf* leaf = findLeaf(key);
+    if (!leaf) {
+        std::cerr << "[MemtableART] Key '" << key << "' not found for update.\n";
+        return;
+    }
+    leaf->value = entry.value;
+    leaf->tombstone = entry.tombstone;
+    leaf->timestamp = entry.timestamp;
+}
+
+const MemtableART::Node* MemtableART::nextChild(const Inner* node, int& pos) {
+    switch (node->type) {
+    case NODE4: {
+        const Node4* n = static_cast<const Node4*>(node);
+        return pos < n->numChildren ? n->children[pos++] : nullptr;
+    }
+    case NODE16: {
+        const Node16* n = static_cast<const Node16*>(node);
+        return pos < n->numChildren ? n->children[pos++] : nullptr;
+    }
+    case NODE48: {
+        // Za Node48 i Node256 pozicija je sam bajt
+        const Node48* n = static_cast<const Node48*>(node);
+        while (pos < 256 && !n->childIndex[pos]) ++pos;
+        return pos < 256 ? n->children[n->childIndex[pos++] - 1] : nullptr;
+    }
+    case NODE256: {
+        const Node256* n = static_cast<const Node256*>(node);
+        while (pos < 256 && !n->children[pos]) ++pos;
+        return pos < 256 ? n->children[pos++] : nullptr;
+    }
+    default:
+        return nullptr;
+    }
+}
+
+int MemtableART::childLowerBound(const Inner* node, uint8_t byte, bool& exact) {
+    switch (node->type) {
+    case NODE4: {
+        const Node4* n = static_cast<const Node4*>(node);
+        int pos = 0;
+        while (pos < n->numChildren && n->keys[pos] < byte) ++pos;
+        exact = pos < n->numChildren && n->keys[pos] == byte;
+        return pos;
+    }
+    case NODE16: {
+        const Node16* n = static_cast<const Node16*>(node);
+        int pos = 0;
+        while (pos < n->numChildren && n->keys[pos] < byte) ++pos;
+        exact = pos < n->numChildren && n->keys[pos] == byte;
+        return pos;
+    }
+    case NODE48:
+        exact = static_cast<const Node48*>(node)->childIndex[byte] != 0;
+        return byte;
+    case NODE256:
+        exact = static_cast<const Node256*>(node)->children[byte] != nullptr;
+        return byte;
+    default:
+        exact = false;
+        return 0;
+    }
+}
+
+/**
+ * Iterator cuva stek unutrasnjih cvorova od korena do trenutnog lista,
+ * sa pozicijom sledeceg deteta za obilazak u svakom od njih.
+ */
+class MemtableART::Iterator : public MemtableIterator {
+public:
+    explicit Iterator(const MemtableART& tree) : tree_(tree), leaf_(nullptr) {}
+
+    void seekToFirst() override {
+        stack_.clear();
+        leaf_ = nullptr;
+        descendLeftmost(tree_.root_);
+    }
+
+    void seek(const std::string& key) override {
+        stack_.clear();
+        leaf_ = nullptr;
+
+        const Node* node = tree_.root_;
+        size_t depth = 0;
+
+        while (node) {
+            if (node->type == LEAF) {
+                const Leaf* l = static_cast<const Leaf*>(node);
+                if (l->key >= key) leaf_ = l;
+                else advance();
+                return;
+            }
+
+            const Inner* in = static_cast<const Inner*>(node);
+            const size_t plen = in->prefix.size();
+            int cmp = key.compare(depth, plen, in->prefix);
+
+            if (cmp < 0) {
+                // Celo podstablo je vece od kljuca
+                descendLeftmost(node);
+                return;
+            }
+            if (cmp > 0 || key.size() - depth < plen) {
+                // Celo podstablo je manje od kljuca
+                advance();
+                return;
+            }
+
+            depth += plen;
+            if (depth == key.size()) {
+                // terminal je bas key, a sva deca su veca
+                descendLeftmost(node);
+                return;
+            }
+
+            // terminal je kraci od kljuca, pa ga preskacemo
+            bool exact;
+            int pos = childLowerBound(in, static_cast<uint8_t>(key[depth]), exact);
+            stack_.push_back(Frame{ in, pos });
+            if (!exact) {
+                advance();
+                return;
+            }
+
+            node = nextChild(in, stack_.back().pos);
+            ++depth;
+        }
+
+        advance();
+    }
+
+    bool valid() const override { return leaf_ != nullptr; }
+    void next() override { advance(); }
+
+    const std::string& key() const override { return leaf_->key; }
+    const std::string& value() const override { return leaf_->value; }
+    bool tombstone() const override { return leaf_->tombstone; }
+    uint64_t timestamp() const override { return leaf_->timestamp; }
+
+private:
+    struct Frame {
+        const Inner* node;
+        int pos;
+    };
+
+    const MemtableART& tree_;
+    std::vector<Frame> stack_;
+    const Leaf* leaf_;
+
+    // Ide do najmanjeg kljuca u podstablu; terminal cvora je manji od svih njegovih dece
+    void descendLeftmost(const Node* node) {
+        while (node && node->type != LEAF) {
+            const Inner* in = static_cast<const Inner*>(node);
+            stack_.push_back(Frame{ in, 0 });
+            if (in->terminal) {
+                leaf_ = in->terminal;
+                return;
+            }
+            node = nextChild(in, stack_.back().pos);
+        }
+        leaf_ = static_cast<const Leaf*>(node);
+    }
+
+    void advance() {
+        leaf_ = nullptr;
+        while (!stack_.empty()) {
+            const Node* child = nextChild(stack_.back().node, stack_.back().pos);
+            if (!child) {
+                stack_.pop_back();
+                continue;
+            }
+            descendLeftmost(child);
+            return;
+        }
+    }
+};
+
+std::unique_ptr<MemtableIterator> MemtableART::newIterator() const {
+    return std::make_unique<Iterator>(*this);
+}
+
+std::vector<MemtableEntry> MemtableART::getSortedEntries() const {
+    // Obilazak po rastucem bajtu vec daje zapise sortirane po kljucu
+    return getAllMemtableEntries();
+}
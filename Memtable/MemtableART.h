@@ -0,0 +1,127 @@
+#pragma once
+
+#include "IMemtable.h"
+#include <string>
+#include <optional>
+#include <vector>
+#include <cstdint>
+#include <chrono>
+#include <iostream>
+
+/**
+ * Memtable nad Adaptive Radix Tree (ART) strukturom.
+ *
+ * Kljuc se obilazi bajt po bajt, pa se zajednicki deo kljuceva (npr. "user:region:")
+ * ne poredi iznova na svakom nivou kao kod skip liste i B-stabla.
+ *  - path compression: unutrasnji cvor cuva ceo zajednicki deo kljuceva ispod sebe (prefix),
+ *    pa lanac cvorova sa po jednim detetom ne postoji
+ *  - cvorovi rastu kroz cetiri velicine: Node4, Node16 (sortirani nizovi bajtova),
+ *    Node48 (indeks od 256 bajtova u niz od 48 dece) i Node256 (direktan niz)
+ *  - kljuc koji se zavrsava tacno u unutrasnjem cvoru (npr. "user" pored "user1")
+ *    cuva se u `terminal` listu tog cvora
+ *
+ * Obilazak dece po rastucem bajtu daje zapise sortirane po kljucu, sto koriste flush i SSTableCursor.
+ * Brisanje upisuje tombstone (kao i ostale memtable), pa cvorovi nikad ne opadaju.
+ */
+class MemtableART : public IMemtable {
+public:
+    MemtableART();
+    ~MemtableART() override;
+
+    MemtableART(const MemtableART&) = delete;
+    MemtableART& operator=(const MemtableART&) = delete;
+
+    void put(const std::string& key, const std::string& value) override;
+    void remove(const std::string& key) override;
+    std::optional<std::string> get(const std::string& key, bool& deleted) const override;
+    bool getView(const std::string& key, std::string_view& value, bool& deleted) const override;
+
+    size_t size() const override;
+    void setMaxSize(size_t maxSize) override;
+
+    std::vector<MemtableEntry> getAllMemtableEntries() const override;
+
+    std::optional<MemtableEntry> getEntry(const std::string& key) const override;
+    void updateEntry(const std::string& key, const MemtableEntry& entry) override;
+
+    std::vector<MemtableEntry> getSortedEntries() const override;
+
+    std::unique_ptr<MemtableIterator> newIterator() const override;
+
+private:
+    enum NodeType : uint8_t { LEAF, NODE4, NODE16, NODE48, NODE256 };
+
+    struct Node {
+        NodeType type;
+        explicit Node(NodeType t) : type(t) {}
+    };
+
+    struct Leaf : Node {
+        std::string key;
+        std::string value;
+        bool tombstone;
+        uint64_t timestamp;
+
+        Leaf(const std::string& k, const std::string& v, bool t, uint64_t ts)
+            : Node(LEAF), key(k), value(v), tombstone(t), timestamp(ts) {}
+    };
+
+    struct Inner : Node {
+        uint16_t numChildren = 0;
+        std::string prefix;         // sazeta putanja, bajtovi koje svi kljucevi ispod dele
+        Leaf* terminal = nullptr;   // kljuc koji se zavrsava odmah posle prefiksa
+
+        explicit Inner(NodeType t) : Node(t) {}
+    };
+
+    struct Node4 : Inner {
+        uint8_t keys[4];
+        Node* children[4] = {};
+        Node4() : Inner(NODE4) {}
+    };
+
+    struct Node16 : Inner {
+        uint8_t keys[16];
+        Node* children[16] = {};
+        Node16() : Inner(NODE16) {}
+    };
+
+    struct Node48 : Inner {
+        uint8_t childIndex[256] = {}; // 0 = nema deteta, inace indeks + 1 u children
+        Node* children[48] = {};
+        Node48() : Inner(NODE48) {}
+    };
+
+    struct Node256 : Inner {
+        Node* children[256] = {};
+        Node256() : Inner(NODE256) {}
+    };
+
+    Node* root_;
+    size_t entryCount_;
+    size_t maxSize_;
+
+    static Node** findChild(Inner* node, uint8_t byte);
+    static void addChild(Node*& nodeRef, uint8_t byte, Node* child);
+    static void copyHeader(Inner* dst, const Inner* src);
+    static void freeNode(Node* node);
+
+    // Za iteraciju: sledece dete na poziciji >= pos (pos se pomera iza njega), ili nullptr
+    static const Node* nextChild(const Inner* node, int& pos);
+    // Prva pozicija deteta sa bajtom >= byte; exact kaze da li dete sa tim bajtom postoji
+    static int childLowerBound(const Inner* node, uint8_t byte, bool& exact);
+
+    class Iterator;
+
+    // Vraca list za kljuc, ili nullptr
+    Leaf* findLeaf(const std::string& key) const;
+
+    // Upisuje novi ili menja postojeci zapis. Vraca false ako je memtable pun.
+    bool upsert(const std::string& key, const std::string& value, bool tombstone, uint64_t timestamp);
+
+    void collect(const Node* node, std::vector<MemtableEntry>& out) const;
+
+    uint64_t currentTime() const {
+        return static_cast<uint64_t>(std::chrono::system_clock::now().time_since_epoch().count());
+    }
+};
@@ -10,7 +10,16 @@ IMemtable* MemtableFactory::createMemtable() {
     }
 
     else if (Config::memtable_type == "btree") {
-        //return new BTree<16>(Config::memtable_max_size);
+        return new BTree<16>(Config::memtable_max_size);
+    }
+    else if (Config::memtable_type == "btree_prefix") {
+        return new BTreePrefix<16>(Config::memtable_max_size);
+    }
+    else if (Config::memtable_type == "art") {
+        return new MemtableART();
+    }
+    else if (Config::memtable_type == "vector") {
+        return new MemtableVector();
     }
     // Ako tip nije prepoznat, vracamo default, npr. hash
     return new MemtableHashMap();
@@ -5,6 +5,9 @@
 #include "MemtableHashMap.h"
 #include "MemtableSkipList.h"
 #include "BTree.h"
+#include "BTreePrefix.h"
+#include "MemtableART.h"
+#include "MemtableVector.h"
 
 class MemtableFactory {
 public:
@@ -4,8 +4,52 @@
 #include <vector>
 #include <algorithm> // Za sort
 #include <iostream>
+#include <thread>
 #include "MemtableHashMap.h"
 
+// Ispod ovoliko zapisa po niti ne isplati se pokretati niti, obican std::sort je brzi
+static const size_t PARALLEL_SORT_MIN_CHUNK = 16384;
+
+// Paralelni merge sort: svaka nit sortira svoj deo niza, pa se susedni delovi
+// spajaju u parovima (i ta spajanja u istoj rundi idu paralelno)
+static void parallelSort(std::vector<MemtableEntry>& entries) {
+    unsigned hw = std::thread::hardware_concurrency();
+    if (hw == 0) hw = 2;
+
+    const size_t chunks = std::min<size_t>(hw, entries.size() / PARALLEL_SORT_MIN_CHUNK);
+    if (chunks < 2) {
+        std::sort(entries.begin(), entries.end());
+        return;
+    }
+
+    std::vector<size_t> bounds(chunks + 1);
+    for (size_t i = 0; i <= chunks; ++i) {
+        bounds[i] = entries.size() * i / chunks;
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(chunks);
+    for (size_t i = 0; i < chunks; ++i) {
+        workers.emplace_back([&entries, lo = bounds[i], hi = bounds[i + 1]]() {
+            std::sort(entries.begin() + lo, entries.begin() + hi);
+        });
+    }
+    for (auto& t : workers) t.join();
+
+    for (size_t width = 1; width < chunks; width *= 2) {
+        workers.clear();
+        for (size_t i = 0; i + width < chunks; i += 2 * width) {
+            const size_t lo = bounds[i];
+            const size_t mid = bounds[i + width];
+            const size_t hi = bounds[std::min(i + 2 * width, chunks)];
+            workers.emplace_back([&entries, lo, mid, hi]() {
+                std::inplace_merge(entries.begin() + lo, entries.begin() + mid, entries.begin() + hi);
+            });
+        }
+        for (auto& t : workers) t.join();
+    }
+}
+
 MemtableHashMap::MemtableHashMap()
     : maxSize(Config::memtable_max_size)
 {}
@@ -50,6 +94,20 @@ optional<string> MemtableHashMap::get(const string& key, bool& deleted) const {
     return it->second.value;
 }
 
+bool MemtableHashMap::getView(const std::string& key, std::string_view& value, bool& deleted) const {
+    deleted = false;
+    auto it = table_.find(key);
+    if (it == table_.end()) {
+        return false;
+    }
+    if (it->second.tombstone) {
+        deleted = true;
+        return false;
+    }
+    value = it->second.value;
+    return true;
+}
+
 size_t MemtableHashMap::size() const {
     return table_.size();
 }
@@ -59,19 +117,7 @@ void MemtableHashMap::setMaxSize(size_t maxSize) {
 }
 
 vector<MemtableEntry> MemtableHashMap::getAllMemtableEntries() const {
-    vector<MemtableEntry> result;
-    result.reserve(table_.size());
-    for (const auto& [k, e] : table_) {
-        MemtableEntry me;
-        me.key = k;
-        me.value = e.value;
-        me.tombstone = e.tombstone;
-        me.timestamp = e.timestamp;
-        result.push_back(me);
-    }
-
-    sort(result.begin(), result.end());
-    return result;
+    return getSortedEntries();
 }
 
 std::optional<MemtableEntry> MemtableHashMap::getEntry(const string& key) const {
@@ -90,17 +136,51 @@ void MemtableHashMap::updateEntry(const string& key, const MemtableEntry& entry)
     table_[key] = { entry.value, entry.tombstone, entry.timestamp };
 }
 
+class MemtableHashMap::Iterator : public MemtableIterator {
+public:
+    using Item = const std::pair<const std::string, Entry>*;
+
+    explicit Iterator(const std::unordered_map<std::string, Entry>& table) : pos_(0) {
+        items_.reserve(table.size());
+        for (const auto& kv : table) {
+            items_.push_back(&kv);
+        }
+        std::sort(items_.begin(), items_.end(), [](Item a, Item b) { return a->first < b->first; });
+        pos_ = items_.size();
+    }
+
+    void seekToFirst() override { pos_ = 0; }
+    void seek(const std::string& key) override {
+        auto it = std::lower_bound(items_.begin(), items_.end(), key,
+            [](Item a, const std::string& k) { return a->first < k; });
+        pos_ = it - items_.begin();
+    }
+
+    bool valid() const override { return pos_ < items_.size(); }
+    void next() override { ++pos_; }
+
+    const std::string& key() const override { return items_[pos_]->first; }
+    const std::string& value() const override { return items_[pos_]->second.value; }
+    bool tombstone() const override { return items_[pos_]->second.tombstone; }
+    uint64_t timestamp() const override { return items_[pos_]->second.timestamp; }
+
+private:
+    std::vector<Item> items_;
+    size_t pos_;
+};
+
+std::unique_ptr<MemtableIterator> MemtableHashMap::newIterator() const {
+    return std::make_unique<Iterator>(table_);
+}
+
 std::vector<MemtableEntry> MemtableHashMap::getSortedEntries() const {
     std::vector<MemtableEntry> sorted;
+    sorted.reserve(table_.size());
     for (const auto& [key, entry] : table_) {
-        MemtableEntry e;
-        e.key = key;
-        e.value = entry.value;
-        e.tombstone = entry.tombstone;
-        e.timestamp = entry.timestamp;
-        sorted.push_back(e);
+        sorted.push_back(MemtableEntry{ key, entry.value, entry.tombstone, entry.timestamp });
     }
 
-    std::sort(sorted.begin(), sorted.end());
+    // Hash mapa nema redosled, pa je ovo sortiranje najskuplji deo flush-a
+    parallelSort(sorted);
     return sorted;
 }
@@ -22,6 +22,7 @@ public:
     void put(const std::string& key, const std::string& value) override;
     void remove(const std::string& key) override;
     std::optional<std::string> get(const std::string& key, bool& deleted) const override;
+    bool getView(const std::string& key, std::string_view& value, bool& deleted) const override;
     size_t size() const override;
     void setMaxSize(size_t maxSize) override;
     // void loadFromRecords(const std::vector<Record>& records) override;
@@ -37,6 +38,9 @@ public:
 
     virtual std::vector<MemtableEntry> getSortedEntries() const override;
 
+    // Hash mapa nema redosled: iterator sortira pokazivace na zapise (bez kopiranja vrednosti)
+    std::unique_ptr<MemtableIterator> newIterator() const override;
+
 private:
     // Struktura koju čuvamo u memoriji: (value, tombstone, timestamp)
     struct Entry {
@@ -48,6 +52,8 @@ private:
     // Mapa: key -> Entry
     std::unordered_map<std::string, Entry> table_;
 
+    class Iterator;
+
     // Maksimalan broj ključeva
     size_t maxSize;
 
@@ -4,6 +4,8 @@
 #include <map>
 #include <fstream>
 #include <stdexcept>
+#include <chrono>
+#include <algorithm>
 #include "MemtableManager.h"
 #include "MemtableFactory.h"
 
@@ -22,6 +24,9 @@ MemtableManager::MemtableManager(SSTManager* sst, Wal wal)
     auto first = std::unique_ptr<IMemtable>(createNewMemtable());
     first->setMaxSize(maxSize_);
     memtables_.push_back(std::move(first));
+    filters_.reserve(N_);
+    filters_.push_back(createNewFilter());
+    rangeTombstones_.emplace_back();
 
 }
 
@@ -34,20 +39,35 @@ MemtableManager::~MemtableManager() {
 
 void MemtableManager::put(const std::string& key, const std::string& value) {
     memtables_[activeIndex_]->put(key, value);
+    filters_[activeIndex_].add(key);
     std::cout << "[MemtableManager] Key '" << key << "' added.\n";
 }
 
 void MemtableManager::remove(const std::string& key) {
     memtables_[activeIndex_]->remove(key);
+    filters_[activeIndex_].add(key); // i tombstone mora da se nadje pri get-u
     std::cout << "[MemtableManager] Key '" << key << "' marked for deletion.\n";
     if (checkFlushIfNeeded()) {
         flushMemtable();
     }
 }
 
+void MemtableManager::removeRange(const std::string& begin, const std::string& end) {
+    // Isti sat kao timestamp-ovi zapisa u memtable, brisanje pokriva sve upisano pre njega
+    uint64_t now = static_cast<uint64_t>(std::chrono::system_clock::now().time_since_epoch().count());
+    rangeTombstones_[activeIndex_].push_back(RangeTombstone{ begin, end, now });
+    coalesceRangeTombstones(rangeTombstones_[activeIndex_]);
+    std::cout << "[MemtableManager] Range [" << begin << ", " << end << ") marked for deletion.\n";
+    if (checkFlushIfNeeded()) {
+        flushMemtable();
+    }
+}
+
 bool MemtableManager::checkFlushIfNeeded() {
-    if (memtables_[activeIndex_]->size() >= maxSize_) {
-        if (memtables_.size() < N_) {
+    // Brisanje opsega zauzima mesto kao jedan zapis, da bi i memtable sa samo brisanjima stigla do flush-a
+    if (memtables_[activeIndex_]->size() + rangeTombstones_[activeIndex_].size() >= maxSize_) {
+        // Pri ucitavanju WAL-a memtable moze biti i vise od N, visak se flush-uje na kraju
+        if (memtables_.size() < N_ || replaying_) {
             std::cout << "[MemtableManager] Active memtable is full. Switching to a new one.\n";
             switchToNewMemtable();
             return false;
@@ -65,6 +85,10 @@ bool MemtableManager::checkFlushIfNeeded() {
 void MemtableManager::flushMemtable() {
     flushOldest();
     switchToNewMemtable();
+    rewriteWal();
+}
+
+void MemtableManager::rewriteWal() {
     namespace fs = std::filesystem;
     try {
         for (const auto& entry : fs::directory_iterator(Config::wal_directory)) {
@@ -76,13 +100,31 @@ void MemtableManager::flushMemtable() {
         std::cerr << "Filesystem error: " << e.what() << std::endl;
     }
 
-    vector<MemtableEntry> vec = getAllEntries();
-    for(const auto& entry : vec) {
-        if(entry.tombstone) {
-            wal.del(entry.key);
-            continue;
-		}
-		wal.put(entry.key, entry.value);
+    // Brisanje opsega brise samo starije zapise, pa se u WAL upisuje izmedju zapisa svoje memtable
+    // po timestamp-u; ponovno ucitavanje tako zadrzava isti redosled
+    for (size_t i = 0; i < memtables_.size(); ++i) {
+        vector<MemtableEntry> vec = memtables_[i]->getAllMemtableEntries();
+        vector<RangeTombstone> tombstones = rangeTombstones_[i];
+        auto byTime = [](const auto& a, const auto& b) { return a.timestamp < b.timestamp; };
+        if (!tombstones.empty()) {
+            std::sort(vec.begin(), vec.end(), byTime);
+            std::sort(tombstones.begin(), tombstones.end(), byTime);
+        }
+
+        size_t t = 0;
+        for(const auto& entry : vec) {
+            for (; t < tombstones.size() && tombstones[t].timestamp <= entry.timestamp; ++t) {
+                wal.delRange(tombstones[t].begin, tombstones[t].end);
+            }
+            if(entry.tombstone) {
+                wal.del(entry.key);
+                continue;
+            }
+            wal.put(entry.key, entry.value);
+        }
+        for (; t < tombstones.size(); ++t) {
+            wal.delRange(tombstones[t].begin, tombstones[t].end);
+        }
 	}
 }
 
@@ -90,6 +132,8 @@ void MemtableManager::switchToNewMemtable() {
     auto newMem = std::unique_ptr<IMemtable>(createNewMemtable());
     newMem->setMaxSize(maxSize_);
     memtables_.push_back(std::move(newMem));
+    filters_.push_back(createNewFilter());
+    rangeTombstones_.emplace_back();
     activeIndex_ = memtables_.size() - 1; // Nova aktivna tabela je poslednja dodata
 }
 
@@ -101,8 +145,9 @@ void MemtableManager::flushOldest() {
     // uzimamo najstariju memtable (ona koja je na pocetku vektora)
     auto& oldestMemtable = memtables_.front();
     std::vector<MemtableEntry> entries = oldestMemtable->getSortedEntries();
+    const std::vector<RangeTombstone>& tombstones = rangeTombstones_.front();
 
-    if (entries.empty()) {
+    if (entries.empty() && tombstones.empty()) {
         std::cout << "[MemtableManager] Oldest memtable is empty, removing it without flushing." << std::endl;
     }
     else {
@@ -125,13 +170,14 @@ void MemtableManager::flushOldest() {
                 << ", " << (rec.tombstone == std::byte{1} ? "true" : "false")
                 << ", " << rec.timestamp << "\n";
 		}
-        // flushhovanje
-        sort(records.begin(), records.end(), [](const Record& a, const Record& b) {return a.key < b.key; }); // Sortiramo po kljucevima
-        sstManager_->write(records, 1);
+        // flushhovanje - getSortedEntries() vec vraca zapise sortirane po kljucu
+        sstManager_->write(records, 1, tombstones);
     }
 
     // brisemo najstariju memtable iz memorije
     memtables_.erase(memtables_.begin());
+    filters_.erase(filters_.begin());
+    rangeTombstones_.erase(rangeTombstones_.begin());
 
     // Posto smo obrisali element sa pocetka, svi indeksi su se pomerili ulevo
     if (activeIndex_ > 0) {
@@ -147,38 +193,79 @@ void MemtableManager::flushOldest() {
 }
 
 std::optional<std::string> MemtableManager::get(const std::string& key, bool& deleted) const {
+    std::string_view value;
+    if (getView(key, value, deleted)) {
+        return std::string(value);
+    }
+    return std::nullopt;
+}
+
+bool MemtableManager::getView(const std::string& key, std::string_view& value, bool& deleted) const {
+    // Najnovije brisanje opsega (iz bilo koje memtable) koje pokriva kljuc
+    uint64_t rangeDeleteTs = 0;
+    for (const auto& tombstones : rangeTombstones_) {
+        rangeDeleteTs = std::max(rangeDeleteTs, coveringTimestamp(tombstones, key));
+    }
+
     // prvo pretrazujemo memtable, od najnovije ka najstarijoj
     deleted = false;
     for (int i = static_cast<int>(memtables_.size()) - 1; i >= 0; i--) {
-        auto val = memtables_[i]->get(key, deleted);
-        if (deleted) {
-            return nullopt;
+        // Bloom filter kaze da kljuc sigurno nije u ovoj memtable, ne pretrazujemo je
+        if (!filters_[i].possiblyContains(key)) {
+            continue;
         }
-        if (val.has_value()) {
-            return val;
+        if (memtables_[i]->getView(key, value, deleted)) {
+            if (rangeDeleteTs == 0) return true;
+
+            // Zapis vazi samo ako je upisan posle brisanja opsega
+            std::optional<MemtableEntry> entry = memtables_[i]->getEntry(key);
+            deleted = !entry || entry->timestamp < rangeDeleteTs;
+            return !deleted;
+        }
+        if (deleted) {
+            return false;
         }
     }
 
-    return std::nullopt;
+    // Kljuca nema u memtable; brisanje opsega sakriva i sve njegove verzije na disku
+    deleted = rangeDeleteTs > 0;
+    return false;
 }
 
 IMemtable* MemtableManager::createNewMemtable() const {
     return MemtableFactory::createMemtable();
 }
 
+BloomFilter MemtableManager::createNewFilter() const {
+    // memtable ne moze imati vise od maxSize_ razlicitih kljuceva
+    unsigned int expected = static_cast<unsigned int>(std::max<size_t>(maxSize_, 1));
+    return BloomFilter(expected, 0.01, Config::bloom_filter_blocked);
+}
+
 void MemtableManager::loadFromWal(const std::vector<Record>& records) {
-    
-    
+    replaying_ = true;
     for (const auto& record : records) {
+        if (record.tombstone == TOMBSTONE_RANGE) {
+            removeRange(record.key, record.value); // value zapisa je kraj opsega
+            continue;
+        }
         if (static_cast<bool>(record.tombstone)) {
             memtables_[activeIndex_]->remove(record.key);
         }
         else {
             memtables_[activeIndex_]->put(record.key, record.value);
         }
-        if (checkFlushIfNeeded()) {
-            flushMemtable();
+        filters_[activeIndex_].add(record.key);
+        checkFlushIfNeeded();
+    }
+    replaying_ = false;
+
+    // Ceo WAL je sada u memtable, pa visak moze u SSTabele i WAL da se prepise jednom
+    if (memtables_.size() > N_) {
+        while (memtables_.size() > N_) {
+            flushOldest();
         }
+        rewriteWal();
     }
     std::cout << "[MemtableManager] " << records.size() << " records from WAL loaded into Memtable.\n";
 }
@@ -215,6 +302,76 @@ std::vector<MemtableEntry> MemtableManager::getAllEntries() const {
     return result;
 }
 
+std::vector<RangeTombstone> MemtableManager::getRangeTombstones() const {
+    std::vector<RangeTombstone> result;
+    for (const auto& tombstones : rangeTombstones_) {
+        result.insert(result.end(), tombstones.begin(), tombstones.end());
+    }
+    coalesceRangeTombstones(result);
+    return result;
+}
+
+namespace {
+
+// Memtable ima malo (N je par instanci), pa najmanji kljuc trazimo linearno umesto heap-om
+class MergingMemtableIterator : public MemtableIterator {
+public:
+    // children su poredjani od najstarije ka najnovijoj memtable
+    explicit MergingMemtableIterator(std::vector<std::unique_ptr<MemtableIterator>> children)
+        : children_(std::move(children)), current_(-1) {}
+
+    void seekToFirst() override {
+        for (auto& c : children_) c->seekToFirst();
+        findSmallest();
+    }
+
+    void seek(const std::string& key) override {
+        for (auto& c : children_) c->seek(key);
+        findSmallest();
+    }
+
+    bool valid() const override { return current_ >= 0; }
+
+    void next() override {
+        // Preskacemo isti kljuc u starijim memtable - vec smo vratili najnoviji zapis
+        const std::string key = children_[current_]->key();
+        for (auto& c : children_) {
+            if (c->valid() && c->key() == key) c->next();
+        }
+        findSmallest();
+    }
+
+    const std::string& key() const override { return children_[current_]->key(); }
+    const std::string& value() const override { return children_[current_]->value(); }
+    bool tombstone() const override { return children_[current_]->tombstone(); }
+    uint64_t timestamp() const override { return children_[current_]->timestamp(); }
+
+private:
+    std::vector<std::unique_ptr<MemtableIterator>> children_;
+    int current_;
+
+    void findSmallest() {
+        current_ = -1;
+        for (int i = 0; i < static_cast<int>(children_.size()); ++i) {
+            if (!children_[i]->valid()) continue;
+            // <= : kod istog kljuca pobedjuje novija memtable (veci indeks)
+            if (current_ < 0 || children_[i]->key() <= children_[current_]->key()) {
+                current_ = i;
+            }
+        }
+    }
+};
+
+}
+
+std::unique_ptr<MemtableIterator> MemtableManager::newIterator() const {
+    std::vector<std::unique_ptr<MemtableIterator>> children;
+    children.reserve(memtables_.size());
+    for (const auto& mt_ptr : memtables_) {
+        if (mt_ptr) children.push_back(mt_ptr->newIterator());
+    }
+    return std::make_unique<MergingMemtableIterator>(std::move(children));
+}
 
 //returns records from oldest memtable
 vector<Record> MemtableManager::getRecordsFromOldest() {
@@ -222,9 +379,13 @@ vector<Record> MemtableManager::getRecordsFromOldest() {
     std::vector<MemtableEntry> entries = oldestMemtable->getAllMemtableEntries();
 
     if (entries.empty()) {
-        std::cout << "[MemtableManager] Oldest memtable is empty, removing it without flushing." << std::endl;
+        // Moze imati samo brisanja opsega, njih flushOldest upisuje sam
+        std::cout << "[MemtableManager] Oldest memtable has no records." << std::endl;
+        return {};
     }
     else {
+        // Zapis koji pokriva brisanje opsega vraca se kao obrisan (System ga izbacuje iz kesa)
+        std::vector<RangeTombstone> tombstones = getRangeTombstones();
         std::vector<Record> records;
         records.reserve(entries.size());
         for (const auto& entry : entries) {
@@ -233,7 +394,8 @@ vector<Record> MemtableManager::getRecordsFromOldest() {
             r.key_size = entry.key.size();
             r.value = entry.value;
             r.value_size = entry.value.size();
-            r.tombstone = entry.tombstone ? std::byte{ 1 } : std::byte{ 0 };
+            bool deleted = entry.tombstone || entry.timestamp < coveringTimestamp(tombstones, entry.key);
+            r.tombstone = deleted ? std::byte{ 1 } : std::byte{ 0 };
             r.timestamp = entry.timestamp;
             records.push_back(r);
         }
@@ -6,11 +6,12 @@
 #include <optional>
 #include "IMemtable.h"
 #include "../SSTable/SSTManager.h"
+#include "../BloomFilter/BloomFilter.h"
 
 class MemtableManager {
 public:
     /**
-     * @param type tip Memtable ("hash", "skiplist", "btree")
+     * @param type tip Memtable ("hash_map", "skiplist", "btree", "btree_prefix", "art", "vector")
      * @param N maksimalan broj memtable instanci u memoriji
      * @param maxSizePerTable koliko elemenata moze stati u svaku memtable
      * @param directory direktorijum - ako je relative, mora "./", i mora da se zavrsava sa /. Ako se izostavi, default je "./".
@@ -25,8 +26,14 @@ public:
 
     void remove(const std::string& key);
 
+    // Brisanje svih kljuceva iz [begin, end) upisanih pre ovog poziva (jedan zapis, ne po kljucu)
+    void removeRange(const std::string& begin, const std::string& end);
+
     // Dohvatanje vrednosti iz memtable (po potrebi i iz sstable)
     std::optional<std::string> get(const std::string& key, bool& deleted) const;
+
+    // Dohvatanje bez kopiranja: value pokazuje u memtable i vazi do sledeceg put/remove/flush-a
+    bool getView(const std::string& key, std::string_view& value, bool& deleted) const;
     
     // Kada se sistem pokrene, Memtable treba popuniti zapisima iz WAL-a
     void loadFromWal(const std::vector<Record>& records);
@@ -45,6 +52,11 @@ public:
 
     // Za kursore
     std::vector<MemtableEntry> getAllEntries() const;
+    std::vector<RangeTombstone> getRangeTombstones() const;
+
+    // Spojen (k-way merge) iterator nad svim memtable, sortiran po kljucu.
+    // Za kljuc koji postoji u vise memtable vraca samo zapis iz najnovije.
+    std::unique_ptr<MemtableIterator> newIterator() const;
 
 private:
     std::string type_;   // sacuvamo koji tip je korisnik izabrao
@@ -57,15 +69,30 @@ private:
     // N instanci memtable
     std::vector<std::unique_ptr<IMemtable>> memtables_;
 
+    // Po jedan Bloom filter za svaku memtable (isti indeks kao u memtables_).
+    // Azurira se pri svakom upisu, pa get moze da preskoci memtable koja sigurno nema kljuc.
+    std::vector<BloomFilter> filters_;
+
+    // Brisanja opsega po memtable (isti indeks kao u memtables_), pri flush-u idu u SSTabelu
+    std::vector<std::vector<RangeTombstone>> rangeTombstones_;
+
     // Indeks "aktivne" (read-write) memtable
     size_t activeIndex_ = 0;
 
+    // Tokom loadFromWal se ne flush-uje: flush prepisuje WAL, a deo zapisa jos nije ucitan
+    bool replaying_ = false;
+
     // Pomocna: kreira novu memtable (koristeci MemtableFactory)
     IMemtable* createNewMemtable() const;
 
+    // Pomocna: kreira prazan Bloom filter dimenzionisan za maxSize_ kljuceva
+    BloomFilter createNewFilter() const;
+
     // Ako se aktivna memtable popuni, prelazimo na novu
     void switchToNewMemtable();
 
     void flushOldest(); // prazni samo najstariju memtable (prvu napravljenu)
+
+    void rewriteWal(); // WAL posle flush-a sadrzi samo zapise preostalih memtable
 };
 
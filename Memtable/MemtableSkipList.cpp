@@ -34,6 +34,16 @@ std::optional<std::string> MemtableSkipList::get(const std::string& key, bool& d
     return std::nullopt;
 }
 
+bool MemtableSkipList::getView(const std::string& key, std::string_view& value, bool& deleted) const {
+    auto node = skiplist_.getNode(key);
+    deleted = node && node->tombstone;
+    if (!node || node->tombstone) {
+        return false;
+    }
+    value = node->value;
+    return true;
+}
+
 size_t MemtableSkipList::size() const {
     return skiplist_.Size();
 }
@@ -85,6 +95,34 @@ std::vector<MemtableEntry> MemtableSkipList::getSortedEntries() const {
     return entries;
 }
 
+namespace {
+
+class SkipListIterator : public MemtableIterator {
+public:
+    explicit SkipListIterator(const SkipList& list) : list_(list), node_(nullptr) {}
+
+    void seekToFirst() override { node_ = list_.first(); }
+    void seek(const std::string& key) override { node_ = list_.lowerBound(key); }
+
+    bool valid() const override { return node_ != nullptr; }
+    void next() override { node_ = SkipList::next(node_); }
+
+    const std::string& key() const override { return node_->key; }
+    const std::string& value() const override { return node_->value; }
+    bool tombstone() const override { return node_->tombstone; }
+    uint64_t timestamp() const override { return node_->timestamp; }
+
+private:
+    const SkipList& list_;
+    SkipList::NodeHandle node_;
+};
+
+}
+
+std::unique_ptr<MemtableIterator> MemtableSkipList::newIterator() const {
+    return std::make_unique<SkipListIterator>(skiplist_);
+}
+
 /*
 std::vector<std::pair<std::string, std::string>> MemtableSkipList::getAllKeyValuePairs() const {
     return skiplist_.getAllKeyValuePairs();
@@ -24,6 +24,9 @@ public:
     // get vraca vrednost ako kljuc postoji, ili nullopt ako ne postoji
     std::optional<std::string> get(const std::string& key, bool& deleted) const override;
 
+    // get bez kopiranja vrednosti
+    bool getView(const std::string& key, std::string_view& value, bool& deleted) const override;
+
     // size vraca broj elemenata u memtejblu
     size_t size() const override;
 
@@ -42,6 +45,9 @@ public:
 
     virtual std::vector<MemtableEntry> getSortedEntries() const override;
 
+    // Iterator ide direktno po najnizem nivou skip liste
+    std::unique_ptr<MemtableIterator> newIterator() const override;
+
 private:
     SkipList skiplist_;
     size_t maxSize_;
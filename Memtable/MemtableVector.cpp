@@ -0,0 +1,188 @@
+#include "MemtableVector.h"
+#include <algorithm>
+
+MemtableVector::MemtableVector()
+    : sorted_(true), orderBuilt_(false), indexBuilt_(false), maxSize_(Config::memtable_max_size)
+{}
+
+long long MemtableVector::find(const std::string& key) const {
+    if (sorted_) {
+        auto it = std::lower_bound(entries_.begin(), entries_.end(), key,
+            [](const MemtableEntry& e, const std::string& k) { return e.key < k; });
+        if (it != entries_.end() && it->key == key) {
+            return it - entries_.begin();
+        }
+        return -1;
+    }
+
+    // Niz vise nije sortiran, trazimo preko indeksa koji pravimo tek sada
+    if (!indexBuilt_) {
+        index_.clear();
+        index_.reserve(entries_.size());
+        for (size_t i = 0; i < entries_.size(); ++i) {
+            index_[entries_[i].key] = i;
+        }
+        indexBuilt_ = true;
+    }
+
+    auto it = index_.find(key);
+    return it == index_.end() ? -1 : static_cast<long long>(it->second);
+}
+
+void MemtableVector::upsert(const std::string& key, const std::string& value, bool tombstone, uint64_t timestamp) {
+    // Najcesci slucaj kod bulk load-a: kljuc je veci od poslednjeg, samo dodajemo na kraj
+    if (sorted_ && (entries_.empty() || entries_.back().key < key)) {
+        if (entries_.size() >= maxSize_) {
+            std::cerr << "[MemtableVector] Dostignut maxSize, ne moze se ubaciti novi kljuc: " << key << "\n";
+            return;
+        }
+        entries_.push_back(MemtableEntry{ key, value, tombstone, timestamp });
+        return;
+    }
+
+    long long pos = find(key);
+    if (pos >= 0) {
+        entries_[pos].value = value;
+        entries_[pos].tombstone = tombstone;
+        entries_[pos].timestamp = timestamp;
+        return;
+    }
+
+    if (entries_.size() >= maxSize_) {
+        std::cerr << "[MemtableVector] Dostignut maxSize, ne moze se ubaciti novi kljuc: " << key << "\n";
+        return;
+    }
+
+    // Novi kljuc van redosleda
+    sorted_ = false;
+    orderBuilt_ = false;
+    entries_.push_back(MemtableEntry{ key, value, tombstone, timestamp });
+    if (indexBuilt_) {
+        index_[key] = entries_.size() - 1;
+    }
+}
+
+void MemtableVector::put(const std::string& key, const std::string& value) {
+    upsert(key, value, false, currentTime());
+}
+
+void MemtableVector::remove(const std::string& key) {
+    upsert(key, "", true, currentTime());
+}
+
+std::optional<std::string> MemtableVector::get(const std::string& key, bool& deleted) const {
+    deleted = false;
+    long long pos = find(key);
+    if (pos < 0) return std::nullopt;
+
+    if (entries_[pos].tombstone) {
+        deleted = true;
+        return std::nullopt;
+    }
+    return entries_[pos].value;
+}
+
+bool MemtableVector::getView(const std::string& key, std::string_view& value, bool& deleted) const {
+    long long pos = find(key);
+    deleted = pos >= 0 && entries_[pos].tombstone;
+    if (pos < 0 || entries_[pos].tombstone) return false;
+
+    value = entries_[pos].value;
+    return true;
+}
+
+size_t MemtableVector::size() const {
+    return entries_.size();
+}
+
+void MemtableVector::setMaxSize(size_t maxSize) {
+    maxSize_ = maxSize;
+}
+
+const std::vector<const MemtableEntry*>& MemtableVector::sortedOrder() const {
+    if (sorted_ || orderBuilt_) return order_;
+
+    // Sortiraju se samo pokazivaci, zapisi ostaju gde jesu. Kljucevi su jedinstveni.
+    order_.clear();
+    order_.reserve(entries_.size());
+    for (const MemtableEntry& e : entries_) order_.push_back(&e);
+    std::sort(order_.begin(), order_.end(),
+        [](const MemtableEntry* a, const MemtableEntry* b) { return a->key < b->key; });
+    orderBuilt_ = true;
+    return order_;
+}
+
+std::vector<MemtableEntry> MemtableVector::getAllMemtableEntries() const {
+    return getSortedEntries();
+}
+
+std::optional<MemtableEntry> MemtableVector::getEntry(const std::string& key) const {
+    long long pos = find(key);
+    if (pos < 0) return std::nullopt;
+    return entries_[pos];
+}
+
+void MemtableVector::updateEntry(const std::string& key, const MemtableEntry& entry) {
+    long long pos = find(key);
+    if (pos < 0) {
+        std::cerr << "[MemtableVector] Key '" << key << "' not found for update.\n";
+        return;
+    }
+    entries_[pos].value = entry.value;
+    entries_[pos].tombstone = entry.tombstone;
+    entries_[pos].timestamp = entry.timestamp;
+}
+
+std::vector<MemtableEntry> MemtableVector::getSortedEntries() const {
+    // Ako su kljucevi stizali rastuce, niz se vraca bez sortiranja
+    if (sorted_) {
+        return std::vector<MemtableEntry>(entries_.begin(), entries_.end());
+    }
+
+    std::vector<MemtableEntry> result;
+    result.reserve(entries_.size());
+    for (const MemtableEntry* e : sortedOrder()) {
+        result.push_back(*e);
+    }
+    return result;
+}
+
+// Iterator pamti svoj redosled zapisa (prazan = redom upisa, prvih count_), pa ga kasniji
+// upisi i sortiranja ne menjaju; vidi kljuceve koji su postojali kada je napravljen
+class MemtableVector::Iterator : public MemtableIterator {
+public:
+    Iterator(const std::deque<MemtableEntry>& entries, std::vector<const MemtableEntry*> order)
+        : entries_(entries), order_(std::move(order)),
+        count_(order_.empty() ? entries.size() : order_.size()), pos_(count_) {}
+
+    void seekToFirst() override { pos_ = 0; }
+    void seek(const std::string& key) override {
+        size_t lo = 0, hi = count_;
+        while (lo < hi) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (at(mid).key < key) lo = mid + 1;
+            else hi = mid;
+        }
+        pos_ = lo;
+    }
+
+    bool valid() const override { return pos_ < count_; }
+    void next() override { ++pos_; }
+
+    const std::string& key() const override { return at(pos_).key; }
+    const std::string& value() const override { return at(pos_).value; }
+    bool tombstone() const override { return at(pos_).tombstone; }
+    uint64_t timestamp() const override { return at(pos_).timestamp; }
+
+private:
+    const std::deque<MemtableEntry>& entries_;
+    std::vector<const MemtableEntry*> order_;
+    size_t count_;
+    size_t pos_;
+
+    const MemtableEntry& at(size_t i) const { return order_.empty() ? entries_[i] : *order_[i]; }
+};
+
+std::unique_ptr<MemtableIterator> MemtableVector::newIterator() const {
+    return std::make_unique<Iterator>(entries_, sortedOrder());
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "IMemtable.h"
+#include <string>
+#include <optional>
+#include <vector>
+#include <deque>
+#include <unordered_map>
+#include <cstdint>
+#include <chrono>
+#include <iostream>
+
+/**
+ * Memtable nad obicnim vektorom, za bulk load gde kljucevi stizu (skoro) sortirani.
+ *
+ * Dok god kljucevi stizu rastuce, put je dodavanje na kraj (O(1)) i niz je vec sortiran,
+ * pa ga flush koristi direktno. Prvi kljuc manji od poslednjeg obara sorted_ flag: od tada
+ * se zapis trazi preko hash indeksa (gradi se lenjo, tek kada zatreba), a flush i iteratori
+ * koriste sortiran niz pokazivaca na zapise (order_).
+ *
+ * Zapisi se nikad ne premestaju (deque ne pomera elemente pri dodavanju na kraj), pa string_view
+ * iz getView i otvoreni iteratori ostaju ispravni i posle novih upisa i sortiranja.
+ *
+ * Svaki kljuc je u nizu samo jednom - ponovljen upis menja postojeci zapis na mestu.
+ */
+class MemtableVector : public IMemtable {
+public:
+    MemtableVector();
+
+    void put(const std::string& key, const std::string& value) override;
+    void remove(const std::string& key) override;
+    std::optional<std::string> get(const std::string& key, bool& deleted) const override;
+    bool getView(const std::string& key, std::string_view& value, bool& deleted) const override;
+
+    size_t size() const override;
+    void setMaxSize(size_t maxSize) override;
+
+    std::vector<MemtableEntry> getAllMemtableEntries() const override;
+
+    std::optional<MemtableEntry> getEntry(const std::string& key) const override;
+    void updateEntry(const std::string& key, const MemtableEntry& entry) override;
+
+    std::vector<MemtableEntry> getSortedEntries() const override;
+
+    std::unique_ptr<MemtableIterator> newIterator() const override;
+
+private:
+    // Zapisi redom upisa; sorted_ je true dok je taj redosled i redosled kljuceva
+    std::deque<MemtableEntry> entries_;
+    bool sorted_;
+
+    // Zapisi iz entries_ sortirani po kljucu, vazi samo dok je orderBuilt_ true (kada sorted_ nije)
+    mutable std::vector<const MemtableEntry*> order_;
+    mutable bool orderBuilt_;
+
+    // key -> pozicija u entries_, vazi samo dok je indexBuilt_ true
+    mutable std::unordered_map<std::string, size_t> index_;
+    mutable bool indexBuilt_;
+
+    size_t maxSize_;
+
+    class Iterator;
+
+    // Pozicija kljuca u entries_, ili -1
+    long long find(const std::string& key) const;
+
+    void upsert(const std::string& key, const std::string& value, bool tombstone, uint64_t timestamp);
+
+    // Zapisi sortirani po kljucu (pravi order_ ako treba); prazno ako je sorted_
+    const std::vector<const MemtableEntry*>& sortedOrder() const;
+
+    uint64_t currentTime() const {
+        return static_cast<uint64_t>(std::chrono::system_clock::now().time_since_epoch().count());
+    }
+};
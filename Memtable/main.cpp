@@ -1,6 +1,396 @@
+#include "MemtableFactory.h"
+#include "MemtableManager.h"
+#include "../block-manager/block-manager.h"
+#include "../Wal/wal.h"
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <memory>
+#include <filesystem>
 
+using namespace std;
+
+// Benchmark memtable implementacija nad kljucevima sa dugim zajednickim prefiksom (user:region:id)
+
+static vector<string> napraviKljuceve(size_t n) {
+    const vector<string> regioni = { "eu-central", "eu-west", "us-east", "us-west", "ap-south" };
+    vector<string> kljucevi;
+    kljucevi.reserve(n);
+    for (size_t i = 0; i < n; ++i) {
+        kljucevi.push_back("user:" + regioni[i % regioni.size()] + ":" + to_string(1000000 + i));
+    }
+
+    mt19937 rng(42);
+    shuffle(kljucevi.begin(), kljucevi.end(), rng);
+    return kljucevi;
+}
+
+template <typename F>
+static double izmeriMs(F&& f) {
+    auto start = chrono::steady_clock::now();
+    f();
+    auto end = chrono::steady_clock::now();
+    return chrono::duration<double, milli>(end - start).count();
+}
+
+static void benchmark(const string& tip, const vector<string>& kljucevi) {
+    Config::memtable_type = tip;
+    unique_ptr<IMemtable> mt(MemtableFactory::createMemtable());
+    mt->setMaxSize(kljucevi.size());
+
+    double put = izmeriMs([&]() {
+        for (const auto& k : kljucevi) mt->put(k, "vrednost");
+    });
+
+    size_t pogoci = 0;
+    double get = izmeriMs([&]() {
+        bool deleted;
+        for (const auto& k : kljucevi) pogoci += mt->get(k, deleted).has_value();
+    });
+
+    size_t sortirano = 0;
+    double flush = izmeriMs([&]() {
+        sortirano = mt->getSortedEntries().size();
+    });
+
+    cout << setw(14) << tip
+        << setw(12) << fixed << setprecision(1) << put
+        << setw(12) << get
+        << setw(12) << flush
+        << setw(10) << pogoci
+        << setw(10) << sortirano << endl;
+}
+
+// Flush memtable koja ima samo brisanje opsega, pa citanje kroz SSTabelu
+static bool proveriFlushBrisanjaOpsega() {
+    namespace fs = std::filesystem;
+    Config::memtable_type = "skiplist";
+    Config::memtable_instances = 1;
+    Config::memtable_max_size = 2;
+    Config::data_directory = "./proba_brisanja_opsega";
+    Config::wal_directory = Config::data_directory + "/wal_logs";
+    fs::remove_all(Config::data_directory);
+    fs::create_directories(Config::wal_directory);
+
+    bool ispravno = true;
+    {
+        Block_manager bm;
+        Wal wal(bm);
+        SSTManager sst(&bm);
+        MemtableManager mm(&sst, wal);
+
+        // Prva tabela: obicni zapisi (kao System::put)
+        mm.put("kljuc1", "v1");
+        mm.put("kljuc4", "v4");
+        if (mm.checkFlushIfNeeded()) {
+            mm.getRecordsFromOldest();
+            mm.flushMemtable();
+        }
+
+        // Druga tabela: memtable bez ijednog zapisa, samo brisanje [kljuc1, kljuc3)
+        mm.removeRange("kljuc1", "kljuc3");
+        ispravno &= mm.getRecordsFromOldest().empty();
+        mm.flushMemtable();
+
+        ispravno &= !sst.get("kljuc1").has_value();
+        ispravno &= !sst.get("kljuc2").has_value();
+        optional<string> preostao = sst.get("kljuc4");
+        ispravno &= preostao.has_value() && *preostao == "v4";
+    }
+
+    fs::remove_all(Config::data_directory);
+    cout << "Flush samo brisanja opsega | ispravno: " << (ispravno ? "da" : "NE") << endl;
+    return ispravno;
+}
+
+// string_view iz getView i otvoren iterator moraju preziveti upis van redosleda i sortiranje
+static bool proveriPogledVektora() {
+    Config::memtable_type = "vector";
+    unique_ptr<IMemtable> mt(MemtableFactory::createMemtable());
+    mt->setMaxSize(100);
+
+    mt->put("k5", "v5");
+    mt->put("k3", "v3"); // van redosleda
+
+    bool deleted = false;
+    string_view pogled;
+    bool ispravno = mt->getView("k5", pogled, deleted);
+
+    unique_ptr<MemtableIterator> stari = mt->newIterator();
+    for (int i = 0; i < 50; ++i) {
+        mt->put("k" + to_string(100 - i), "nova" + to_string(i)); // nove pozicije i ponovno sortiranje
+    }
+
+    vector<string> redom;
+    unique_ptr<MemtableIterator> it = mt->newIterator();
+    for (it->seekToFirst(); it->valid(); it->next()) redom.push_back(it->key());
+    ispravno &= redom.size() == 52 && is_sorted(redom.begin(), redom.end());
+
+    ispravno &= pogled == "v5";
+
+    // Iterator otvoren pre upisa vidi iste kljuceve, istim redom
+    vector<string> stariRedom;
+    for (stari->seekToFirst(); stari->valid(); stari->next()) stariRedom.push_back(stari->key());
+    ispravno &= stariRedom == vector<string>{ "k3", "k5" };
+
+    stari->seek("k4");
+    ispravno &= stari->valid() && stari->key() == "k5" && stari->value() == "v5";
+
+    cout << "Vector memtable pogled posle upisa | ispravno: " << (ispravno ? "da" : "NE") << endl;
+    return ispravno;
+}
+
+// Paralelno sortiranje hash_map memtable (dovoljno zapisa da se deli na niti) i upis
+// nesortiranih zapisa, koje SSTable::build tada sam sortira
+static bool proveriSortiranjeHesMape() {
+    namespace fs = std::filesystem;
+    Config::memtable_type = "hash_map";
+    unique_ptr<IMemtable> mt(MemtableFactory::createMemtable());
+
+    const size_t N = 100000;
+    vector<string> kljucevi = napraviKljuceve(N);
+    mt->setMaxSize(N);
+    for (const auto& k : kljucevi) mt->put(k, "v" + k);
+    for (size_t i = 0; i < N; i += 7) mt->remove(kljucevi[i]);
+
+    vector<MemtableEntry> sortirani = mt->getSortedEntries();
+    bool ispravno = sortirani.size() == N && is_sorted(sortirani.begin(), sortirani.end());
+    vector<string> ocekivani = kljucevi;
+    sort(ocekivani.begin(), ocekivani.end());
+    for (size_t i = 0; ispravno && i < N; ++i) {
+        ispravno = sortirani[i].key == ocekivani[i] && (sortirani[i].tombstone || sortirani[i].value == "v" + ocekivani[i]);
+    }
+    size_t obrisani = count_if(sortirani.begin(), sortirani.end(), [](const MemtableEntry& e) { return e.tombstone; });
+    ispravno &= obrisani == (N + 6) / 7;
+
+    Config::data_directory = "./proba_sortiranja";
+    fs::remove_all(Config::data_directory);
+    fs::create_directories(Config::data_directory);
+    {
+        Block_manager bm;
+        SSTManager sst(&bm);
+        vector<Record> zapisi;
+        for (size_t i = 0; i < 1000; ++i) {
+            Record r{};
+            r.key = kljucevi[i];
+            r.value = "v" + kljucevi[i];
+            r.key_size = r.key.size();
+            r.value_size = r.value.size();
+            r.timestamp = i + 1;
+            zapisi.push_back(r);
+        }
+        sst.write(zapisi, 1);
+        for (size_t i = 0; i < 1000; i += 37) {
+            optional<string> v = sst.get(kljucevi[i]);
+            ispravno &= v.has_value() && *v == "v" + kljucevi[i];
+        }
+    }
+    fs::remove_all(Config::data_directory);
+
+    cout << "Sortiranje hash_map memtable | ispravno: " << (ispravno ? "da" : "NE") << endl;
+    return ispravno;
+}
+
+// Spojen iterator nad tri memtable: najnovija memtable pobedjuje, tombstone ostaje vidljiv kursoru
+static bool proveriSpojenIterator() {
+    namespace fs = std::filesystem;
+    Config::memtable_instances = 3;
+    Config::memtable_max_size = 4;
+    Config::data_directory = "./proba_iteratora";
+    Config::wal_directory = Config::data_directory + "/wal_logs";
+
+    const vector<string> tipovi = { "hash_map", "skiplist", "btree", "btree_prefix", "art", "vector" };
+    bool ispravno = true;
+    for (const string& tip : tipovi) {
+        Config::memtable_type = tip;
+        fs::remove_all(Config::data_directory);
+        fs::create_directories(Config::wal_directory);
+
+        vector<string> redom;
+        bool tip_ispravan = true;
+        {
+            Block_manager bm;
+            Wal wal(bm);
+            SSTManager sst(&bm);
+            MemtableManager mm(&sst, wal);
+            auto upisi = [&](const string& k, const string& v) {
+                mm.put(k, v);
+                mm.checkFlushIfNeeded();
+            };
+
+            upisi("k7", "v7"); upisi("k1", "v1"); upisi("k5", "v5"); upisi("k3", "v3");
+            upisi("k3", "n3"); upisi("k2", "n2"); mm.remove("k5"); upisi("k8", "n8");
+            upisi("k9", "z9"); upisi("k1", "z1");
+
+            unique_ptr<MemtableIterator> it = mm.newIterator();
+            for (it->seekToFirst(); it->valid(); it->next()) {
+                redom.push_back(it->key() + "=" + (it->tombstone() ? string("-") : it->value()));
+            }
+
+            it->seek("k4");
+            tip_ispravan &= it->valid() && it->key() == "k5" && it->tombstone();
+            it->seek("k6");
+            tip_ispravan &= it->valid() && it->key() == "k7" && it->value() == "v7";
+            it->seek("k99");
+            tip_ispravan &= !it->valid();
+        }
+        tip_ispravan &= redom == vector<string>{ "k1=z1", "k2=n2", "k3=n3", "k5=-", "k7=v7", "k8=n8", "k9=z9" };
+        if (!tip_ispravan) cout << "  spojen iterator ne radi za " << tip << endl;
+        ispravno &= tip_ispravan;
+    }
+
+    fs::remove_all(Config::data_directory);
+    cout << "Spojen iterator nad memtable | ispravno: " << (ispravno ? "da" : "NE") << endl;
+    return ispravno;
+}
+
+// getView bez kopiranja: pogled pokazuje u memtable, a preko MemtableManager-a vazi
+// najnovija verzija, tombstone i brisanje opsega
+static bool proveriPozajmljenuVrednost() {
+    namespace fs = std::filesystem;
+    Config::memtable_instances = 2;
+    Config::memtable_max_size = 3;
+    Config::data_directory = "./proba_pogleda";
+    Config::wal_directory = Config::data_directory + "/wal_logs";
+
+    const vector<string> tipovi = { "hash_map", "skiplist", "btree", "btree_prefix", "art", "vector" };
+    bool ispravno = true;
+    for (const string& tip : tipovi) {
+        Config::memtable_type = tip;
+        bool tip_ispravan = true;
+
+        unique_ptr<IMemtable> mt(MemtableFactory::createMemtable());
+        mt->setMaxSize(10);
+        mt->put("a", string(100, 'x'));
+        mt->put("b", "vb");
+        mt->remove("b");
+
+        string_view prvi, drugi;
+        bool deleted = true;
+        tip_ispravan &= mt->getView("a", prvi, deleted) && !deleted && prvi == string(100, 'x');
+        tip_ispravan &= mt->getView("a", drugi, deleted) && prvi.data() == drugi.data();
+        tip_ispravan &= !mt->getView("b", prvi, deleted) && deleted;
+        tip_ispravan &= !mt->getView("c", prvi, deleted) && !deleted;
+
+        fs::remove_all(Config::data_directory);
+        fs::create_directories(Config::wal_directory);
+        {
+            Block_manager bm;
+            Wal wal(bm);
+            SSTManager sst(&bm);
+            MemtableManager mm(&sst, wal);
+            mm.put("k1", "stara"); mm.put("k2", "v2"); mm.put("k3", "v3");
+            mm.checkFlushIfNeeded();
+            mm.put("k1", "nova");
+            mm.removeRange("k2", "k3");
+
+            string_view v;
+            tip_ispravan &= mm.getView("k1", v, deleted) && v == "nova";
+            tip_ispravan &= !mm.getView("k2", v, deleted) && deleted;
+            tip_ispravan &= mm.getView("k3", v, deleted) && v == "v3";
+            tip_ispravan &= !mm.getView("k4", v, deleted) && !deleted;
+        }
+
+        if (!tip_ispravan) cout << "  getView ne radi za " << tip << endl;
+        ispravno &= tip_ispravan;
+    }
+
+    fs::remove_all(Config::data_directory);
+    cout << "Pozajmljena vrednost (getView) | ispravno: " << (ispravno ? "da" : "NE") << endl;
+    return ispravno;
+}
+
+// Ponovno pokretanje posle pada: WAL sa put, brisanjem opsega i put se ucitava u memtable koja se
+// tokom ucitavanja puni vise puta. Drugi pad odmah posle ucitavanja ne sme da izgubi nijedan zapis.
+static bool proveriUcitavanjeWala() {
+    namespace fs = std::filesystem;
+    Config::memtable_type = "skiplist";
+    Config::memtable_instances = 1;
+    Config::data_directory = "./proba_ucitavanja_wala";
+    Config::wal_directory = Config::data_directory + "/wal_logs";
+    fs::remove_all(Config::data_directory);
+    fs::create_directories(Config::wal_directory);
+
+    // MemtableManager se namerno ne unistava (pad procesa): destruktor bi flush-ovao memtable
+    Config::memtable_max_size = 100;
+    {
+        Block_manager bm;
+        Wal wal(bm);
+        SSTManager sst(&bm);
+        MemtableManager* mm = new MemtableManager(&sst, wal);
+        auto upisi = [&](const string& k, const string& v) { wal.put(k, v); mm->put(k, v); };
+        upisi("kljuc1", "v1");
+        upisi("kljuc2", "v2");
+        wal.delRange("kljuc1", "kljuc3");
+        mm->removeRange("kljuc1", "kljuc3");
+        upisi("kljuc1", "v1b");
+        upisi("kljuc4", "v4");
+        upisi("kljuc5", "v5");
+        upisi("kljuc6", "v6");
+    }
+
+    Config::memtable_max_size = 2;
+    for (int pokretanje = 0; pokretanje < 2; ++pokretanje) {
+        Block_manager bm;
+        Wal wal(bm);
+        SSTManager sst(&bm);
+        MemtableManager* mm = new MemtableManager(&sst, wal);
+        mm->loadFromWal(wal.get_all_records());
+    }
+
+    bool ispravno = true;
+    {
+        Block_manager bm;
+        Wal wal(bm);
+        SSTManager sst(&bm);
+        MemtableManager mm(&sst, wal);
+        mm.loadFromWal(wal.get_all_records());
+        auto procitaj = [&](const string& k) -> optional<string> {
+            bool deleted = false;
+            optional<string> v = mm.get(k, deleted);
+            if (v.has_value() || deleted) return v;
+            return sst.get(k);
+        };
+        ispravno &= procitaj("kljuc1") == optional<string>("v1b");
+        ispravno &= !procitaj("kljuc2").has_value();
+        ispravno &= procitaj("kljuc4") == optional<string>("v4");
+        ispravno &= procitaj("kljuc5") == optional<string>("v5");
+        ispravno &= procitaj("kljuc6") == optional<string>("v6");
+    }
+
+    fs::remove_all(Config::data_directory);
+    cout << "Ucitavanje WAL-a posle pada | ispravno: " << (ispravno ? "da" : "NE") << endl;
+    return ispravno;
+}
 
 int main() {
+    if (!proveriFlushBrisanjaOpsega() || !proveriPogledVektora() || !proveriSortiranjeHesMape() ||
+        !proveriSpojenIterator() || !proveriPozajmljenuVrednost() || !proveriUcitavanjeWala()) {
+        return 1;
+    }
+
+    const size_t N = 200000;
+    vector<string> kljucevi = napraviKljuceve(N);
+
+    cout << "Memtable benchmark, " << N << " kljuceva (vreme u ms)" << endl;
+    cout << setw(14) << "tip" << setw(12) << "put" << setw(12) << "get"
+        << setw(12) << "sorted" << setw(10) << "pogoci" << setw(10) << "zapisi" << endl;
+
+    const vector<string> tipovi = { "hash_map", "skiplist", "btree", "btree_prefix", "art", "vector" };
+    for (const string& tip : tipovi) {
+        benchmark(tip, kljucevi);
+    }
+
+    // Bulk load: kljucevi stizu sortirani
+    sort(kljucevi.begin(), kljucevi.end());
+    cout << "\nSortiran ulaz (bulk load)" << endl;
+    for (const string& tip : tipovi) {
+        benchmark(tip, kljucevi);
+    }
 
-	return 0;
-}
\ No newline at end of file
+    return 0;
+}
@@ -34,3 +34,43 @@ public:
     static bool verifyProof(const std::string& rootHash, const std::string& data,
         const std::vector<std::pair<std::string, bool>>& proof);
 };
+
+/*
+    * Merkle koren bez cuvanja celog stabla (koristi ga SSTable build i validate).
+    *
+    * Hesevi su sirovi bajtovi (DIGEST_SIZE), a ne decimalni zapis kao u MerkleTree, pa je
+    * i stablo drugacije: tabela koja ih koristi to oznacava u TOC-u. Hes je MurmurHash3_x64_128
+    * sa fiksnim seed-om, isti na svakom kompajleru; legacyDigest je std::hash (8 bajta)
+    * kojim su pisane starije tabele, i koristi se samo za njihovu proveru. Listovi se hesiraju
+    * paralelno (hashLeaves), a od unutrasnjih cvorova se pamti samo frontier: na svakom nivou
+    * najvise jedan levi cvor koji ceka desnog suseda. Neparan cvor na kraju nivoa se spaja
+    * sam sa sobom, kao u MerkleTree.
+*/
+class MerkleStream {
+public:
+    static constexpr size_t DIGEST_SIZE = 16;
+
+    explicit MerkleStream(bool legacyDigest = false) : legacy_(legacyDigest) {}
+
+    // Hes lista za svaku od count vrednosti (valueAt(i) vraca i-tu), racunat na vise niti
+    static std::vector<std::string> hashLeaves(size_t count, const std::function<const std::string& (size_t)>& valueAt, bool legacyDigest = false);
+
+    // Dodaje sledeci list (hes iz hashLeaves)
+    void add(const std::string& leafHash);
+
+    // Koren svih dodatih listova; "" ako listova nema
+    std::string root() const;
+    // Koren stabla nad gotovim listovima
+    static std::string rootOf(const std::vector<std::string>& leaves, bool legacyDigest = false);
+
+    static std::string hash(const char* data, size_t len, bool legacyDigest = false);
+    // Heksadecimalni zapis sirovog hesa, za ispis
+    static std::string toHex(const std::string& digest);
+
+private:
+    std::vector<std::string> frontier_; // frontier_[nivo], "" ako na tom nivou nema cvora koji ceka
+    size_t count_ = 0;
+    bool legacy_;
+
+    static std::string combine(const std::string& left, const std::string& right, bool legacyDigest);
+};
@@ -1,8 +1,14 @@
 ﻿#include "MerkleTree.h"
+#include "../MurmurHash3/MurmurHash3.h"
 #include <sstream>
 #include <iomanip>
 #include <algorithm>
 #include <functional>
+#include <string_view>
+#include <thread>
+
+// Ispod ovoliko listova po niti ne isplati se pokretati niti
+static const size_t PARALLEL_HASH_MIN_LEAVES = 4096;
 
 MerkleTree::MerkleTree(const std::vector<std::string>& data) {
     if (data.empty()) {
@@ -99,4 +105,108 @@ bool MerkleTree::verifyProof(const std::string& rootHash, const std::string& dat
     }
 
     return computedHash == rootHash;
-}
\ No newline at end of file
+}
+
+std::vector<std::string> MerkleStream::hashLeaves(size_t count, const std::function<const std::string& (size_t)>& valueAt, bool legacyDigest) {
+    std::vector<std::string> leaves(count);
+
+    auto hashRange = [&leaves, &valueAt, legacyDigest](size_t lo, size_t hi) {
+        for (size_t i = lo; i < hi; ++i) {
+            const std::string& value = valueAt(i);
+            leaves[i] = hash(value.data(), value.size(), legacyDigest);
+        }
+    };
+
+    unsigned hw = std::thread::hardware_concurrency();
+    if (hw == 0) hw = 2;
+
+    const size_t chunks = std::min<size_t>(hw, count / PARALLEL_HASH_MIN_LEAVES);
+    if (chunks < 2) {
+        hashRange(0, count);
+        return leaves;
+    }
+
+    // Svaka nit upisuje samo svoj deo niza listova
+    std::vector<std::thread> workers;
+    workers.reserve(chunks);
+    for (size_t i = 0; i < chunks; ++i) {
+        workers.emplace_back(hashRange, count * i / chunks, count * (i + 1) / chunks);
+    }
+    for (auto& t : workers) t.join();
+
+    return leaves;
+}
+
+void MerkleStream::add(const std::string& leafHash) {
+    // Kao sabiranje u binarnom brojacu: par na nivou daje cvor na sledecem nivou
+    std::string carry = leafHash;
+    size_t level = 0;
+    while (level < frontier_.size() && !frontier_[level].empty()) {
+        carry = combine(frontier_[level], carry, legacy_);
+        frontier_[level].clear();
+        level++;
+    }
+    if (level == frontier_.size()) frontier_.emplace_back();
+    frontier_[level] = carry;
+    count_++;
+}
+
+std::string MerkleStream::root() const {
+    if (count_ == 0) return "";
+
+    size_t top = frontier_.size() - 1;
+    while (frontier_[top].empty()) top--;
+
+    // Zatvaramo nivoe odozdo: cvor koji ostane bez para spaja se sam sa sobom
+    std::string carry;
+    for (size_t level = 0; level < top; ++level) {
+        const std::string& waiting = frontier_[level];
+        if (!waiting.empty() && !carry.empty()) carry = combine(waiting, carry, legacy_);
+        else if (!waiting.empty()) carry = combine(waiting, waiting, legacy_);
+        else if (!carry.empty()) carry = combine(carry, carry, legacy_);
+    }
+
+    return carry.empty() ? frontier_[top] : combine(frontier_[top], carry, legacy_);
+}
+
+std::string MerkleStream::rootOf(const std::vector<std::string>& leaves, bool legacyDigest) {
+    MerkleStream tree(legacyDigest);
+    for (const auto& leaf : leaves) {
+        tree.add(leaf);
+    }
+    return tree.root();
+}
+
+std::string MerkleStream::hash(const char* data, size_t len, bool legacyDigest) {
+    if (legacyDigest) {
+        // Zavisi od implementacije standardne biblioteke, ostaje samo za citanje starih tabela
+        size_t hash_value = std::hash<std::string_view>()(std::string_view(data, len));
+        return std::string(reinterpret_cast<const char*>(&hash_value), sizeof(hash_value));
+    }
+
+    uint64_t hash_value[2];
+    MurmurHash3_x64_128(data, static_cast<int>(len), 0, hash_value);
+    return std::string(reinterpret_cast<const char*>(hash_value), DIGEST_SIZE);
+}
+
+std::string MerkleStream::combine(const std::string& left, const std::string& right, bool legacyDigest) {
+    // Listovi procitani iz ostecenog meta dela mogu biti duzi od hesa
+    if (left.size() + right.size() > 2 * DIGEST_SIZE) {
+        std::string joined = left + right;
+        return hash(joined.data(), joined.size(), legacyDigest);
+    }
+
+    char both[2 * DIGEST_SIZE];
+    std::copy(left.begin(), left.end(), both);
+    std::copy(right.begin(), right.end(), both + left.size());
+    return hash(both, left.size() + right.size(), legacyDigest);
+}
+
+std::string MerkleStream::toHex(const std::string& digest) {
+    std::stringstream ss;
+    ss << std::hex << std::setfill('0');
+    for (unsigned char c : digest) {
+        ss << std::setw(2) << static_cast<int>(c);
+    }
+    return ss.str();
+}
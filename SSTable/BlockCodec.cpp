@@ -0,0 +1,155 @@
+#include "BlockCodec.h"
+#include "../Utils/VarEncoding.h"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+using namespace std;
+
+const BlockCodec* BlockCodec::byId(uint8_t id) {
+    static const NoCodec none;
+    static const LZCodec lz;
+
+    switch (static_cast<CodecId>(id)) {
+    case CodecId::None: return &none;
+    case CodecId::LZ: return &lz;
+    }
+    return nullptr;
+}
+
+const BlockCodec* BlockCodec::byName(const string& name) {
+    for (CodecId id : { CodecId::None, CodecId::LZ }) {
+        const BlockCodec* codec = byId(static_cast<uint8_t>(id));
+        if (name == codec->name()) return codec;
+    }
+    return nullptr;
+}
+
+void NoCodec::compress(const string& in, string& out) const {
+    out = in;
+}
+
+bool NoCodec::decompress(const char* in, size_t len, string& out) const {
+    out.assign(in, len);
+    return true;
+}
+
+void LZCodec::compress(const string& in, string& out) const {
+    out.clear();
+    out.reserve(in.size() / 2 + 16);
+    out.append(varenc::encodeVarint<uint64_t>(in.size()));
+
+    const uint8_t* src = reinterpret_cast<const uint8_t*>(in.data());
+    const size_t n = in.size();
+    const uint32_t EMPTY = 0xFFFFFFFF;
+    vector<uint32_t> table(1 << HASH_BITS, EMPTY); // hes 4 bajta -> poslednja pozicija
+
+    auto read32 = [&](size_t pos) {
+        uint32_t v;
+        memcpy(&v, src + pos, sizeof(v));
+        return v;
+    };
+    auto putLength = [&](size_t len) {
+        while (len >= 255) {
+            out.push_back(static_cast<char>(255));
+            len -= 255;
+        }
+        out.push_back(static_cast<char>(len));
+    };
+    auto putSequence = [&](size_t literalStart, size_t literalLen, size_t offset, size_t matchLen) {
+        size_t matchCode = matchLen == 0 ? 0 : matchLen - MIN_MATCH;
+        uint8_t token = static_cast<uint8_t>((min<size_t>(literalLen, 15) << 4) | min<size_t>(matchCode, 15));
+        out.push_back(static_cast<char>(token));
+        if (literalLen >= 15) putLength(literalLen - 15);
+        out.append(in, literalStart, literalLen);
+
+        if (matchLen == 0) return; // poslednja sekvenca
+        out.push_back(static_cast<char>(offset & 0xFF));
+        out.push_back(static_cast<char>(offset >> 8));
+        if (matchCode >= 15) putLength(matchCode - 15);
+    };
+
+    size_t anchor = 0; // pocetak literala koji jos nisu upisani
+    size_t pos = 0;
+    while (pos + MIN_MATCH <= n) {
+        uint32_t v = read32(pos);
+        uint32_t h = (v * 2654435761u) >> (32 - HASH_BITS);
+        uint32_t candidate = table[h];
+        table[h] = static_cast<uint32_t>(pos);
+
+        if (candidate != EMPTY && pos - candidate <= MAX_OFFSET && read32(candidate) == v) {
+            size_t len = MIN_MATCH;
+            while (pos + len < n && src[candidate + len] == src[pos + len]) len++;
+
+            putSequence(anchor, pos - anchor, pos - candidate, len);
+            pos += len;
+            anchor = pos;
+        }
+        else {
+            // Sto duze nema poklapanja, to krupnije koracamo kroz nekompresibilne podatke
+            pos += 1 + ((pos - anchor) >> 6);
+        }
+    }
+
+    if (anchor < n) putSequence(anchor, n - anchor, 0, 0);
+}
+
+bool LZCodec::decompress(const char* in, size_t len, string& out) const {
+    size_t ip = 0;
+    uint64_t outLen = 0;
+    size_t shift = 0;
+    bool finished = false;
+    while (!finished && ip < len && shift < 64) {
+        finished = varenc::decodeVarint<uint64_t>(in[ip++], outLen, shift);
+    }
+    // Jedan ulazni bajt daje najvise ~255 izlaznih, pa ostecena duzina ne moze da trazi gigabajte
+    if (!finished || outLen / 255 > len) return false;
+
+    out.resize(outLen);
+    char* dst = out.empty() ? nullptr : &out[0];
+    size_t op = 0;
+
+    auto getLength = [&](size_t& length) {
+        uint8_t b;
+        do {
+            if (ip >= len) return false;
+            b = static_cast<uint8_t>(in[ip++]);
+            length += b;
+        } while (b == 255);
+        return true;
+    };
+
+    while (op < outLen) {
+        if (ip >= len) return false;
+        uint8_t token = static_cast<uint8_t>(in[ip++]);
+
+        size_t literalLen = token >> 4;
+        if (literalLen == 15 && !getLength(literalLen)) return false;
+        if (literalLen > len - ip || literalLen > outLen - op) return false;
+        memcpy(dst + op, in + ip, literalLen);
+        ip += literalLen;
+        op += literalLen;
+        if (op == outLen) break;
+
+        if (len - ip < 2) return false;
+        size_t offset = static_cast<uint8_t>(in[ip]) | (static_cast<size_t>(static_cast<uint8_t>(in[ip + 1])) << 8);
+        ip += 2;
+
+        size_t matchLen = token & 0x0F;
+        if (matchLen == 15 && !getLength(matchLen)) return false;
+        matchLen += MIN_MATCH;
+        if (offset == 0 || offset > op || matchLen > outLen - op) return false;
+
+        const char* from = dst + op - offset;
+        if (offset >= matchLen) {
+            memcpy(dst + op, from, matchLen);
+        }
+        else {
+            // Poklapanje preklapa samo sebe (ponavljanje kraceg niza), kopiramo bajt po bajt
+            for (size_t i = 0; i < matchLen; ++i) dst[op + i] = from[i];
+        }
+        op += matchLen;
+    }
+
+    return ip == len;
+}
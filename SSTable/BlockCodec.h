@@ -0,0 +1,63 @@
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/*
+    * Kodeci za kompresiju data blokova SSTabele (blok format).
+    *
+    * Svaki blok na disku u trailer-u nosi ID kodeka kojim je zapisan, pa citanje ne zavisi
+    * od Config-a, a jedna tabela moze imati blokove razlicitih kodeka (blok koji se ne
+    * isplati kompresovati ostaje nekompresovan). Nov kodek je nova klasa i nov CodecId u byId.
+*/
+enum class CodecId : uint8_t {
+    None = 0,
+    LZ = 1
+};
+
+class BlockCodec {
+public:
+    virtual ~BlockCodec() = default;
+
+    virtual CodecId id() const = 0;
+    virtual const char* name() const = 0;
+
+    // out dobija kompresovan sadrzaj in
+    virtual void compress(const std::string& in, std::string& out) const = 0;
+    // false ako zapis nije ispravan (ostecen blok)
+    virtual bool decompress(const char* in, size_t len, std::string& out) const = 0;
+
+    // nullptr za nepoznat ID ili ime
+    static const BlockCodec* byId(uint8_t id);
+    static const BlockCodec* byName(const std::string& name);
+};
+
+class NoCodec : public BlockCodec {
+public:
+    CodecId id() const override { return CodecId::None; }
+    const char* name() const override { return "none"; }
+    void compress(const std::string& in, std::string& out) const override;
+    bool decompress(const char* in, size_t len, std::string& out) const override;
+};
+
+/*
+    * LZ77 kodek u stilu LZ4, bez spoljnih zavisnosti.
+    *   zapis:     [varint duzina originala] sekvenca*
+    *   sekvenca:  [token] [duzina literala 255...] [literali] [uint16 offset] [duzina poklapanja 255...]
+    * Gornja 4 bita tokena su duzina literala, donja 4 duzina poklapanja - 4 (15 znaci da se nastavlja
+    * bajtovima 255 do prvog manjeg). Poslednja sekvenca ima samo literale.
+    * Poklapanja se traze hes tabelom od 4 bajta, pa je kompresija jedan prolaz, a dekompresija kopiranje.
+*/
+class LZCodec : public BlockCodec {
+public:
+    CodecId id() const override { return CodecId::LZ; }
+    const char* name() const override { return "lz"; }
+    void compress(const std::string& in, std::string& out) const override;
+    bool decompress(const char* in, size_t len, std::string& out) const override;
+
+private:
+    static constexpr size_t MIN_MATCH = 4;
+    static constexpr size_t MAX_OFFSET = 65535;
+    static constexpr int HASH_BITS = 12;
+};
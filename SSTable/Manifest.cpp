@@ -0,0 +1,267 @@
+#include "Manifest.h"
+#include "../MurmurHash3/MurmurHash3.h"
+#include <fstream>
+#include <filesystem>
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+
+namespace fs = std::filesystem;
+
+Manifest::Manifest(const std::string& path, uint64_t maxSize) : path_(path), maxSize_(maxSize) {}
+
+uint32_t Manifest::checksum(const std::string& payload) {
+    uint32_t hash = 0;
+    MurmurHash3_x86_32(payload.data(), static_cast<int>(payload.size()), 0, &hash);
+    return hash;
+}
+
+std::string Manifest::encode(const VersionEdit& edit) {
+    std::string payload;
+
+    auto append_field = [&](const void* data, size_t len) {
+        payload.append(reinterpret_cast<const char*>(data), len);
+    };
+    auto append_string = [&](const std::string& s) {
+        uint32_t len = s.size();
+        append_field(&len, sizeof(len));
+        payload.append(s);
+    };
+
+    uint32_t added = edit.added.size();
+    append_field(&added, sizeof(added));
+    for (const TableMeta& t : edit.added) {
+        int32_t level = t.level, id = t.id;
+        uint8_t flags = (t.compressed ? 1 : 0) | (t.single_file ? 2 : 0); // isti raspored kao TOC flags
+        if (!t.vlog_refs.empty()) flags |= 4; // posle max kljuca slede segmenti value loga
+        append_field(&level, sizeof(level));
+        append_field(&id, sizeof(id));
+        append_field(&flags, sizeof(flags));
+        append_field(&t.size, sizeof(t.size));
+        append_field(&t.entry_count, sizeof(t.entry_count));
+        append_string(t.min_key);
+        append_string(t.max_key);
+        if (!t.vlog_refs.empty()) {
+            uint32_t refs = t.vlog_refs.size();
+            append_field(&refs, sizeof(refs));
+            for (const auto& ref : t.vlog_refs) {
+                append_field(&ref.first, sizeof(ref.first));
+                append_field(&ref.second, sizeof(ref.second));
+            }
+        }
+    }
+
+    uint32_t removed = edit.removed.size();
+    append_field(&removed, sizeof(removed));
+    for (const auto& r : edit.removed) {
+        int32_t level = r.first, id = r.second;
+        append_field(&level, sizeof(level));
+        append_field(&id, sizeof(id));
+    }
+
+    // Stari zapisi se zavrsavaju posle uklonjenih tabela, next_id imaju samo snapshot-i
+    if (edit.next_id >= 0) {
+        int32_t next_id = edit.next_id;
+        append_field(&next_id, sizeof(next_id));
+    }
+
+    return payload;
+}
+
+std::string Manifest::encodeRecord(const VersionEdit& edit) {
+    std::string payload = encode(edit);
+    uint32_t header[2] = { checksum(payload), static_cast<uint32_t>(payload.size()) };
+
+    std::string record(reinterpret_cast<const char*>(header), sizeof(header));
+    record.append(payload);
+    return record;
+}
+
+bool Manifest::decode(const std::string& payload, VersionEdit& edit) {
+    size_t pos = 0;
+
+    auto read_field = [&](void* dst, size_t len) {
+        if (pos + len > payload.size()) return false;
+        std::memcpy(dst, payload.data() + pos, len);
+        pos += len;
+        return true;
+    };
+    auto read_string = [&](std::string& s) {
+        uint32_t len;
+        if (!read_field(&len, sizeof(len)) || pos + len > payload.size()) return false;
+        s.assign(payload, pos, len);
+        pos += len;
+        return true;
+    };
+
+    uint32_t added;
+    if (!read_field(&added, sizeof(added))) return false;
+    for (uint32_t i = 0; i < added; ++i) {
+        TableMeta t;
+        int32_t level, id;
+        uint8_t flags;
+        if (!read_field(&level, sizeof(level)) || !read_field(&id, sizeof(id)) ||
+            !read_field(&flags, sizeof(flags)) || !read_field(&t.size, sizeof(t.size)) ||
+            !read_field(&t.entry_count, sizeof(t.entry_count)) ||
+            !read_string(t.min_key) || !read_string(t.max_key)) {
+            return false;
+        }
+        if (flags & 4) {
+            uint32_t refs;
+            if (!read_field(&refs, sizeof(refs))) return false;
+            for (uint32_t r = 0; r < refs; ++r) {
+                std::pair<uint32_t, uint64_t> ref;
+                if (!read_field(&ref.first, sizeof(ref.first)) || !read_field(&ref.second, sizeof(ref.second))) return false;
+                t.vlog_refs.push_back(ref);
+            }
+        }
+        t.level = level;
+        t.id = id;
+        t.compressed = flags & 1;
+        t.single_file = flags & 2;
+        edit.added.push_back(std::move(t));
+    }
+
+    uint32_t removed;
+    if (!read_field(&removed, sizeof(removed))) return false;
+    for (uint32_t i = 0; i < removed; ++i) {
+        int32_t level, id;
+        if (!read_field(&level, sizeof(level)) || !read_field(&id, sizeof(id))) return false;
+        edit.removed.emplace_back(level, id);
+    }
+
+    if (pos < payload.size()) {
+        int32_t next_id;
+        if (!read_field(&next_id, sizeof(next_id)) || next_id < 0) return false;
+        edit.next_id = next_id;
+    }
+
+    return pos == payload.size();
+}
+
+void Manifest::apply(const VersionEdit& edit, std::map<int, std::vector<TableMeta>>& levels, int& nextId) {
+    for (const auto& r : edit.removed) {
+        auto& tables = levels[r.first];
+        tables.erase(std::remove_if(tables.begin(), tables.end(),
+            [&](const TableMeta& t) { return t.id == r.second; }), tables.end());
+    }
+    for (const TableMeta& t : edit.added) {
+        levels[t.level].push_back(t);
+        nextId = std::max(nextId, t.id + 1);
+    }
+    nextId = std::max(nextId, edit.next_id);
+}
+
+bool Manifest::replay(std::map<int, std::vector<TableMeta>>& levels, int& nextId) {
+    levels.clear();
+    nextId = 0;
+
+    std::ifstream in(path_, std::ios::binary);
+    if (!in.is_open()) return false;
+
+    std::error_code ec;
+    uint64_t file_size = fs::file_size(path_, ec);
+    if (ec) file_size = 0;
+
+    uint64_t valid_end = 0;
+    size_t edits = 0;
+
+    while (true) {
+        uint32_t header[2]; // checksum, duzina
+        if (!in.read(reinterpret_cast<char*>(header), sizeof(header))) break;
+
+        // Duzina iz prekinutog ili ostecenog zaglavlja moze biti bilo sta; ne alociramo vise nego sto fajl ima
+        if (header[1] > file_size - valid_end - sizeof(header)) break;
+
+        std::string payload(header[1], '\0');
+        if (!in.read(&payload[0], header[1])) break;
+
+        VersionEdit edit;
+        if (checksum(payload) != header[0] || !decode(payload, edit)) break;
+
+        apply(edit, levels, nextId);
+
+        valid_end += sizeof(header) + header[1];
+        edits++;
+    }
+    in.close();
+
+    // Upis je prekinut usred zapisa: odbacujemo ga, da bi sledeci zapis isao odmah iza poslednjeg ispravnog
+    if (file_size > valid_end) {
+        std::cerr << "[Manifest] Odbacujem nepotpun zapis na kraju " << path_
+            << " (" << (file_size - valid_end) << " bajtova)\n";
+        fs::resize_file(path_, valid_end, ec);
+    }
+
+    for (auto it = levels.begin(); it != levels.end();) {
+        if (it->second.empty()) it = levels.erase(it);
+        else ++it;
+    }
+
+    levels_ = levels;
+    nextId_ = nextId;
+    size_ = valid_end;
+
+    std::cout << "[Manifest] Ucitano " << edits << " izmena iz " << path_ << "\n";
+    return true;
+}
+
+bool Manifest::append(const VersionEdit& edit) {
+    // Ceo zapis u jednom write-u pa flush
+    std::string record = encodeRecord(edit);
+
+    std::ofstream out(path_, std::ios::binary | std::ios::app);
+    if (!out.is_open()) {
+        std::cerr << "[Manifest] Ne mogu da otvorim " << path_ << " za upis\n";
+        return false;
+    }
+    out.write(record.data(), record.size());
+    out.flush();
+
+    if (!out) {
+        std::cerr << "[Manifest] Greska pri upisu u " << path_ << "\n";
+        return false;
+    }
+    out.close();
+
+    apply(edit, levels_, nextId_);
+    size_ += record.size();
+
+    // Izmena je vec upisana; ako snapshot ne uspe, ostaje stari fajl pa se pokusava posle sledece izmene
+    // Velika verzija bi se inace prepisivala posle svake izmene
+    if (size_ > maxSize_ && size_ > 2 * snapshotSize_) rollOver();
+    return true;
+}
+
+bool Manifest::rollOver() {
+    VersionEdit snapshot;
+    for (const auto& level : levels_) {
+        snapshot.added.insert(snapshot.added.end(), level.second.begin(), level.second.end());
+    }
+    snapshot.next_id = nextId_;
+    std::string record = encodeRecord(snapshot);
+
+    // Novi fajl zamenjuje stari tek kada je ceo upisan; posle pada ostaje ili stari ili novi MANIFEST
+    const std::string tmp = path_ + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        out.write(record.data(), record.size());
+        out.flush();
+        if (!out) {
+            std::cerr << "[Manifest] Ne mogu da upisem snapshot u " << tmp << "\n";
+            return false;
+        }
+    }
+
+    std::error_code ec;
+    fs::rename(tmp, path_, ec);
+    if (ec) {
+        std::cerr << "[Manifest] Ne mogu da zamenim " << path_ << " snapshot-om: " << ec.message() << "\n";
+        fs::remove(tmp, ec);
+        return false;
+    }
+
+    std::cout << "[Manifest] " << path_ << " zamenjen snapshot-om (" << snapshot.added.size() << " tabela)\n";
+    size_ = snapshotSize_ = record.size();
+    return true;
+}
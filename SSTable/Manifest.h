@@ -0,0 +1,74 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+#include <utility>
+#include <cstdint>
+
+// Opis jedne SSTabele u MANIFEST-u
+struct TableMeta {
+    int level = 0;
+    int id = 0;
+    bool single_file = false;
+    bool compressed = false;
+    std::string min_key;
+    std::string max_key;
+    uint64_t size = 0;        // ukupno bajtova na disku
+    uint64_t entry_count = 0; // 0 = nepoznato (tabela preuzeta skeniranjem direktorijuma)
+    // Segmenti value loga na koje tabela pokazuje: (ID segmenta, bajtova vrednosti u njemu)
+    std::vector<std::pair<uint32_t, uint64_t>> vlog_refs;
+};
+
+// Jedna izmena skupa tabela: flush dodaje tabelu, kompakcija dodaje novu i uklanja ulazne
+struct VersionEdit {
+    std::vector<TableMeta> added;
+    std::vector<std::pair<int, int>> removed; // (nivo, id)
+    int next_id = -1; // samo u snapshot zapisu: sledeci ID, jer najveci ID ne mora vise biti medju tabelama
+
+    bool empty() const { return added.empty() && removed.empty(); }
+};
+
+/**
+ * MANIFEST - append-only log izmena skupa SSTabela po nivoima.
+ *
+ * Zapis: [uint32 checksum][uint32 duzina][payload], checksum je MurmurHash3 nad payload-om.
+ * Cela izmena je jedan zapis, pa se na disku vidi ili cela ili nikako: replay staje na prvom
+ * nepotpunom ili ostecenom zapisu i skracuje fajl na poslednji ispravan.
+ *
+ * Kada fajl predje maxSize (i bar dva puta je veci od poslednjeg snapshot-a), trenutna verzija
+ * se upisuje kao jedan snapshot zapis u novi fajl, koji rename-om zamenjuje stari. Replay tako ne raste sa brojem izmena od pocetka baze.
+ */
+class Manifest {
+public:
+    static constexpr uint64_t DEFAULT_MAX_SIZE = 4 * 1024 * 1024;
+
+    explicit Manifest(const std::string& path, uint64_t maxSize = DEFAULT_MAX_SIZE);
+
+    // Ponavlja sve izmene i puni tabele po nivoima. Vraca false ako MANIFEST ne postoji.
+    bool replay(std::map<int, std::vector<TableMeta>>& levels, int& nextId);
+
+    bool append(const VersionEdit& edit);
+
+    const std::string& path() const { return path_; }
+
+private:
+    std::string path_;
+    uint64_t maxSize_;
+    uint64_t size_ = 0; // bajtova u fajlu posle poslednjeg replay-a ili upisa
+    uint64_t snapshotSize_ = 0; // velicina poslednjeg snapshot-a
+
+    // Verzija posle svih izmena, za snapshot
+    std::map<int, std::vector<TableMeta>> levels_;
+    int nextId_ = 0;
+
+    static void apply(const VersionEdit& edit, std::map<int, std::vector<TableMeta>>& levels, int& nextId);
+    // [checksum][duzina][payload] jedne izmene
+    static std::string encodeRecord(const VersionEdit& edit);
+    // Zamenjuje fajl novim koji ima samo snapshot trenutne verzije
+    bool rollOver();
+
+    static std::string encode(const VersionEdit& edit);
+    static bool decode(const std::string& payload, VersionEdit& edit);
+    static uint32_t checksum(const std::string& payload);
+};
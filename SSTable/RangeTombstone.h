@@ -0,0 +1,72 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <set>
+#include <algorithm>
+#include <cstdint>
+
+/**
+ * RangeTombstone - brisanje svih kljuceva iz [begin, end) (System::deleteRange).
+ *
+ * Brise samo zapise starije od njega (timestamp < timestamp brisanja), pa kasniji put u opseg
+ * ponovo vazi. Cuva se u memtable, a pri flush-u u filter delu SSTabele (TOC_VERSION_RANGE_TOMBSTONES);
+ * kompakcija izbacuje pokrivene zapise, a samo brisanje prenosi u izlaznu tabelu (osim na poslednjem nivou).
+ *
+ * Lista brisanja se drzi sredjena (coalesceRangeTombstones): sortirani opsezi koji se ne preklapaju,
+ * svaki sa najnovijim timestamp-om brisanja za svoje kljuceve.
+ */
+struct RangeTombstone {
+    std::string begin;
+    std::string end;
+    uint64_t timestamp = 0;
+
+    bool covers(const std::string& key) const { return begin <= key && key < end; }
+};
+
+// Preklopljena brisanja deli na granicama opsega i svakom delu daje najveci timestamp koji ga pokriva;
+// susedni delovi sa istim timestamp-om se spajaju. Za svaki kljuc coveringTimestamp ostaje isti.
+inline void coalesceRangeTombstones(std::vector<RangeTombstone>& tombstones) {
+    struct Edge {
+        std::string key;
+        uint64_t timestamp;
+        bool begin;
+    };
+    std::vector<Edge> edges;
+    edges.reserve(tombstones.size() * 2);
+    for (const RangeTombstone& t : tombstones) {
+        if (!(t.begin < t.end)) continue; // prazan opseg ne brise nista
+        edges.push_back(Edge{ t.begin, t.timestamp, true });
+        edges.push_back(Edge{ t.end, t.timestamp, false });
+    }
+    std::sort(edges.begin(), edges.end(), [](const Edge& a, const Edge& b) { return a.key < b.key; });
+
+    std::vector<RangeTombstone> out;
+    std::multiset<uint64_t> active;
+    std::string start;
+    uint64_t current = 0;
+    for (size_t i = 0; i < edges.size();) {
+        const std::string key = edges[i].key;
+        for (; i < edges.size() && edges[i].key == key; ++i) {
+            if (edges[i].begin) active.insert(edges[i].timestamp);
+            else active.erase(active.find(edges[i].timestamp));
+        }
+
+        uint64_t ts = active.empty() ? 0 : *active.rbegin();
+        if (ts == current) continue;
+        if (current > 0) out.push_back(RangeTombstone{ start, key, current });
+        start = key;
+        current = ts;
+    }
+    tombstones = std::move(out);
+}
+
+// Najnoviji timestamp brisanja opsega koje pokriva kljuc, 0 ako ga nema.
+// Lista mora biti sredjena sa coalesceRangeTombstones, pa je dovoljna binarna pretraga.
+inline uint64_t coveringTimestamp(const std::vector<RangeTombstone>& tombstones, const std::string& key) {
+    auto it = std::upper_bound(tombstones.begin(), tombstones.end(), key,
+        [](const std::string& k, const RangeTombstone& t) { return k < t.begin; });
+    if (it == tombstones.begin()) return 0;
+    --it;
+    return it->covers(key) ? it->timestamp : 0;
+}
@@ -2,6 +2,9 @@
 #include <fstream>
 #include <iostream>
 #include <stdexcept>
+#include <algorithm>
+#include <atomic>
+#include <thread>
 #include "SSTManager.h"
 #include "SSTable.h"
 #include "SSTableComp.h"
@@ -12,37 +15,32 @@ namespace fs = std::filesystem;
 
 using ull = unsigned long long;
 
-SSTManager::SSTManager(Block_manager* bmRef) : directory_(Config::data_directory), bm(bmRef), block_size(Config::block_size) {
+SSTManager::SSTManager(Block_manager* bmRef) : directory_(Config::data_directory), key_map_loaded_(false), bm(bmRef),
+    block_size(Config::block_size), manifest_(Config::data_directory + "/MANIFEST"), nextFileId_(0),
+    vlog_(Config::data_directory + "/vlog"), editOpen_(false) {
     cout << Config::data_directory << endl;
-    readMap();
+    loadVersion();
 }
 
 Block_manager* SSTManager::get_block_manager() {
     return bm;
 }
 
-std::unordered_map<std::string, uint32_t>& SSTManager::get_key_to_id_map() {
-    return key_map;
+SSTManager::~SSTManager()
+{
 }
 
-std::vector<std::string>& SSTManager::get_id_to_key_map() {
+const vector<string>& SSTManager::legacyKeys() {
+    if (!key_map_loaded_) {
+        key_map_loaded_ = true;
+        readMap();
+    }
     return id_to_key;
 }
 
-uint32_t& SSTManager::get_next_id() {
-    return next_ID_map;
-}
-
-SSTManager::~SSTManager()
-{
-    writeMap();
-}
-
 void SSTManager::readMap() {
     string key_map_file = directory_ + "/key_map";
 
-    next_ID_map = 0;
-
     uint64_t fileOffset = 0;
 
     uint64_t count;
@@ -51,7 +49,6 @@ void SSTManager::readMap() {
     };
     std::cout << "count: " << count << std::endl;
 
-    key_map.reserve(count);
     id_to_key.reserve(count);
 
     int i = 0;
@@ -66,167 +63,291 @@ void SSTManager::readMap() {
             return;
         };
 
-        key_map[key] = i;
         id_to_key.emplace_back(key);
     }
-    next_ID_map = i + 1;
 }
 
-void SSTManager::writeMap() const {
+std::vector<SSTManager::TableFiles> SSTManager::scanLevel(int level) const {
+    string path = directory_ + "/level_" + to_string(level) + "/";
+    std::vector<TableFiles> tables;
 
-    string key_map_file = directory_ + "/key_map";
+    // ne postoji level direktorijum ili nije direktorijum
+    if (!fs::exists(path) || !fs::is_directory(path)) {
+        return tables;
+    }
+
+    std::vector<std::pair<int, TableFiles>> found;
+
+    // sstable_sf_raw_0.db / sstable_sf_comp_0.db -> single file
+    // data_raw_0.db / data_comp_0.db -> multi file, ostali fajlovi imaju isti nastavak
+    for (const auto& entry : fs::directory_iterator(path)) {
+        if (!entry.is_regular_file()) continue;
+
+        string filename = entry.path().filename().string();
+        TableMeta info;
+        info.level = level;
 
-    string payload = "";
+        if (filename.rfind("sstable_", 0) == 0) {
+            info.single_file = true;
+        }
+        else if (filename.rfind("data_", 0) == 0) {
+            info.single_file = false;
+        }
+        else continue;
 
-    uint64_t count = key_map.size();
+        info.compressed = filename.find("_raw_") == std::string::npos;
 
-    payload.append(reinterpret_cast<const char*>(&count), sizeof(count));
+        std::size_t underscorePos = filename.rfind('_');
+        std::size_t dotPos = filename.find('.', underscorePos);
+        try {
+            info.id = std::stoi(filename.substr(underscorePos + 1, dotPos - underscorePos - 1));
+        }
+        catch (const std::exception&) {
+            cerr << "[SSTManager] Ne validan format: " << filename << "\n";
+            continue;
+        }
 
-    for(string key : id_to_key) {
-        uint64_t len = key.size();
-        payload.append(reinterpret_cast<const char*>(&len), sizeof(len));
-        payload.append(key);
+        found.emplace_back(info.id, filesFor(info));
     }
 
-    int block_id = 0;
-    uint64_t total_bytes = payload.size();
-    uint64_t offset = 0;
+    // Redosled po ID-u, isti kao redosled upisa
+    std::sort(found.begin(), found.end(),
+        [](const auto& a, const auto& b) { return a.first < b.first; });
+
+    tables.reserve(found.size());
+    for (auto& f : found) tables.push_back(std::move(f.second));
 
-    while (offset + block_size <= total_bytes) {
-        string chunk = payload.substr(offset, block_size);
-        bm->write_block({ block_id++, key_map_file }, chunk);
-        offset += block_size;
+    return tables;
+}
+
+SSTManager::TableFiles SSTManager::filesFor(const TableMeta& info) const {
+    std::string levelDir = directory_ + "/level_" + std::to_string(info.level);
+    std::string numStr = std::to_string(info.id);
+    TableFiles files;
+    files.info = info;
+
+    if (info.single_file) {
+        std::string type_str = info.compressed ? "_sf_comp_" : "_sf_raw_";
+        files.data = levelDir + "/sstable" + type_str + numStr + ".db";
+        files.index = files.filter = files.summary = files.meta = files.data;
     }
+    else {
+        std::string type_str = info.compressed ? "_comp_" : "_raw_";
+        std::string extension = ".db";
 
-    if (offset < total_bytes) {
-        std::string chunk = payload.substr(offset);
-        bm->write_block({ block_id++, key_map_file }, chunk);
+        files.data = levelDir + "/data" + type_str + numStr + extension;
+        files.index = levelDir + "/index" + type_str + numStr + extension;
+        files.filter = levelDir + "/filter" + type_str + numStr + extension;
+        files.summary = levelDir + "/summary" + type_str + numStr + extension;
+        files.meta = levelDir + "/meta" + type_str + numStr + extension;
     }
+    return files;
 }
 
-// pomocna funkcija za pronalazenje sledeceg ID-a
-int SSTManager::findNextIndex(const std::string& levelDir) const {
-    int max_id = -1;
-    if (!fs::exists(levelDir) || !fs::is_directory(levelDir)) {
-        return 0; // prvi fajl ce biti sa ID-em 0
+uint64_t SSTManager::filesSize(const TableFiles& files) {
+    std::error_code ec;
+    if (files.info.single_file) {
+        uint64_t size = fs::file_size(files.data, ec);
+        return ec ? 0 : size;
     }
 
-    int digit, base=1, current;
+    uint64_t total = 0;
+    for (const std::string* path : { &files.data, &files.index, &files.filter, &files.summary, &files.meta }) {
+        uint64_t size = fs::file_size(*path, ec);
+        if (!ec) total += size;
+    }
+    return total;
+}
 
-    for (const auto& entry : fs::directory_iterator(levelDir)) {
-        std::string filename = entry.path().filename().string();
-        current = 0;
-        base = 1;
+void SSTManager::loadVersion() {
+    std::map<int, std::vector<TableMeta>> version;
 
-        for(int i = filename.size()-1; i >= 0; i--) {
-            if (isdigit(filename[i])) {
-                // pronasli smo poslednji broj u nazivu fajla
-                digit = std::stoi(filename.substr(i, 1));
-				current += base * digit;
-                base *= 10;
+    if (manifest_.replay(version, nextFileId_)) {
+        for (const auto& level : version) {
+            std::vector<TableFiles>& tables = levels_[level.first];
+            for (const TableMeta& info : level.second) {
+                tables.push_back(filesFor(info));
             }
-		}
-		max_id = max(max_id, current);
+        }
+        return;
+    }
+
+    // Direktorijum bez MANIFEST-a (upisan pre nego sto je MANIFEST postojao):
+    // tabele nalazimo skeniranjem nivoa i upisujemo ih kao prvu izmenu
+    VersionEdit snapshot;
+    for (int level = 1; level <= Config::max_levels; level++) {
+        std::vector<TableFiles> tables = scanLevel(level);
+
+        for (TableFiles& files : tables) {
+            std::shared_ptr<SSTable> sst = openTable(files);
+            files.info.min_key = sst->getSummaryMin();
+            files.info.max_key = sst->getSummaryMax();
+            files.info.size = filesSize(files);
+            snapshot.added.push_back(files.info);
+            nextFileId_ = std::max(nextFileId_, files.info.id + 1);
+        }
+
+        if (!tables.empty()) levels_[level] = std::move(tables);
+    }
+
+    manifest_.append(snapshot);
+}
+
+std::vector<SSTManager::TableFiles>& SSTManager::levelTables(int level) {
+    return levels_[level];
+}
+
+const SSTManager::LevelRanges& SSTManager::rangesFor(int level) {
+    auto it = levelRanges_.find(level);
+    if (it != levelRanges_.end()) return it->second;
+
+    const std::vector<TableFiles>& tables = levelTables(level);
+    LevelRanges ranges;
+    ranges.byMin.resize(tables.size());
+    for (size_t i = 0; i < tables.size(); ++i) ranges.byMin[i] = i;
+
+    std::sort(ranges.byMin.begin(), ranges.byMin.end(),
+        [&](size_t a, size_t b) { return tables[a].info.min_key < tables[b].info.min_key; });
+
+    for (size_t i = 1; i < ranges.byMin.size(); ++i) {
+        if (tables[ranges.byMin[i - 1]].info.max_key >= tables[ranges.byMin[i]].info.min_key) {
+            ranges.disjoint = false;
+            break;
+        }
     }
-    return max_id + 1;
+
+    return levelRanges_.emplace(level, std::move(ranges)).first->second;
+}
+
+std::vector<int> SSTManager::getLevels() const {
+    std::vector<int> levels;
+    for (const auto& level : levels_) {
+        if (!level.second.empty()) levels.push_back(level.first);
+    }
+    return levels;
+}
+
+std::vector<TableMeta> SSTManager::getLevelMeta(int level) {
+    std::vector<TableMeta> meta;
+    for (const TableFiles& files : levelTables(level)) {
+        meta.push_back(files.info);
+    }
+    return meta;
+}
+
+void SSTManager::logEdit(VersionEdit& edit) {
+    if (edit.empty()) return;
+
+    if (editOpen_) {
+        pendingEdit_.added.insert(pendingEdit_.added.end(), edit.added.begin(), edit.added.end());
+        pendingEdit_.removed.insert(pendingEdit_.removed.end(), edit.removed.begin(), edit.removed.end());
+        return;
+    }
+
+    if (!manifest_.append(edit)) {
+        cerr << "[SSTManager] Izmena nije upisana u MANIFEST\n";
+    }
+}
+
+void SSTManager::beginEdit() {
+    editOpen_ = true;
+}
+
+bool SSTManager::commitEdit() {
+    editOpen_ = false;
+
+    bool logged = pendingEdit_.empty() || manifest_.append(pendingEdit_);
+    if (logged) {
+        for (const TableFiles& files : pendingDeletes_) {
+            deleteTableFiles(files);
+        }
+    }
+    else {
+        // Ulazi ostaju na disku; bez zapisa u MANIFEST-u posle restarta i dalje vaze
+        cerr << "[SSTManager] Izmena nije upisana u MANIFEST, ulazne tabele se ne brisu\n";
+    }
+
+    pendingEdit_ = VersionEdit{};
+    pendingDeletes_.clear();
+    return logged;
+}
+
+std::unique_ptr<SSTable> SSTManager::createTable(const TableFiles& files) {
+    if (files.info.compressed) {
+        auto legacy = [this]() -> const vector<string>& { return legacyKeys(); };
+        if (files.info.single_file) {
+            return std::make_unique<SSTableComp>(files.data, bm, legacy);
+        }
+        return std::make_unique<SSTableComp>(files.data, files.index, files.filter, files.summary, files.meta,
+            bm, legacy);
+    }
+
+    if (files.info.single_file) {
+        return std::make_unique<SSTableRaw>(files.data, bm);
+    }
+    return std::make_unique<SSTableRaw>(files.data, files.index, files.filter, files.summary, files.meta, bm);
+}
+
+std::shared_ptr<SSTable> SSTManager::openTable(const TableFiles& files) {
+    auto it = openTableIndex_.find(files.data);
+    if (it != openTableIndex_.end()) {
+        // Pomeramo na pocetak liste (najskorije koriscena)
+        openTables_.splice(openTables_.begin(), openTables_, it->second);
+        return it->second->second;
+    }
+
+    std::shared_ptr<SSTable> table = createTable(files);
+    table->prepare();
+
+    openTables_.emplace_front(files.data, table);
+    openTableIndex_[files.data] = openTables_.begin();
+
+    size_t capacity = std::max(1, Config::max_open_tables);
+    while (openTables_.size() > capacity) {
+        openTableIndex_.erase(openTables_.back().first);
+        openTables_.pop_back();
+    }
+
+    return table;
+}
+
+void SSTManager::evictTable(const std::string& dataPath) {
+    auto it = openTableIndex_.find(dataPath);
+    if (it == openTableIndex_.end()) return;
+
+    openTables_.erase(it->second);
+    openTableIndex_.erase(it);
 }
 
 optional<string> SSTManager::get_from_level(const std::string& key, bool& deleted, int level)
 {
     deleted = false;
-    string current_directory = Config::data_directory + "/level_" + to_string(level) + "/";
-    cout << "current_directory == " << current_directory << endl;
 
-    if (!fs::is_directory(current_directory)) {
-        cout << "[SSTManager] Error get_from_level " << current_directory << " is not valid directory\n\n";
-        return nullopt;
-    }
+    // Spisak tabela i otvorene tabele su u memoriji, nema skeniranja direktorijuma ni citanja TOC-a
+    const std::vector<TableFiles>& tables = levelTables(level);
+    if (tables.empty()) return nullopt;
 
-    if (!fs::exists(current_directory)) return nullopt;
+    // Tabele u [byMin.begin(), last) imaju min <= key. Ako se opsezi ne preklapaju,
+    // jedino poslednja od njih moze da sadrzi kljuc.
+    const LevelRanges& ranges = rangesFor(level);
+    auto last = std::upper_bound(ranges.byMin.begin(), ranges.byMin.end(), key,
+        [&](const std::string& k, size_t i) { return k < tables[i].info.min_key; });
+    auto first = (ranges.disjoint && last != ranges.byMin.begin()) ? last - 1 : ranges.byMin.begin();
 
     std::vector<Record> matches;
-	string data_path, index_path, filter_path, summary_path, meta_path;
+    uint64_t rangeDeleteTs = 0; // najnovije brisanje opsega na ovom nivou koje pokriva kljuc
 
-    for (const auto& entry : fs::directory_iterator(current_directory))
-    {
-        if (entry.is_regular_file()) {
-            std::string filename = entry.path().filename().string();
-            //cout << filename << endl;
-            // Prolazimo kroz sve multi-fajl sstabele (samo one ce imati zasebni filter fajl)
-            if (filename.rfind("filter", 0) == 0) {
-
-                std::size_t underscorePos = filename.rfind('_');
-                std::size_t dotPos = filename.find('.', underscorePos);
-
-                if (underscorePos == std::string::npos || dotPos == std::string::npos) {
-                    cerr << ("[SSTManager] Ne validan format: " + filename);
-                    continue;
-                }
+    for (auto it = first; it != last; ++it) {
+        const TableFiles& files = tables[*it];
+        if (key > files.info.max_key) continue; // Van opsega, Bloom filter ni ne otvaramo
 
-                std::string numStr = filename.substr(underscorePos + 1, dotPos - underscorePos - 1);
-                std::string ending = numStr + ".db";
-                
-                SSTable* sst;
-                string extension;
-
-                // nastavak je _comp_
-                if(Config::compress_sstable) {
-                    extension = "_comp_";
-				}
-                else {
-					extension = "_raw_";
-                }
+        std::shared_ptr<SSTable> sst = openTable(files);
+        rangeDeleteTs = std::max(rangeDeleteTs, coveringTimestamp(sst->rangeTombstones(), key));
 
-                data_path = current_directory + "data" + extension + ending;
-                index_path = current_directory + "index" + extension + ending;
-                filter_path = current_directory + "filter" + extension + ending;
-                summary_path = current_directory + "summary" + extension + ending;
-                meta_path = current_directory + "meta" + extension + ending;
-
-                if (Config::compress_sstable) {                    
-                    sst = new SSTableComp(data_path,
-                                            index_path,
-                                            filter_path,
-                                            summary_path,
-                                            meta_path,
-                                            bm, key_map, id_to_key, next_ID_map);
-                }
-                else {
-                    sst = new SSTableRaw(data_path,
-                                            index_path,
-                                            filter_path,
-                                            summary_path,
-                                            meta_path,
-                                            bm);
-                }
-
-                if (sst->possiblyContains(key)) {
-                    //Sve recorde sa odgovarajucim key-em stavljamo u vektor
-                    std::vector<Record> found = sst->get(key);
-                    matches.insert(matches.end(), found.begin(), found.end());
-                }
-            }
-            if (filename.rfind("sstable", 0) == 0 && Config::sstable_single_file==true)
-            {
-                
-                SSTable* sst;
-                data_path = current_directory + filename;
-
-                if (Config::compress_sstable) {
-                        sst = new SSTableComp(data_path, bm, key_map, id_to_key, next_ID_map);
-                    }
-                    else {
-
-                        sst = new SSTableRaw(data_path, bm);
-                    }
-
-                    //Sve recorde sa odgovarajucim key-em stavljamo u vektor
-                    if(sst->possiblyContains(key)) {
-                        std::vector<Record> found = sst->get(key);
-                        matches.insert(matches.end(), found.begin(), found.end());
-                    }
-
-            }
+        if (sst->possiblyContains(key)) {
+            //Sve recorde sa odgovarajucim key-em stavljamo u vektor
+            std::vector<Record> found = sst->get(key);
+            matches.insert(matches.end(), found.begin(), found.end());
         }
     }
 
@@ -243,20 +364,139 @@ optional<string> SSTManager::get_from_level(const std::string& key, bool& delete
     }
 
 
-    // not found. Return nullopt
-    if (tsMax == 0) return nullopt;
+    // not found. Brisanje opsega i dalje sakriva starije verzije na nizim nivoima
+    if (tsMax == 0) {
+        deleted = rangeDeleteTs > 0;
+        return nullopt;
+    }
 
-    // found. Record is deleted. Return nullopt + DELETED = TRUE
-    else if (static_cast<int>(rMax.tombstone) == 1)
+    // found. Record is deleted (sam ili brisanjem opsega). Return nullopt + DELETED = TRUE
+    else if (static_cast<int>(rMax.tombstone) == 1 || rMax.timestamp < rangeDeleteTs)
     {
         deleted = true;
         return nullopt;
     }
 
+    loadValue(rMax);
+
     // found. Return value 
     return rMax.value;
 }
 
+bool SSTManager::resolveValue(Record& r) const {
+    if ((r.tombstone & TOMBSTONE_VALUE_POINTER) == std::byte{ 0 }) return true;
+
+    std::string value;
+    if (!vlog_.read(r.value, value)) return false;
+
+    r.value = std::move(value);
+    r.value_size = r.value.size();
+    r.tombstone = std::byte{ 0 };
+    return true;
+}
+
+void SSTManager::loadValue(Record& r) const {
+    if (!resolveValue(r))
+        throw std::runtime_error("[SSTManager] Value of key '" + r.key + "' cannot be read from the value log.");
+}
+
+std::vector<std::pair<uint32_t, uint64_t>> SSTManager::valueLogRefs(const std::vector<Record>& records) {
+    std::map<uint32_t, uint64_t> bytes;
+    for (const Record& r : records) {
+        ValueLog::Pointer ptr;
+        if ((r.tombstone & TOMBSTONE_VALUE_POINTER) == std::byte{ 0 } || !ValueLog::decodePointer(r.value, ptr)) continue;
+        bytes[ptr.segment] += ptr.length;
+    }
+    return std::vector<std::pair<uint32_t, uint64_t>>(bytes.begin(), bytes.end());
+}
+
+void SSTManager::collectValueLogGarbage() {
+    if (editOpen_) return;
+
+    // Zivi bajtovi po segmentu, iz MANIFEST-a (tabele tekuce verzije)
+    std::map<uint32_t, uint64_t> live;
+    for (const auto& level : levels_) {
+        for (const TableFiles& files : level.second) {
+            for (const auto& ref : files.info.vlog_refs) live[ref.first] += ref.second;
+        }
+    }
+
+    // Segment na koji ne pokazuje nijedna tabela se samo brise
+    std::vector<uint32_t> unused;
+    for (const auto& seg : vlog_.segments()) {
+        if (seg.first != vlog_.activeSegment() && live.find(seg.first) == live.end()) unused.push_back(seg.first);
+    }
+    for (uint32_t id : unused) {
+        cout << std::dec << "[SSTManager] Value log segment " << id << " is unused, removing\n";
+        vlog_.removeSegment(id);
+    }
+
+    // Od ostalih biramo segment sa najvise mrtvih bajtova, ako ih ima bar value_log_gc_percent
+    uint32_t victim = 0;
+    uint64_t victimDead = 0;
+    for (const auto& seg : vlog_.segments()) {
+        if (seg.first == vlog_.activeSegment() || seg.second == 0) continue;
+
+        uint64_t liveBytes = std::min(live[seg.first], seg.second);
+        uint64_t dead = seg.second - liveBytes;
+        if (dead * 100 >= seg.second * (uint64_t)Config::value_log_gc_percent && dead > victimDead) {
+            victim = seg.first;
+            victimDead = dead;
+        }
+    }
+    if (victimDead == 0) return;
+
+    cout << std::dec << "[SSTManager] Value log GC: segment " << victim << " (" << victimDead << " dead bytes)\n";
+
+    // Tabele koje pokazuju na segment se prepisuju sa vrednostima procitanim iz njega;
+    // write ih ponovo salje u value log (aktivni segment) ako su i dalje iznad praga
+    for (int level : getLevels()) {
+        const std::vector<TableFiles>& files = levelTables(level);
+        std::vector<bool> refers(files.size(), false);
+        bool any = false;
+        for (size_t i = 0; i < files.size(); ++i) {
+            for (const auto& ref : files[i].info.vlog_refs) {
+                if (ref.first == victim) refers[i] = any = true;
+            }
+        }
+        if (!any) continue;
+
+        vector<unique_ptr<SSTable>> tables = getTablesFromLevel(level);
+        for (size_t i = 0; i < tables.size() && i < refers.size(); ++i) {
+            if (!refers[i]) continue;
+
+            std::vector<Record> records;
+            uint64_t offset = tables[i]->getDataStartOffset();
+            bool ok = true;
+            while (true) {
+                bool error = false, eof = false;
+                Record r = tables[i]->getNextRecord(offset, error, eof);
+                if (error) break;
+
+                ValueLog::Pointer ptr;
+                if ((r.tombstone & TOMBSTONE_VALUE_POINTER) != std::byte{ 0 } &&
+                    ValueLog::decodePointer(r.value, ptr) && ptr.segment == victim && !resolveValue(r)) {
+                    ok = false;
+                    break;
+                }
+                records.push_back(std::move(r));
+            }
+
+            // Tabela sa necitljivom vrednoscu ostaje, a sa njom i segment
+            if (!ok || records.empty()) return;
+
+            beginEdit();
+            write(std::move(records), level, tables[i]->rangeTombstones());
+            std::vector<unique_ptr<SSTable>> old;
+            old.push_back(std::move(tables[i]));
+            removeSSTables(old);
+            if (!commitEdit()) return;
+        }
+    }
+
+    vlog_.removeSegment(victim);
+}
+
 // pretrazuje sstable po nivoima. Kad naide na nekom nivou na kljuc, to vraca. Kad prodje sve nivoe, ne postoji kljuc, vraca nullopt
 optional<string> SSTManager::get(const std::string& key) {
     bool deleted;
@@ -271,11 +511,22 @@ optional<string> SSTManager::get(const std::string& key) {
     return nullopt;
 }
 
-void SSTManager::write(std::vector<Record> sortedRecords, int level) {
-    if (sortedRecords.empty()) {
+void SSTManager::write(std::vector<Record> sortedRecords, int level, std::vector<RangeTombstone> rangeTombstones) {
+    if (sortedRecords.empty() && rangeTombstones.empty()) {
         throw std::runtime_error("[SSTManager] Cannot write an SSTable with zero records.");
     }
 
+    // Tabela bez zapisa ne moze da se napravi, pa brisanje opsega nosi tombstone svog pocetka:
+    // isti kljuc i isti timestamp brisu tacno ono sto bi brisanje opsega obrisalo i inace
+    if (sortedRecords.empty()) {
+        Record r{};
+        r.key = rangeTombstones.front().begin;
+        r.key_size = r.key.size();
+        r.tombstone = TOMBSTONE_DELETED;
+        r.timestamp = rangeTombstones.front().timestamp;
+        sortedRecords.push_back(std::move(r));
+    }
+
     std::string levelDir = directory_ + "/level_" + std::to_string(level);
 
     // Osiguraj da direktorijum za nivo postoji
@@ -283,75 +534,59 @@ void SSTManager::write(std::vector<Record> sortedRecords, int level) {
         fs::create_directories(levelDir);
     }
 
-    int fileId = findNextIndex(levelDir);
+    TableMeta info;
+    info.level = level;
+    info.id = nextFileId_++;
+    info.single_file = Config::sstable_single_file;
+    info.compressed = Config::compress_sstable;
+
+    int fileId = info.id;
     cout << "\033[34m[SSTManager] Writing SSTable to level "
         << level << " with file ID: " << fileId << "\033[0m" << endl;
 
-    std::string numStr = std::to_string(fileId);
-
-    // Ovde treba da se handluje ako je jedan file
-    bool use_single_file = Config::sstable_single_file;
-    bool use_compression = Config::compress_sstable;
-
-    SSTable* sst = nullptr;
-    std::string data_path, index_path, filter_path, summary_path, meta_path;
-
-    if (use_single_file) {
-        std::string type_str = use_compression ? "_sf_comp_" : "_sf_raw_";
-        data_path = levelDir + "/sstable" + type_str + numStr + ".db";
-        index_path = filter_path = summary_path = meta_path = data_path;
-        std::cout << "[SSTManager] Creating a SINGLE-FILE SSTable: " << data_path << std::endl;
+    TableFiles files = filesFor(info);
+    if (info.single_file) {
+        std::cout << "[SSTManager] Creating a SINGLE-FILE SSTable: " << files.data << std::endl;
     }
     else {
-        std::string type_str = use_compression ? "_comp_" : "_raw_";
-        std::string extension = ".db";
+        std::cout << "[SSTManager] Creating a MULTI-FILE SSTable (ID: " << fileId << ")" << std::endl;
+    }
+
+    // Velike vrednosti idu u value log, tabela cuva samo pokazivac. Zapisi koji vec jesu
+    // pokazivaci (kompakcija) se prepisuju takvi kakvi su.
+    if (Config::value_log_threshold > 0) {
+        for (Record& r : sortedRecords) {
+            if (r.tombstone != std::byte{ 0 } || r.value.size() < (size_t)Config::value_log_threshold) continue;
 
-        data_path = levelDir + "/data" + type_str + numStr + extension;
-        index_path = levelDir + "/index" + type_str + numStr + extension;
-        filter_path = levelDir + "/filter" + type_str + numStr + extension;
-        summary_path = levelDir + "/summary" + type_str + numStr + extension;
-        meta_path = levelDir + "/meta" + type_str + numStr + extension;
-
-        std::cout << "[SSTManager] Creating a MULTI-FILE SSTable (ID: " << numStr << ")" << std::endl;
-
-    }
-
-    // TODO: PROVERITI DA LI TREBA I SINGLE FILE DA SE SALJE U CONSTRUCTOR I KOD COMP I KOD RAW
-    if (use_compression) {
-        if(use_single_file) {
-            sst = new SSTableComp(data_path, bm, key_map, id_to_key, next_ID_map);
-        } else {
-            sst = new SSTableComp(
-                data_path,
-                index_path,
-                filter_path,
-                summary_path,
-                meta_path,
-                bm,
-                key_map,
-                id_to_key,
-                next_ID_map
-            );
+            r.value = vlog_.append(r.key, r.value);
+            r.value_size = r.value.size();
+            r.tombstone = TOMBSTONE_VALUE_POINTER;
         }
+        vlog_.flush();
     }
-    else {
-        if(use_single_file) {
-            sst = new SSTableRaw(data_path, bm);
-        } else {
-            sst = new SSTableRaw(
-                data_path,
-                index_path,
-                filter_path,
-                summary_path,
-                meta_path,
-                bm
-            );
-        }
+    files.info.vlog_refs = valueLogRefs(sortedRecords);
+
+    std::unique_ptr<SSTable> table = createTable(files);
+    table->setRangeTombstones(rangeTombstones);
+    table->build(sortedRecords);
+
+    // build sortira zapise ako vec nisu sortirani. Opseg tabele u MANIFEST-u obuhvata i brisanja
+    // opsega, da bi get i kompakcija videli tabelu i za kljuceve koje ona samo brise.
+    files.info.min_key = sortedRecords.front().key;
+    files.info.max_key = sortedRecords.back().key;
+    for (const RangeTombstone& t : rangeTombstones) {
+        files.info.min_key = std::min(files.info.min_key, t.begin);
+        files.info.max_key = std::max(files.info.max_key, t.end);
     }
+    files.info.entry_count = sortedRecords.size();
+    files.info.size = filesSize(files);
 
-    sst->build(sortedRecords);
+    VersionEdit edit;
+    edit.added.push_back(files.info);
+    logEdit(edit);
 
-    writeMap();
+    levelTables(level).push_back(std::move(files));
+    levelRanges_.erase(level);
 
     std::cout << "[SSTManager] Successfully wrote SSTable " << fileId << " to level " << level
         << std::endl;
@@ -392,90 +627,14 @@ bool SSTManager::readBytes(void* dst, size_t n, uint64_t& offset, string fileNam
 }
 
 vector<unique_ptr<SSTable>> SSTManager::getTablesFromLevel(int level) {
-	string path = directory_ + "/level_" + to_string(level) + "/";
-
-	// ne postoji level direktorijum ili nije direktorijum
-    if (!fs::exists(path) || !fs::is_directory(path)) {
-        std::cerr << "[SSTManager] Level directory does not exist: " << path << std::endl;
-        return {};
-	}
-
     vector<unique_ptr<SSTable>> tables;
-                       
-    // nesto + _raw_ + id + .db
-    // nesto + _sf_raw_ + id + .db
-    for (const auto& entry : fs::directory_iterator(path)) {
-        if (entry.is_regular_file()) {
-            string filename = entry.path().filename().string();
-
-            // ovo je single file
-            if (filename.rfind("sstable_", 0) == 0) {
-                // Proveri da li je raw ili comp
-                //sstable_sf_raw_0
-                if (filename.find("_raw_") != std::string::npos) {
-                    tables.push_back(make_unique<SSTableRaw>(path+filename, bm));
-                }
-                //sstable_sf_comp_0
-                else {
-                    tables.push_back(make_unique<SSTableComp>(path+filename, bm, key_map, id_to_key, next_ID_map));
-                }
-            }
-            // ovde je multi file, treba naci index, meta, summary, filter, data
-                
-            if (filename.rfind("data", 0) == 0) {
-                // Proveri da li je raw ili comp
-                if (filename.find("_raw_") != std::string::npos) {
-                    //data_raw_32.db
-					std::string numStr = filename.substr(9, filename.find(".db") -9);
-					int num = std::stoi(numStr);
-                    std::string data_path =     path + "data_raw_" + numStr + ".db";
-                    std::string index_path =    path + "index_raw_" + numStr + ".db";
-                    std::string filter_path =   path + "filter_raw_" + numStr + ".db";
-                    std::string summary_path =  path + "summary_raw_" + numStr + ".db";
-                    std::string meta_path =     path + "meta_raw_" + numStr + ".db";
-                    
-                    auto table = std::make_unique<SSTableRaw>(
-                        data_path,
-                        index_path,
-                        filter_path,
-                        summary_path,
-                        meta_path,
-                        bm
-                    );
-
-                    table->prepare();
-
-                    tables.push_back(std::move(table));
-                    //tables.push_back(make_unique<SSTableRaw>(data_path, index_path, filter_path, summary_path, meta_path, bm));
-                }
-                else {
-                    //data_comp_32.db
-                    std::string numStr = filename.substr(10, filename.find(".db") - 10);
-                    int num = std::stoi(numStr);
-                    std::string data_path = path + "data_comp_" + numStr + ".db";
-                    std::string index_path = path + "index_comp_" + numStr + ".db";
-                    std::string filter_path = path + "filter_comp_" + numStr + ".db";
-                    std::string summary_path = path + "summary_comp_" + numStr + ".db";
-                    std::string meta_path = path + "meta_comp_" + numStr + ".db";
-                   
-                    auto table = std::make_unique<SSTableComp>(
-                        data_path,
-                        index_path,
-                        filter_path,
-                        summary_path,
-                        meta_path,
-                        bm,
-                        key_map,
-                        id_to_key,
-                        next_ID_map);
-
-                    table->prepare();
-
-                    tables.push_back(std::move(table));
-                }
-            }
-        }
-	}
+
+    // Kompakcija i kursor dobijaju svoje objekte, jer citanje menja stanje tabele (offseti, ucitan blok)
+    for (const TableFiles& files : levelTables(level)) {
+        auto table = createTable(files);
+        table->prepare();
+        tables.push_back(std::move(table));
+    }
 
     return tables;
 }
@@ -492,29 +651,67 @@ void tryRemove(const fs::path& path) {
     }
 }
 
-void SSTManager::removeSSTables(const std::vector<std::unique_ptr<SSTable>>& tablesToRemove) {
-	//cout << "[SSTManager] Removing SSTables from level " << level << ", count: " << tablesToRemove.size() << endl;
+void SSTManager::deleteTableFiles(const TableFiles& files) {
+    if (files.info.single_file) {
+        tryRemove(files.data);
+    }
+    else {
+        tryRemove(files.data);
+        tryRemove(files.index);
+        tryRemove(files.filter);
+        tryRemove(files.summary);
+        tryRemove(files.meta);
+    }
+}
 
-    //string levelDir = Config::data_directory + "/level_" + std::to_string(level) + "/";
+void SSTManager::removeSSTables(const std::vector<std::unique_ptr<SSTable>>& tablesToRemove) {
+    VersionEdit edit;
+    std::vector<TableFiles> removed;
 
     for(const auto& sstable: tablesToRemove) {
-		//cout << "[SSTManager] Removing SSTable files for level " << sstable->getDataFileName() << endl;
-        
-        if (Config::sstable_single_file) {
-            tryRemove(sstable->getDataFileName());
-        }
-        else {
-            tryRemove(sstable->getDataFileName());
-			tryRemove(sstable->getIndexFileName());
-			tryRemove(sstable->getFilterFileName());
-			tryRemove(sstable->getSummaryFileName());
-			tryRemove(sstable->getMetaFileName());
+        // Tabela vise nije deo nivoa, izbacujemo je iz verzije i iz kesa otvorenih tabela
+        const std::string dataPath = sstable->getDataFileName();
+        evictTable(dataPath);
+
+        for (auto& level : levels_) {
+            auto& files = level.second;
+            auto it = std::find_if(files.begin(), files.end(),
+                [&](const TableFiles& f) { return f.data == dataPath; });
+            if (it == files.end()) continue;
+
+            edit.removed.emplace_back(it->info.level, it->info.id);
+            levelRanges_.erase(level.first);
+            removed.push_back(std::move(*it));
+            files.erase(it);
+            break;
         }
 	}
+
+    logEdit(edit);
+
+    // U okviru izmene fajlovi se brisu tek u commitEdit, posle upisa u MANIFEST
+    if (editOpen_) {
+        pendingDeletes_.insert(pendingDeletes_.end(), removed.begin(), removed.end());
+        return;
+    }
+    for (const TableFiles& files : removed) {
+        deleteTableFiles(files);
+    }
 }
 
 void SSTManager::validateTablesForLevel(int level) {
+    validateLevel(level, nullopt);
+}
+
+void SSTManager::validateTablesForLevel(int level, const std::string& min_key, const std::string& max_key) {
+    validateLevel(level, make_pair(min_key, max_key));
+}
+
+void SSTManager::validateLevel(int level, const optional<pair<string, string>>& keyRange) {
     std::cout << "\n--- VALIDATION STARTED FOR LEVEL:  " << level << " ---" << std::endl;
+    if (keyRange) {
+        std::cout << "KEY RANGE: [" << keyRange->first << ", " << keyRange->second << "]" << std::endl;
+    }
 
     // Koristimo postojeću funkciju da dobijemo sve tabele za dati nivo
     vector<unique_ptr<SSTable>> tables = getTablesFromLevel(level);
@@ -526,10 +723,45 @@ void SSTManager::validateTablesForLevel(int level) {
     }
 
     bool allLevelsValid = true;
+
+    // Stare tabele se proveravaju odmah, zapis po zapis; ostalima se citaju meta delovi (kroz block manager)
+    vector<SSTable*> blockChecked;
     for (const auto& table : tables) {
-        // Pozivamo validate() metodu za svaku tabelu.
-        // Sva kompleksna logika je sakrivena unutar same tabele.
-        if (!table->validate()) {
+        if (keyRange && (table->getSummaryMax() < keyRange->first || table->getSummaryMin() > keyRange->second)) {
+            continue; // tabela nema kljuceva iz opsega
+        }
+
+        if (!table->hasBlockMerkle()) {
+            bool valid = keyRange ? table->validateRange(keyRange->first, keyRange->second) : table->validate();
+            if (!valid) allLevelsValid = false;
+            continue;
+        }
+
+        bool ready = keyRange ? table->beginBlockCheck(keyRange->first, keyRange->second) : table->beginBlockCheck();
+        if (ready) blockChecked.push_back(table.get());
+        else allLevelsValid = false;
+    }
+
+    // Blokovi se citaju direktno sa diska, pa se tabele hesiraju paralelno, svaka u jednoj niti
+    unsigned hw = std::thread::hardware_concurrency();
+    if (hw == 0) hw = 2;
+
+    std::atomic<size_t> next{ 0 };
+    std::vector<std::thread> workers;
+    const size_t workerCount = std::min<size_t>(hw, blockChecked.size());
+    workers.reserve(workerCount);
+    for (size_t i = 0; i < workerCount; ++i) {
+        workers.emplace_back([&blockChecked, &next]() {
+            for (size_t t = next++; t < blockChecked.size(); t = next++) {
+                blockChecked[t]->hashCheckedBlocks();
+            }
+        });
+    }
+    for (auto& t : workers) t.join();
+
+    // Ispis ide redom po tabelama
+    for (SSTable* table : blockChecked) {
+        if (!table->finishBlockCheck()) {
             allLevelsValid = false;
         }
     }
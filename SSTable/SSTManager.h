@@ -4,8 +4,13 @@
 #include <vector>
 #include <filesystem>
 #include <optional>
+#include <list>
+#include <map>
+#include <memory>
 #include "../Wal/wal.h"
 #include "SSTable.h"
+#include "Manifest.h"
+#include "ValueLog.h"
 
 class SSTManager
 {
@@ -16,35 +21,108 @@ private:
     std::string directory_;
     // Format imena: filter_x.sst, summary_x.sst, index_x.sst, sstable_x.sst, meta_x.sst   
 
-    // pronalazenje jedinsvenog ID-a za novi SSTable
-    int findNextIndex(const std::string& levelDir) const;
-
-    uint32_t next_ID_map;
-    unordered_map<string, uint32_t> key_map;
+    // Globalna key_map (ID -> kljuc) iz vremena pre recnika kljuceva po tabeli (TOC_FLAG_KEY_DICT).
+    // Nove tabele je ne koriste i vise se ne upisuje; cita se samo kada stara kompresovana tabela
+    // zatrazi kljuc po ID-u, pa pokretanje ne ucitava sve kljuceve koje je baza ikada videla.
     vector<string> id_to_key;
+    bool key_map_loaded_;
 
-    void writeMap() const;
     void readMap();
+    const vector<string>& legacyKeys();
 
     Block_manager* bm;
     int block_size;
 
     bool readBytes(void* dst, size_t n, uint64_t& offset, string fileName) const;
 
+    // Putanje do fajlova jedne SSTabele; data putanja je i kljuc u kesu otvorenih tabela
+    struct TableFiles {
+        std::string data, index, filter, summary, meta;
+        TableMeta info;
+    };
+
+    // Trenutna verzija: tabele po nivoima, u redosledu upisa. Pravi se iz MANIFEST-a pri pokretanju,
+    // posle je odrzavaju write i removeSSTables (svaka izmena se prvo upise u MANIFEST).
+    std::map<int, std::vector<TableFiles>> levels_;
+    std::vector<TableFiles>& levelTables(int level);
+    TableFiles filesFor(const TableMeta& info) const;
+
+    // Opsezi kljuceva tabela nivoa (iz MANIFEST-a), sortirani po min kljucu. Kada se opsezi ne
+    // preklapaju (leveled nivoi posle prvog), get binarnom pretragom dolazi do jedine kandidat tabele.
+    // Pravi se pri prvom get-u na nivou, brise se kada write ili removeSSTables promene nivo.
+    struct LevelRanges {
+        std::vector<size_t> byMin; // indeksi u levels_[level]
+        bool disjoint = true;
+    };
+    std::map<int, LevelRanges> levelRanges_;
+    const LevelRanges& rangesFor(int level);
+    static uint64_t filesSize(const TableFiles& files);
+
+    Manifest manifest_;
+    int nextFileId_; // ID-evi su jedinstveni za sve nivoe i nikad se ne ponavljaju
+
+    // Velike vrednosti (Config::value_log_threshold); tabela pamti u MANIFEST-u na koje segmente pokazuje
+    ValueLog vlog_;
+    // (segment, bajtova) za zapise-pokazivace, za TableMeta::vlog_refs
+    static std::vector<std::pair<uint32_t, uint64_t>> valueLogRefs(const std::vector<Record>& records);
+
+    void loadVersion();
+    // Stari direktorijum bez MANIFEST-a: jednom se skeniraju level_N direktorijumi
+    std::vector<TableFiles> scanLevel(int level) const;
+    void logEdit(VersionEdit& edit);
+
+    // Izmena koja je u toku (beginEdit/commitEdit). Fajlovi uklonjenih tabela se brisu
+    // tek kada je izmena upisana u MANIFEST.
+    bool editOpen_;
+    VersionEdit pendingEdit_;
+    std::vector<TableFiles> pendingDeletes_;
+    void deleteTableFiles(const TableFiles& files);
+
+    // Kes otvorenih tabela (LRU, najvise Config::max_open_tables). TOC, summary i
+    // Bloom filter otvorene tabele ostaju u memoriji izmedju dva get-a.
+    using OpenTableList = std::list<std::pair<std::string, std::shared_ptr<SSTable>>>;
+    OpenTableList openTables_;
+    std::unordered_map<std::string, OpenTableList::iterator> openTableIndex_;
+
+    std::shared_ptr<SSTable> openTable(const TableFiles& files);
+    void evictTable(const std::string& dataPath);
+    std::unique_ptr<SSTable> createTable(const TableFiles& files);
+
+    // Validacija nivoa; bez opsega kljuceva proverava se cela svaka tabela
+    void validateLevel(int level, const optional<pair<string, string>>& keyRange);
+
 public:
     //SSTManager();
     SSTManager(Block_manager* bmp);
     ~SSTManager();
 
     Block_manager* get_block_manager();
-    std::unordered_map<std::string, uint32_t>& get_key_to_id_map();
-    std::vector<std::string>& get_id_to_key_map();
-    uint32_t& get_next_id();
 
+    // Baca runtime_error ako vrednost iz value loga ne moze da se procita
     optional<string> get(const std::string& key);
     optional<string> get_from_level(const std::string& key, bool& deleted, int level);
-	void write(std::vector<Record> sortedRecords, int level);
+	// Brisanja opsega se upisuju uz zapise; tabela moze imati i samo njih
+	void write(std::vector<Record> sortedRecords, int level, std::vector<RangeTombstone> rangeTombstones = {});
+
+    // Zapis sa pokazivacem u value log dobija pravu vrednost; false ako vrednost ne moze da se procita
+    bool resolveValue(Record& r) const;
+    // Kao resolveValue, ali za citanje: vrednost koja ne moze da se procita baca runtime_error,
+    // jer bi preskakanje zapisa otkrilo stariju verziju kljuca sa nizeg nivoa
+    void loadValue(Record& r) const;
+    // Brise segmente value loga na koje ne pokazuje nijedna tabela, a iz segmenta sa najvise
+    // mrtvih bajtova (bar Config::value_log_gc_percent) premesta zive vrednosti, prepisujuci tabele koje ga koriste
+    void collectValueLogGarbage();
     vector<unique_ptr<SSTable>> getTablesFromLevel(int level); // -skenira direktorijum za dati nivo, pronalazi sve SSTABLE
 	void removeSSTables(const vector<unique_ptr<SSTable>>& tablesToRemove);
     void validateTablesForLevel(int level);
+    // Proverava samo data blokove u kojima mogu biti kljucevi iz [min_key, max_key]
+    void validateTablesForLevel(int level, const std::string& min_key, const std::string& max_key);
+
+    // Sve izmene izmedju beginEdit i commitEdit (npr. upis rezultata kompakcije i uklanjanje ulaza)
+    // idu u MANIFEST kao jedan zapis
+    void beginEdit();
+    bool commitEdit(); // false ako izmena nije upisana u MANIFEST
+
+    std::vector<int> getLevels() const;                 // nivoi koji imaju bar jednu tabelu
+    std::vector<TableMeta> getLevelMeta(int level);     // isti redosled kao getTablesFromLevel
 };
@@ -1,18 +1,26 @@
 ﻿#include "SSTable.h"
+#include <fstream>
 
 void SSTable::build(std::vector<Record>&records)
 {
-    std::sort(records.begin(), records.end(),
-        [](auto const& a, auto const& b) {
-            return a.key < b.key;
-        });
+    // Flush i kompakcija vec salju sortirane zapise, pa sortiramo samo ako ulaz nije sortiran
+    auto byKey = [](auto const& a, auto const& b) {
+        return a.key < b.key;
+    };
+    if (!std::is_sorted(records.begin(), records.end(), byKey)) {
+        std::sort(records.begin(), records.end(), byKey);
+    }
 
     if (records.empty()) {
         std::cerr << "[SSTable] build: Nema zapisa.\n";
         return;
     }
 
-    // Data u fajl
+    // Verzija se postavlja pre upisa data dela: od nje zavisi hes listova Merkle stabla
+    toc.version = TOC_VERSION_MERKLE_MURMUR;
+
+    // Data u fajl; writeDataBlock usput pravi listove Merkle stabla
+    originalLeafHashes_.clear();
     std::vector<IndexEntry> indexAll = writeDataMetaFiles(records);
 
     index_.reserve(indexAll.size() / index_sparsity + 1);
@@ -25,21 +33,13 @@ void SSTable::build(std::vector<Record>&records)
         index_.push_back(indexAll.back());
     }
 
-    BloomFilter bf(records.size(), 0.01);
-    std::vector<std::string> valuesForMerkle;
-    valuesForMerkle.reserve(records.size());
-    for (const auto& r : records) {
-        bf.add(r.key);
-        valuesForMerkle.push_back(std::string(reinterpret_cast<const char*>(r.value.data()), r.value.size()));
-    }
-    bloom_ = bf;
+    buildFilter(records);
+    buildPrefixFilter(records);
+    buildRangeFilter(records);
 
-    if (!valuesForMerkle.empty()) {
-        MerkleTree merkleTree(valuesForMerkle);
-        rootHash_ = merkleTree.getRootHash();
-        originalLeafHashes_ = merkleTree.getLeaves();
-        std::cout << "[SSTable] Kreiran Merkle Root Hash: " << rootHash_ << std::endl;
-    }
+    toc.flags |= TOC_FLAG_MERKLE_RAW;
+    rootHash_ = MerkleStream::rootOf(originalLeafHashes_, legacyMerkleDigest());
+    std::cout << "[SSTable] Kreiran Merkle Root Hash: " << printableHash(rootHash_) << std::endl;
 
     // Index u fajl
     std::vector<IndexEntry> summaryAll = writeIndexToFile();
@@ -67,9 +67,9 @@ void SSTable::build(std::vector<Record>&records)
         summary_.max = maxEntry->key;
     }
 
-    // Bloom, meta, summary u fajl
+    // Filter, meta, summary u fajl
     writeSummaryToFile();
-    writeBloomToFile();
+    writeFilterToFile();
     writeMetaToFile();
 
     // Pisemo toc
@@ -165,41 +165,416 @@ void SSTable::prepare() {
 }
 
 bool SSTable::possiblyContains(const std::string& key){
-    readBloomFromFile();
-    return bloom_.possiblyContains(key);
+    if (!filter_loaded_) {
+        prepare(); // filter_offset je u TOC-u (single file mode)
+        readFilterFromFile();
+        filter_loaded_ = true;
+    }
+    return use_xor_ ? xor_.possiblyContains(key) : bloom_.possiblyContains(key);
 }
 
-bool SSTable::readBytes(void* dst, size_t n, uint64_t& offset, string fileName) const
-{
-    if (n == 0) return true;
+void SSTable::buildFilter(const std::vector<Record>& records) {
+    // Tabela se posle build-a ne menja, pa moze i staticki xor filter
+    use_xor_ = Config::sstable_filter == "xor";
 
-    bool error = false;
+    if (use_xor_) {
+        std::vector<std::string> keys;
+        keys.reserve(records.size());
+        for (const auto& r : records) {
+            keys.push_back(r.key);
+        }
+        xor_ = XorFilter(keys);
+        return;
+    }
 
-    int block_id = offset / block_size;
-    uint64_t block_pos = offset % block_size;
+    BloomFilter bf(records.size(), 0.01, Config::bloom_filter_blocked);
+    for (const auto& r : records) {
+        bf.add(r.key);
+    }
+    bloom_ = bf;
+}
+
+void SSTable::buildPrefixFilter(const std::vector<Record>& records) {
+    has_prefix_filter_ = Config::prefix_filter_length > 0 || !Config::prefix_filter_delimiter.empty();
+    if (!has_prefix_filter_) return;
+
+    prefix_length_ = static_cast<uint32_t>(std::max(0, Config::prefix_filter_length));
+    prefix_delimiter_ = prefix_length_ == 0 ? Config::prefix_filter_delimiter[0] : 0;
+
+    // Zapisi su sortirani, pa su isti prefiksi jedan do drugog
+    std::vector<std::string> prefixes;
+    std::string prefix;
+    for (const auto& r : records) {
+        if (extractPrefix(r.key, prefix) && (prefixes.empty() || prefixes.back() != prefix)) {
+            prefixes.push_back(prefix);
+        }
+    }
+
+    BloomFilter bf(static_cast<unsigned int>(std::max<size_t>(prefixes.size(), 1)), 0.01, Config::bloom_filter_blocked);
+    for (const auto& p : prefixes) {
+        bf.add(p);
+    }
+    prefix_bloom_ = bf;
+    toc.flags |= TOC_FLAG_PREFIX_FILTER;
+}
+
+bool SSTable::extractPrefix(const std::string& key, std::string& prefix) const {
+    if (prefix_length_ > 0) {
+        if (key.size() < prefix_length_) return false;
+        prefix.assign(key, 0, prefix_length_);
+        return true;
+    }
+
+    size_t pos = key.find(prefix_delimiter_);
+    if (pos == std::string::npos) return false;
+    prefix.assign(key, 0, pos + 1);
+    return true;
+}
+
+bool SSTable::mayContainPrefix(const std::string& prefix) {
+    if (!filter_loaded_) {
+        prepare();
+        readFilterFromFile();
+        filter_loaded_ = true;
+    }
+    if (!has_prefix_filter_) return true;
+
+    // Svaki kljuc koji pocinje sa prefix ima isti izdvojeni prefiks kao i sam prefix,
+    // ako je prefix dovoljno dug (ima delimiter, odnosno bar prefix_length_ bajtova)
+    std::string extracted;
+    if (!extractPrefix(prefix, extracted)) return true;
+    return prefix_bloom_.possiblyContains(extracted);
+}
+
+void SSTable::buildRangeFilter(const std::vector<Record>& records) {
+    has_range_filter_ = Config::sstable_range_filter;
+    if (!has_range_filter_) return;
+
+    std::vector<std::string> keys;
+    keys.reserve(records.size());
+    for (const auto& r : records) {
+        keys.push_back(r.key);
+    }
+    range_filter_ = RangeFilter(keys);
+    toc.flags |= TOC_FLAG_RANGE_FILTER;
+}
+
+bool SSTable::mayContainRange(const std::string& min_key, const std::string& max_key) {
+    if (!filter_loaded_) {
+        prepare();
+        readFilterFromFile();
+        filter_loaded_ = true;
+    }
+    if (!has_range_filter_) return true;
+    return range_filter_.mayContainRange(min_key, max_key);
+}
+
+void SSTable::loadRangeFilter(const std::vector<byte>& raw) {
+    range_filter_ = RangeFilter::deserialize(raw);
+    has_range_filter_ = true;
+}
+
+const std::vector<RangeTombstone>& SSTable::rangeTombstones() {
+    if (!filter_loaded_) {
+        prepare();
+        readFilterFromFile();
+        filter_loaded_ = true;
+    }
+    return range_tombstones_;
+}
 
-    vector<byte> block = bmp->read_block({ block_id++, fileName }, error);
-    if (error) return !error;
+std::vector<byte> SSTable::serializeRangeTombstones() const {
+    // [varint broj]{[varint duzina][begin][varint duzina][end][uint64 timestamp]}
+    std::string out = varenc::encodeVarint<uint64_t>(range_tombstones_.size());
+    for (const RangeTombstone& t : range_tombstones_) {
+        out.append(varenc::encodeVarint<uint64_t>(t.begin.size()));
+        out.append(t.begin);
+        out.append(varenc::encodeVarint<uint64_t>(t.end.size()));
+        out.append(t.end);
+        out.append(reinterpret_cast<const char*>(&t.timestamp), sizeof(t.timestamp));
+    }
+    const byte* p = reinterpret_cast<const byte*>(out.data());
+    return std::vector<byte>(p, p + out.size());
+}
+
+bool SSTable::loadRangeTombstones(const std::vector<byte>& raw) {
+    range_tombstones_.clear();
+
+    size_t pos = 0;
+    auto readVarint = [&](uint64_t& value) {
+        value = 0;
+        size_t bitOffset = 0;
+        while (pos < raw.size() && bitOffset < 64) {
+            if (varenc::decodeVarint<uint64_t>(static_cast<char>(raw[pos++]), value, bitOffset)) return true;
+        }
+        return false;
+    };
+    auto readString = [&](std::string& s) {
+        uint64_t len;
+        if (!readVarint(len) || len > raw.size() - pos) return false;
+        s.assign(reinterpret_cast<const char*>(raw.data()) + pos, len);
+        pos += len;
+        return true;
+    };
+
+    uint64_t count;
+    if (!readVarint(count)) return false;
+    for (uint64_t i = 0; i < count; ++i) {
+        RangeTombstone t;
+        if (!readString(t.begin) || !readString(t.end) || raw.size() - pos < sizeof(t.timestamp)) {
+            std::cerr << "[SSTable] Ostecena brisanja opsega u " << filterFile_ << "\n";
+            range_tombstones_.clear();
+            return false;
+        }
+        std::memcpy(&t.timestamp, raw.data() + pos, sizeof(t.timestamp));
+        pos += sizeof(t.timestamp);
+        range_tombstones_.push_back(std::move(t));
+    }
+    // Tabele upisane pre sredjivanja liste mogu imati preklopljena brisanja
+    coalesceRangeTombstones(range_tombstones_);
+    return true;
+}
 
+std::vector<byte> SSTable::serializePrefixFilter() const {
+    // [uint32 duzina][char delimiter][Bloom filter]
+    std::vector<byte> bloomBytes = prefix_bloom_.serialize();
+    std::vector<byte> raw(sizeof(prefix_length_) + sizeof(prefix_delimiter_));
+    std::memcpy(raw.data(), &prefix_length_, sizeof(prefix_length_));
+    std::memcpy(raw.data() + sizeof(prefix_length_), &prefix_delimiter_, sizeof(prefix_delimiter_));
+    raw.insert(raw.end(), bloomBytes.begin(), bloomBytes.end());
+    return raw;
+}
+
+void SSTable::loadPrefixFilter(const std::vector<byte>& raw) {
+    size_t header = sizeof(prefix_length_) + sizeof(prefix_delimiter_);
+    if (raw.size() <= header) return;
+
+    std::memcpy(&prefix_length_, raw.data(), sizeof(prefix_length_));
+    std::memcpy(&prefix_delimiter_, raw.data() + sizeof(prefix_length_), sizeof(prefix_delimiter_));
+    prefix_bloom_ = BloomFilter::deserialize(std::vector<byte>(raw.begin() + header, raw.end()));
+    has_prefix_filter_ = true;
+}
+
+std::vector<byte> SSTable::serializeFilter() const {
+    return use_xor_ ? xor_.serialize() : bloom_.serialize();
+}
+
+void SSTable::loadFilter(const std::vector<byte>& raw) {
+    use_xor_ = XorFilter::isXorFilter(raw);
+    if (use_xor_) {
+        xor_ = XorFilter::deserialize(raw);
+    }
+    else {
+        bloom_ = BloomFilter::deserialize(raw);
+    }
+}
+
+void SSTable::computeMerkle(const std::vector<Record>& records, std::string& root, std::vector<std::string>& leaves) const {
+    root.clear();
+    leaves.clear();
+    if (records.empty()) return;
+
+    if (!(toc.flags & TOC_FLAG_MERKLE_RAW)) {
+        // Stara tabela: decimalni hesevi i celo stablo u memoriji
+        std::vector<std::string> values;
+        values.reserve(records.size());
+        for (const auto& r : records) {
+            values.push_back(r.value);
+        }
+        MerkleTree tree(values);
+        root = tree.getRootHash();
+        leaves = tree.getLeaves();
+        return;
+    }
+
+    // Vrednosti se ne kopiraju: niti hesiraju direktno iz zapisa
+    leaves = MerkleStream::hashLeaves(records.size(), [&records](size_t i) -> const std::string& {
+        return records[i].value;
+    }, legacyMerkleDigest());
+
+    root = MerkleStream::rootOf(leaves, legacyMerkleDigest());
+}
+
+std::string SSTable::printableHash(const std::string& hash) const {
+    return (toc.flags & TOC_FLAG_MERKLE_RAW) ? MerkleStream::toHex(hash) : hash;
+}
+
+void SSTable::writeDataBlock(int block_id, const std::string& chunk) {
+    bmp->write_block({ block_id, dataFile_ }, chunk);
+
+    // Block manager dopunjuje blok do block_size, pa hesiramo isto sto ce validate procitati sa diska
+    std::string padded(chunk, 0, std::min<size_t>(chunk.size(), block_size));
+    padded.resize(block_size, static_cast<char>(padding_character));
+    originalLeafHashes_.push_back(MerkleStream::hash(padded.data(), padded.size(), legacyMerkleDigest()));
+}
+
+bool SSTable::hasBlockMerkle() {
+    prepare();
+    return toc.version >= TOC_VERSION_MERKLE_BLOCKS;
+}
+
+bool SSTable::validate() {
+    if (!hasBlockMerkle()) return validateRecords();
+
+    if (!beginBlockCheck()) return false;
+    hashCheckedBlocks();
+    return finishBlockCheck();
+}
+
+bool SSTable::validateRange(const std::string& min_key, const std::string& max_key) {
+    if (!hasBlockMerkle()) {
+        std::cout << "[Validate] " << dataFile_ << " nema Merkle stablo nad blokovima, proverava se cela tabela." << std::endl;
+        return validateRecords();
+    }
+
+    if (!beginBlockCheck(min_key, max_key)) return false;
+    hashCheckedBlocks();
+    return finishBlockCheck();
+}
+
+bool SSTable::beginBlockCheck() {
+    prepare();
+    readMetaFromFile();
+
+    blockCheck_ = BlockCheck();
+    blockCheck_.whole = true;
+    blockCheck_.first = firstDataBlock();
+    blockCheck_.end = dataBlockEnd();
+
+    // Listovi iz meta dela moraju dati sacuvani koren, inace ne mozemo verovati ni njima
+    if (rootHash_.empty() || originalLeafHashes_.size() != blockCheck_.end - blockCheck_.first
+        || MerkleStream::rootOf(originalLeafHashes_, legacyMerkleDigest()) != rootHash_) {
+        std::cout << "\n[Validate] GREŠKA: Meta deo SSTable " << dataFile_
+            << " je oštećen (listovi Merkle stabla ne odgovaraju korenu ili broju data blokova)." << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool SSTable::beginBlockCheck(const std::string& min_key, const std::string& max_key) {
+    if (!beginBlockCheck()) return false;
+
+    blockCheck_.whole = false;
+    uint64_t begin = 0, end = 0;
+    if (min_key > max_key || !dataRangeForKeys(min_key, max_key, begin, end)) {
+        blockCheck_.end = blockCheck_.first; // u opsegu nema zapisa, nema ni blokova za proveru
+        return true;
+    }
+
+    blockCheck_.first = std::max<uint64_t>(blockCheck_.first, begin / block_size);
+    blockCheck_.end = std::max(blockCheck_.first, std::min<uint64_t>(blockCheck_.end, (end + block_size - 1) / block_size));
+    return true;
+}
+
+bool SSTable::dataRangeForKeys(const std::string& min_key, const std::string& max_key, uint64_t& begin, uint64_t& end) {
+    bool found = false;
+    begin = findRecordOffset(min_key, found);
+    if (begin == std::numeric_limits<uint64_t>::max() || begin >= toc.data_end) return false;
+
+    end = findRecordOffset(max_key, found);
+    if (end == std::numeric_limits<uint64_t>::max()) {
+        end = toc.data_end;
+    }
+    else if (found) {
+        // Zapis sa max_key je u opsegu, pa je kraj tek posle njega
+        bool error = false, eof = false;
+        getNextRecord(end, error, eof);
+        if (error || eof) end = toc.data_end;
+    }
+    return begin < end;
+}
+
+void SSTable::hashCheckedBlocks() {
+    blockCheck_.hashes.clear();
+    blockCheck_.hashes.reserve(blockCheck_.end - blockCheck_.first);
+
+    // Namerno mimo block managera: kes bi vratio blok kakav je upisan, a ne kakav je sada na disku
+    std::ifstream in(dataFile_, std::ios::binary);
+    in.seekg(blockCheck_.first * block_size);
+
+    std::vector<char> buffer(block_size);
+    for (uint64_t id = blockCheck_.first; id < blockCheck_.end; ++id) {
+        if (!in.read(buffer.data(), block_size)) {
+            blockCheck_.hashes.emplace_back(); // fajl je skracen
+            continue;
+        }
+        blockCheck_.hashes.push_back(MerkleStream::hash(buffer.data(), buffer.size(), legacyMerkleDigest()));
+    }
+}
+
+bool SSTable::finishBlockCheck() {
+    const uint64_t first = blockCheck_.first;
+    const uint64_t checked = blockCheck_.hashes.size();
+
+    std::cout << std::dec << "\n[Validate] SSTable: " << dataFile_ << ", proverava se " << checked << " od "
+        << dataBlockEnd() - firstDataBlock() << " data blokova" << std::endl;
+    if (blockCheck_.whole) {
+        std::cout << "[Validate] Očekivani (sačuvani) Root Hash: " << printableHash(rootHash_) << std::endl;
+        std::cout << "[Validate] Trenutni (izračunati) Root Hash:  " << printableHash(MerkleStream::rootOf(blockCheck_.hashes, legacyMerkleDigest())) << std::endl;
+    }
+
+    // Uzastopni osteceni blokovi se prijavljuju kao jedan opseg
+    std::vector<std::pair<uint64_t, uint64_t>> damaged;
+    for (uint64_t i = 0; i < checked; ++i) {
+        if (blockCheck_.hashes[i] == originalLeafHashes_[first + i - firstDataBlock()]) continue;
+
+        if (!damaged.empty() && damaged.back().second == first + i) damaged.back().second++;
+        else damaged.push_back({ first + i, first + i + 1 });
+    }
+
+    if (damaged.empty()) {
+        std::cout << "[Validate] USPEH: Svih " << checked << " proverenih data blokova je ispravno." << std::endl;
+        return true;
+    }
+
+    std::cout << "[Validate] GREŠKA: Podaci u SSTable su izmenjeni! Oštećeni data blokovi:" << std::endl;
+    for (const auto& [from, to] : damaged) {
+        if (to - from == 1) std::cout << "  -> blok " << from;
+        else std::cout << "  -> blokovi " << from << "-" << to - 1;
+        std::cout << " (bajtovi " << from * block_size << "-" << std::min<uint64_t>(to * block_size, toc.data_end) << ")";
+        if (blockCheck_.hashes[from - first].empty()) std::cout << ", fajl je kraći od data dela";
+        std::cout << std::endl;
+    }
+    return false;
+}
+
+bool SSTable::readBytes(void* dst, size_t n, uint64_t& offset, const string& fileName) const
+{
     char* out = reinterpret_cast<char*>(dst);
 
     while (n > 0) {
-        if (block_pos == block_size) {
-            // fetch sledeci
-            block = bmp->read_block({ block_id++, fileName }, error);
-            if (error) return !error;
+        size_t available = 0;
+        const uint8_t* block = bufferedBytes(offset, fileName, available);
+        if (!block) return false;
 
-            block_pos = 0;
-        }
-        size_t take = min(n, block_size - block_pos);
-        std::memcpy(out, block.data() + block_pos, take);
+        size_t take = min(n, available);
+        std::memcpy(out, block, take);
         out += take;
         offset += take;
-        block_pos += take;
         n -= take;
     }
 
-    return !error;
+    return true;
+}
+
+const uint8_t* SSTable::bufferedBytes(uint64_t offset, const string& fileName, size_t& available) const
+{
+    int block_id = offset / block_size;
+    if (block_id != readBlockId_ || fileName != readBlockFile_) {
+        bool error = false;
+        vector<byte> block = bmp->read_block({ block_id, fileName }, error);
+        if (error) return nullptr;
+
+        readBlock_.swap(block);
+        readBlockId_ = block_id;
+        readBlockFile_ = fileName;
+    }
+
+    size_t block_pos = offset % block_size;
+    if (block_pos >= readBlock_.size()) return nullptr;
+
+    available = readBlock_.size() - block_pos;
+    return reinterpret_cast<const uint8_t*>(readBlock_.data()) + block_pos;
 }
 
 void SSTable::printFileNames() {
@@ -8,8 +8,11 @@
 
 #include "../Wal/wal.h"
 #include "../BloomFilter/BloomFilter.h"
+#include "../BloomFilter/XorFilter.h"
+#include "../BloomFilter/RangeFilter.h"
 #include "../MerkleTree/MerkleTree.h"
 #include "../Utils/VarEncoding.h"
+#include "RangeTombstone.h"
 
 
 struct IndexEntry {
@@ -24,12 +27,37 @@ struct Summary {
     uint64_t count;
 };
 
+// Data deo je podeljen u blokove sa prefiksno kompresovanim kljucevima i restart tackama (SSTableRaw)
+constexpr uint8_t TOC_FLAG_BLOCK_FORMAT = 1 << 2;
+
+// Posle filtera kljuceva u filter delu je i Bloom filter prefiksa kljuceva
+constexpr uint8_t TOC_FLAG_PREFIX_FILTER = 1 << 3;
+// Posle prefiks filtera (ako ga ima) je range filter: "ima li kljuca u [min, max]"
+constexpr uint8_t TOC_FLAG_RANGE_FILTER = 1 << 4;
+// Data blokovi (blok format) imaju trailer sa ID-jem kodeka i mogu biti kompresovani
+constexpr uint8_t TOC_FLAG_BLOCK_CODEC = 1 << 5;
+// ID-evi kljuceva su iz recnika same tabele, a ne iz globalne key_map (SSTableComp)
+constexpr uint8_t TOC_FLAG_KEY_DICT = 1 << 6;
+// Merkle hesevi u meta delu su sirovi (MerkleStream), a ne decimalni zapis (MerkleTree)
+constexpr uint8_t TOC_FLAG_MERKLE_RAW = 1 << 7;
+
+// Od verzije 2 index i summary su blokovi kljuceva sa nizovima fiksne sirine (SSTableRaw)
+constexpr uint64_t TOC_VERSION_KEY_BLOCKS = 2;
+// Od verzije 3 listovi Merkle stabla su hesevi data blokova kakvi su na disku, a ne vrednosti zapisa
+constexpr uint64_t TOC_VERSION_MERKLE_BLOCKS = 3;
+// Od verzije 4 filter deo se zavrsava brisanjima opsega (RangeTombstone) upisanim uz tabelu
+constexpr uint64_t TOC_VERSION_RANGE_TOMBSTONES = 4;
+// Od verzije 5 index je particionisan u vise nivoa blokova, a summary je samo koren (SSTableRaw)
+constexpr uint64_t TOC_VERSION_PARTITIONED_INDEX = 5;
+// Od verzije 6 sirovi Merkle hesevi su MurmurHash3_x64_128 (16 bajta), ranije std::hash (MerkleStream)
+constexpr uint64_t TOC_VERSION_MERKLE_MURMUR = 6;
+
 struct TOC
 {
     // uint64_t saved_block_size;
 	// uint64_t saved_idx_sparsity;
     // uint64_t saved_summ_sparsity; Valjda ne
-	uint8_t flags; // Bit 0: Najmanji bit kompresija, sledeci single_file_mode
+	uint8_t flags; // Bit 0: Najmanji bit kompresija, sledeci single_file_mode, bit 2: blok format data dela, bit 3: prefiks filter, bit 4: range filter, bit 5: kodek data blokova, bit 6: recnik kljuceva, bit 7: sirovi Merkle hesevi
 	uint64_t version = 1; // za upuduce ako se updejtuje TOC
 	uint64_t data_offset, data_end;
 	uint64_t index_offset;
@@ -64,7 +92,13 @@ public:
         index_sparsity(Config::index_sparsity),
         summary_sparsity(Config::summary_sparsity),
         toc(),
-        ready_to_read_(false)
+        ready_to_read_(false),
+        use_xor_(false),
+        filter_loaded_(false),
+        has_prefix_filter_(false),
+        prefix_length_(0),
+        prefix_delimiter_(0),
+        has_range_filter_(false)
     {
     };
     
@@ -82,10 +116,18 @@ public:
         index_sparsity(Config::index_sparsity),
         summary_sparsity(Config::summary_sparsity),
         toc(),
-        ready_to_read_(false)
+        ready_to_read_(false),
+        use_xor_(false),
+        filter_loaded_(false),
+        has_prefix_filter_(false),
+        prefix_length_(0),
+        prefix_delimiter_(0),
+        has_range_filter_(false)
     {
     };
 
+    virtual ~SSTable() = default;
+
     string getDataFileName() const { return dataFile_; }
 	string getIndexFileName() const { return indexFile_; }
 	string getFilterFileName() const { return filterFile_; }
@@ -104,6 +146,14 @@ public:
      */
     virtual void build(std::vector<Record>& records);
 
+    // Brisanja opsega koja build upisuje uz zapise (poziva se pre build-a)
+    void setRangeTombstones(std::vector<RangeTombstone> tombstones) {
+        coalesceRangeTombstones(tombstones);
+        range_tombstones_ = std::move(tombstones);
+    }
+    // Brisanja opsega upisana uz tabelu (prazno za tabele pre TOC_VERSION_RANGE_TOMBSTONES)
+    const std::vector<RangeTombstone>& rangeTombstones();
+
     /**
      * get(key) - dohvatanje vrednosti iz data.sst
      */
@@ -122,7 +172,27 @@ public:
       */
     virtual Record getNextRecord(uint64_t& offset, bool& error, bool& eof) = 0;
 
-    virtual bool validate() = 0;
+    /**
+     * validate() - provera integriteta cele tabele.
+     * validateRange(min_key, max_key) - proverava samo data blokove u kojima mogu biti kljucevi iz [min_key, max_key].
+     *    Tabele sa Merkle stablom nad data blokovima ostecenje prijavljuju kao opseg blokova,
+     *    starije se proveravaju zapis po zapis (validateRecords) i uvek cele.
+     */
+    bool validate();
+    bool validateRange(const std::string& min_key, const std::string& max_key);
+
+    /**
+     * Provera po blokovima u tri koraka, da bi SSTManager vise tabela hesirao paralelno:
+     *    beginBlockCheck - cita meta deo i bira blokove (kroz block manager, iz jedne niti),
+     *    hashCheckedBlocks - cita izabrane blokove direktno sa diska, mimo kesa; bezbedno iz vise niti (svaka svoju tabelu),
+     *    finishBlockCheck - poredi sa listovima i ispisuje ostecene opsege.
+     * beginBlockCheck vraca false ako je greska vec prijavljena (tabela nije ispravna).
+     */
+    bool hasBlockMerkle();
+    bool beginBlockCheck();
+    bool beginBlockCheck(const std::string& min_key, const std::string& max_key);
+    void hashCheckedBlocks();
+    bool finishBlockCheck();
 
     /**
      * findRecordOffset(key, bool& in_file) - vraća offset u bajtovima gde se prvi Record sa kljucem nalazi u data fajlu.
@@ -141,6 +211,12 @@ public:
 
     bool possiblyContains(const std::string& key);
 
+    // false samo ako tabela sigurno nema nijedan kljuc koji pocinje sa prefix (prefiks filter)
+    bool mayContainPrefix(const std::string& prefix);
+
+    // false samo ako tabela sigurno nema nijedan kljuc u [min_key, max_key] (range filter)
+    bool mayContainRange(const std::string& min_key, const std::string& max_key);
+
     virtual void prepare(); // Cita TOC i header summary fajla kako bi se pripremio za citanje
 
     virtual std::string getSummaryMax() { prepare(); return summary_.max; }
@@ -160,19 +236,65 @@ protected:
     std::vector<IndexEntry> index_;
     Summary summary_;
 
+    // Filter kljuceva: Bloom ili xor (Config::sstable_filter). Koji je upisan, pise u samim bajtovima filtera.
     BloomFilter bloom_;
+    XorFilter xor_;
 
     Block_manager* bmp;
 
     std::string rootHash_; // Cuvamo samo korenski hash
     std::vector<std::string> originalLeafHashes_; // Cuvamo originalne listove Merkle stabla
 
+    // Stare tabele: Merkle koren i listovi nad vrednostima zapisa, po semi tabele (TOC_FLAG_MERKLE_RAW)
+    void computeMerkle(const std::vector<Record>& records, std::string& root, std::vector<std::string>& leaves) const;
+    // Hes u obliku za ispis (sirovi hesevi su binarni)
+    std::string printableHash(const std::string& hash) const;
+    // Tabela pre TOC_VERSION_MERKLE_MURMUR: sirovi hesevi su std::hash
+    bool legacyMerkleDigest() const { return toc.version < TOC_VERSION_MERKLE_MURMUR; }
+
+    // Upisuje data blok i pamti njegov hes kao sledeci list Merkle stabla (sa dopunom, kao na disku)
+    void writeDataBlock(int block_id, const std::string& chunk);
+
+    // Provera starih tabela (pre TOC_VERSION_MERKLE_BLOCKS), zapis po zapis
+    virtual bool validateRecords() = 0;
+
+    // Bajtovi data dela [begin, end) u kojima su svi zapisi sa kljucem iz [min_key, max_key];
+    // false ako takvih zapisa nema. Offseti moraju biti stvarni offseti u fajlu.
+    virtual bool dataRangeForKeys(const std::string& min_key, const std::string& max_key, uint64_t& begin, uint64_t& end);
+
+    struct BlockCheck {
+        uint64_t first = 0, end = 0;     // proveravani blokovi [first, end)
+        bool whole = false;
+        std::vector<std::string> hashes; // hesevi procitanih blokova, "" ako blok nije mogao da se procita
+    };
+    BlockCheck blockCheck_;
+
+    uint64_t firstDataBlock() const { return toc.data_offset / block_size; }
+    uint64_t dataBlockEnd() const { return (toc.data_end + block_size - 1) / block_size; }
+
     size_t summary_sparsity;
     size_t index_sparsity;
 
     TOC toc;
     
     bool ready_to_read_;
+    bool use_xor_;
+    bool filter_loaded_; // filter se cita samo jednom po objektu
+
+    // Prefiks filter: Bloom nad prefiksima kljuceva. Ekstraktor (fiksna duzina ili do delimitera)
+    // se cuva uz filter, pa promena Config-a ne menja znacenje vec upisanih tabela.
+    bool has_prefix_filter_;
+    uint32_t prefix_length_;    // > 0: prvih prefix_length_ bajtova
+    char prefix_delimiter_;     // inace: do prvog delimitera, ukljucujuci ga
+    BloomFilter prefix_bloom_;
+
+    bool has_range_filter_;
+    RangeFilter range_filter_;
+
+    std::vector<RangeTombstone> range_tombstones_;
+
+    // false ako kljuc (ili prefiks upita) nema prefiks po ovom ekstraktoru
+    bool extractPrefix(const std::string& key, std::string& prefix) const;
     
     // ----- pomoćne metode -----
 
@@ -185,11 +307,23 @@ protected:
     // Snima 'index_' u indexFile_
     virtual std::vector<IndexEntry> writeIndexToFile() = 0;
 
-    // Snima 'bloom_' u filterFile_
-    virtual void writeBloomToFile() = 0;
-
-    // Ucitava 'bloom_' iz filterFile_ ako vec nije
-    virtual void readBloomFromFile() = 0;
+    // Pravi filter od kljuceva tabele, serijalizuje ga i ucitava iz bajtova (Bloom ili xor)
+    void buildFilter(const std::vector<Record>& records);
+    void buildPrefixFilter(const std::vector<Record>& records);
+    void buildRangeFilter(const std::vector<Record>& records);
+    std::vector<byte> serializeFilter() const;
+    void loadFilter(const std::vector<byte>& raw);
+    std::vector<byte> serializePrefixFilter() const;
+    void loadPrefixFilter(const std::vector<byte>& raw);
+    void loadRangeFilter(const std::vector<byte>& raw);
+    std::vector<byte> serializeRangeTombstones() const;
+    bool loadRangeTombstones(const std::vector<byte>& raw);
+
+    // Snima filter u filterFile_
+    virtual void writeFilterToFile() = 0;
+
+    // Ucitava filter iz filterFile_
+    virtual void readFilterFromFile() = 0;
     virtual void readSummaryHeader() = 0;
 
     virtual void writeSummaryToFile() = 0;
@@ -197,11 +331,31 @@ protected:
     virtual void readMetaFromFile() = 0;
 
 
-    bool readBytes(void* dst, size_t n, uint64_t& offset, string fileName) const;
+    bool readBytes(void* dst, size_t n, uint64_t& offset, const string& fileName) const;
+
+    // Blok u kom je offset: bajtovi od offset-a do kraja bloka (available), nullptr ako bloka nema.
+    // Poslednji procitan blok ostaje u baferu tabele, pa uzastopna citanja unutar bloka ne idu
+    // kroz block manager i kes (tabela se posle build-a ne menja, pa bafer ne moze da zastari).
+    const uint8_t* bufferedBytes(uint64_t offset, const string& fileName, size_t& available) const;
+
+    mutable std::vector<byte> readBlock_;
+    mutable std::string readBlockFile_;
+    mutable int readBlockId_ = -1;
 
     // ovo mora ovde
     template<typename UInt>
-    bool readNumValue(UInt& dst, uint64_t& fileOffset, string fileName) const {
+    bool readNumValue(UInt& dst, uint64_t& fileOffset, const string& fileName) const {
+        // Ceo varint je u baferovanom bloku: dekodiramo ga direktno iz memorije
+        size_t available = 0;
+        const uint8_t* in = bufferedBytes(fileOffset, fileName, available);
+        if (in && available >= varenc::maxVarintLen<UInt>()) {
+            size_t used = varenc::decodeVarint<UInt>(in, dst);
+            if (used == 0) return false;
+            fileOffset += used;
+            return true;
+        }
+
+        // Varint je na kraju bloka (mozda i preko granice), citamo bajt po bajt
         char chunk;
         bool finished = false;
         size_t val_offset = 0;
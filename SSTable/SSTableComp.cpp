@@ -1,7 +1,9 @@
 ﻿#include "SSTableComp.h"
 #include <filesystem>
+#include <cstring>
 #include "../Utils/VarEncoding.h"
 #include "SSTable.h"
+#include "ValueLog.h"
 
 SSTableComp::SSTableComp(const std::string & dataFile,
     const std::string & indexFile,
@@ -9,25 +11,17 @@ SSTableComp::SSTableComp(const std::string & dataFile,
     const std::string & summaryFile,
     const std::string & metaFile,
     Block_manager * bmp,
-    unordered_map<string, uint32_t>&key_to_id,
-    vector<string>&id_to_key,
-    uint32_t & nextId)
+    LegacyKeyLoader legacyKeys)
     : SSTable(dataFile, indexFile, filterFile, summaryFile, metaFile, bmp),
-    key_to_id(key_to_id),
-    id_to_key(id_to_key),
-    nextID(nextId)
+    legacyKeys_(std::move(legacyKeys))
 {
 }
 
 SSTableComp::SSTableComp(const std::string& dataFile,
     Block_manager* bmp,
-    unordered_map<string, uint32_t>& map,
-    vector<string>& id_to_key,
-    uint32_t& nextId)
+    LegacyKeyLoader legacyKeys)
     : SSTable(dataFile, bmp),
-    key_to_id(map),
-    id_to_key(id_to_key),
-    nextID(nextId)
+    legacyKeys_(std::move(legacyKeys))
 {
 } // single_file_mode
 
@@ -45,94 +39,20 @@ vector<Record> SSTableComp::get(const std::string& key)
         return matches;
     }
 
-    while (true) {
-        // EOF
-        // nikada da se desi zato sto proveravamo
-        // da li je kljuc koji se trazi veci od summary.max_key
-        if (fileOffset >= toc.data_end || fileOffset < toc.data_offset) break;
-
-        if (block_size - (fileOffset % block_size) <
-            sizeof(uint) + sizeof(ull) + 1 + 1 + sizeof(uint64_t) + sizeof(uint32_t)) {
-            fileOffset += block_size - (fileOffset % block_size);
-        } // Ako nema mesta za header u najgorem slucaju, paddujemo i to treba da se preskoci.
-
-        // citamo polja Record-a
-        uint crc = 0;
-        uint64_t start = fileOffset;
-        readNumValue<uint>(crc, fileOffset, dataFile_);
-        uint64_t crc_size = fileOffset - start;
-
-
-        Wal_record_type flag;
-        readBytes(&flag, sizeof(flag), fileOffset, dataFile_);
-
-        start = fileOffset;
-        uint64_t ts = 0;
-        readNumValue(ts, fileOffset, dataFile_);
-        uint64_t ts_size = fileOffset - start;
-
-        char tomb;
-        readBytes(&tomb, sizeof(tomb), fileOffset, dataFile_);
-
-        bool isTomb = (bool)tomb;
-
-        uint64_t v_size = 0;
-        if (!isTomb) readBytes(&v_size, sizeof(v_size), fileOffset, dataFile_);
-
-        start = fileOffset;
-        uint32_t r_key_id = 0;
-        readNumValue(r_key_id, fileOffset, dataFile_);
-        uint64_t r_key_size = fileOffset - start;
-
-        string rkey = id_to_key[r_key_id];
-
-        std::string rvalue;
-        rvalue.resize(v_size);
-        readBytes(&rvalue[0], v_size, fileOffset, dataFile_);
-
-        Record r;
-        r.crc = crc;
-        r.timestamp = ts;
-        r.tombstone = static_cast<byte>(tomb);
-        r.key_size = rkey.size();
-        r.value_size = v_size;
-        r.key = rkey;
-        r.value = rvalue;
+    // findRecordOffset vraca tacan pocetak zapisa; getNextRecord sastavlja i zapise podeljene preko blokova
+    while (fileOffset < toc.data_end) {
+        bool error = false, eof = false;
+        Record r = getNextRecord(fileOffset, error, eof);
+        if (error) break;
 
-        if (rkey == key) {
-            if (flag == Wal_record_type::FIRST) {
-                while (true) {
-                    fileOffset += crc_size;
-
-                    Wal_record_type flag;
-                    readBytes(&flag, sizeof(flag), fileOffset, dataFile_);
-
-                    fileOffset += ts_size;
-
-                    fileOffset += sizeof(tomb);
-
-                    uint64_t vSize = 0;
-                    if (!isTomb) readBytes(&vSize, sizeof(vSize), fileOffset, dataFile_);
-
-                    std::string rvalue;
-                    rvalue.resize(vSize);
-                    readBytes(&rvalue[0], vSize, fileOffset, dataFile_);
-
-                    r.value.append(rvalue);
-                    r.value_size += vSize;
-
-                    if (flag == Wal_record_type::LAST) {
-                        break;
-                    }
-                }
-            }
+        if (r.key == key) {
             matches.emplace_back(r);
         }
-
-        if (r.key > key) {
+        else if (r.key > key) {
             // nema smisla ici dalje, data fajl je sortiran
-            return matches;
+            break;
         }
+        if (eof) break;
     }
     return matches;
 }
@@ -156,15 +76,15 @@ SSTableComp::writeDataMetaFiles(std::vector<Record>& sortedRecords) {
     string concat;
     concat.reserve(block_size);
 
-    std::vector<std::string> data_for_merkle;
-    data_for_merkle.reserve(sortedRecords.size());
+    // Recnik kljuceva ove tabele; zapisi su sortirani, pa su isti kljucevi jedan do drugog
+    buildKeys_.clear();
+    for (const auto& r : sortedRecords) {
+        if (buildKeys_.empty() || buildKeys_.back() != r.key) buildKeys_.push_back(r.key);
+    }
+    toc.flags |= TOC_FLAG_KEY_DICT;
 
     for (auto& r : sortedRecords) {
 
-        {   // Merkle tree listovi
-            data_for_merkle.push_back(r.key + r.value);
-        }
-
         IndexEntry ie;
         ie.key = r.key;
         ie.offset = offset;
@@ -172,7 +92,8 @@ SSTableComp::writeDataMetaFiles(std::vector<Record>& sortedRecords) {
 
         Record rec(r);
 
-        bool tomb = (bool)rec.tombstone;
+        // Bit 1 (pokazivac u value log) ne menja format, vrednost je tada sam pokazivac
+        bool tomb = (rec.tombstone & TOMBSTONE_DELETED) != std::byte{ 0 };
 
         // Tomb se ne enkodira zato sto je 1 bajt, val size zbog splitovanja
         std::string crc = varenc::encodeVarint<uint>(rec.crc);
@@ -183,16 +104,9 @@ SSTableComp::writeDataMetaFiles(std::vector<Record>& sortedRecords) {
             rec.value = "";
         }
 
-        // ---- Menjamo kljuc sa vrednoscu iz mape ---- //
+        // ---- Menjamo kljuc sa ID-em iz recnika ---- //
 
-        uint32_t key_val;
-        auto it = key_to_id.find(r.key);
-        if (it == key_to_id.end()) {
-            key_to_id[r.key] = nextID++;
-            id_to_key.emplace_back(r.key);
-        }
-
-        key_val = key_to_id[r.key];
+        uint32_t key_val = idFor(r.key);
 
         string key_str = varenc::encodeVarint<uint32_t>(key_val);
 
@@ -218,7 +132,7 @@ SSTableComp::writeDataMetaFiles(std::vector<Record>& sortedRecords) {
         {
             offset += remaining;
 
-            bmp->write_block({ block_id++, dataFile_ }, concat);
+            writeDataBlock(block_id++, concat);
             concat.clear();
             remaining = block_size;
         }
@@ -249,7 +163,7 @@ SSTableComp::writeDataMetaFiles(std::vector<Record>& sortedRecords) {
             rec.value_size -= value_written;
 
             // Flushujemo blok
-            bmp->write_block({ block_id++, dataFile_ }, concat);
+            writeDataBlock(block_id++, concat);
             concat.clear();
             concat.reserve(block_size);
 
@@ -281,7 +195,7 @@ SSTableComp::writeDataMetaFiles(std::vector<Record>& sortedRecords) {
 
                 if (flag == Wal_record_type::MIDDLE) {
                     // Flushujemo blok
-                    bmp->write_block({ block_id++, dataFile_ }, concat);
+                    writeDataBlock(block_id++, concat);
                     concat.clear();
                     concat.reserve(block_size);
 
@@ -309,24 +223,19 @@ SSTableComp::writeDataMetaFiles(std::vector<Record>& sortedRecords) {
 
             // Flush
             if(remaining==len){
-                bmp->write_block({block_id++, dataFile_}, concat);
+                writeDataBlock(block_id++, concat);
                 concat.clear();
             }
         }
     }
 
     if (!concat.empty())
-        bmp->write_block({ block_id, dataFile_ }, concat);
+        writeDataBlock(block_id, concat);
 
     toc.data_end = block_id * block_size + concat.size();
     if (is_single_file_mode_) toc.index_offset = (block_id + 1) * block_size;
 
-    if (!data_for_merkle.empty()) {
-        MerkleTree merkle_tree(data_for_merkle);
-        this->rootHash_ = merkle_tree.getRootHash();
-        this->originalLeafHashes_ = merkle_tree.getLeaves();
-    }
-
+    // Merkle stablo pravi build, nad vrednostima zapisa
     return ret;
 }
 
@@ -355,7 +264,7 @@ std::vector<IndexEntry> SSTableComp::writeIndexToFile()
         summEntry.offset = offset;
         ret.push_back(summEntry);
 
-        uint32_t key_id = key_to_id[ie.key];
+        uint32_t key_id = idFor(ie.key);
         string key_str = varenc::encodeVarint<uint32_t>(key_id);
         string offset_str = varenc::encodeVarint<ull>(ie.offset);
 
@@ -396,8 +305,12 @@ void SSTableComp::writeSummaryToFile()
 
     payload.append(varenc::encodeVarint<uint64_t>(summary_.summary.size())); // Count
 
-    uint32_t min_key_val = key_to_id[summary_.min];
-    uint32_t max_key_val = key_to_id[summary_.max];
+    string dict = encodeKeyDict(buildKeys_);
+    payload.append(varenc::encodeVarint<uint64_t>(dict.size()));
+    payload.append(dict);
+
+    uint32_t min_key_val = idFor(summary_.min);
+    uint32_t max_key_val = idFor(summary_.max);
 
     string min_key_str = varenc::encodeVarint<uint32_t>(min_key_val);
     string max_key_str = varenc::encodeVarint<uint32_t>(max_key_val);
@@ -408,7 +321,7 @@ void SSTableComp::writeSummaryToFile()
 
 
     for (auto& summEntry : summary_.summary) {
-        string k_str = varenc::encodeVarint<uint32_t>(key_to_id[summEntry.key]);
+        string k_str = varenc::encodeVarint<uint32_t>(idFor(summEntry.key));
         payload.append(k_str);
 
         string offset_str = varenc::encodeVarint<ull>(summEntry.offset);
@@ -432,6 +345,10 @@ void SSTableComp::writeSummaryToFile()
     }
 
     if (is_single_file_mode_) toc.filter_offset = (block_id + 1) * block_size;
+
+    // Recnik je upisan, citanje ga ucitava iz fajla
+    buildKeys_.clear();
+    buildKeys_.shrink_to_fit();
 }
 
 // U SSTableRaw.cpp i SSTableComp.cpp
@@ -466,24 +383,21 @@ void SSTableComp::readMetaFromFile() {
     }
 }
 
-void SSTableComp::writeBloomToFile()
+void SSTableComp::writeFilterToFile()
 {
     uint64_t start_offset = 0;
     if (is_single_file_mode_) {
         start_offset = toc.filter_offset; // Set in summary writer
     }
 
-    std::vector<byte> raw = bloom_.serialize();
-
-    string len_str = varenc::encodeVarint<size_t>(raw.size());
-
     string payload;
+    appendFilterSection(payload, serializeFilter());
 
-
-    payload.reserve(raw.size());
-
-    payload.append(len_str);
-    payload.append(reinterpret_cast<const char*>(raw.data()), raw.size());
+    // Prefiks i range filter idu odmah iza filtera kljuceva, redom, svaki samo uz svoj TOC flag
+    if (has_prefix_filter_) appendFilterSection(payload, serializePrefixFilter());
+    if (has_range_filter_) appendFilterSection(payload, range_filter_.serialize());
+    // Brisanja opsega su uvek poslednja (TOC_VERSION_RANGE_TOMBSTONES), i kada ih nema
+    appendFilterSection(payload, serializeRangeTombstones());
 
     int block_id = start_offset / block_size;
     size_t total_bytes = payload.size();
@@ -534,25 +448,51 @@ void SSTableComp::writeMetaToFile() { // (ili SSTableComp::writeMetaToFile)
     }
 }
 
-void SSTableComp::readBloomFromFile()
+void SSTableComp::readFilterFromFile()
 {
-    uint64_t fileOffset = 0;
-    uint64_t len = 0;
+    // Isti pocetak kao u writeFilterToFile; u single file modu filter nije na pocetku fajla
+    uint64_t fileOffset = is_single_file_mode_ ? toc.filter_offset : 0;
 
-    if (!readNumValue<uint64_t>(len, fileOffset, filterFile_)) {
-        std::cerr << "[SSTableComp::readBloomFromFile] Problem reading bloom length\n";
-        return;
+    std::vector<byte> raw;
+    if (!readFilterSection(fileOffset, raw)) return;
+    loadFilter(raw);
+
+    if (toc.flags & TOC_FLAG_PREFIX_FILTER) {
+        if (!readFilterSection(fileOffset, raw)) return;
+        loadPrefixFilter(raw);
+    }
+    if (toc.flags & TOC_FLAG_RANGE_FILTER) {
+        if (!readFilterSection(fileOffset, raw)) return;
+        loadRangeFilter(raw);
     }
+    if (toc.version >= TOC_VERSION_RANGE_TOMBSTONES) {
+        if (!readFilterSection(fileOffset, raw)) return;
+        loadRangeTombstones(raw);
+    }
+}
 
-    if (len == 0) return;
+void SSTableComp::appendFilterSection(string& payload, const std::vector<byte>& raw) const
+{
+    payload.append(varenc::encodeVarint<size_t>(raw.size()));
+    payload.append(reinterpret_cast<const char*>(raw.data()), raw.size());
+}
 
-    std::vector<byte> raw(len);
-    if (!readBytes(raw.data(), len, fileOffset, filterFile_)) {
-        std::cerr << "[SSTableComp::readBloomFromFile] Problem reading bloomfilter\n";
-        return;
+bool SSTableComp::readFilterSection(uint64_t& offset, std::vector<byte>& raw)
+{
+    uint64_t len = 0;
+    if (!readNumValue<uint64_t>(len, offset, filterFile_)) {
+        std::cerr << "[SSTableComp::readFilterFromFile] Problem reading filter length\n";
+        return false;
     }
 
-    bloom_ = BloomFilter::deserialize(raw);
+    if (len == 0) return false;
+
+    raw.resize(len);
+    if (!readBytes(raw.data(), len, offset, filterFile_)) {
+        std::cerr << "[SSTableComp::readFilterFromFile] Problem reading filter\n";
+        return false;
+    }
+    return true;
 }
 
 void SSTableComp::readSummaryHeader()
@@ -566,13 +506,28 @@ void SSTableComp::readSummaryHeader()
         return;
     }
 
+    keyDict_.clear();
+    if (keyDict()) {
+        uint64_t dict_len = 0;
+        if (!readNumValue<uint64_t>(dict_len, offset, summaryFile_)) {
+            std::cerr << "[SSTableComp::readSummaryHeader] Problem reading key dictionary length\n";
+            return;
+        }
+        keyDict_.resize(dict_len);
+        if (dict_len > 0 && !readBytes(&keyDict_[0], dict_len, offset, summaryFile_)) {
+            std::cerr << "[SSTableComp::readSummaryHeader] Problem reading key dictionary\n";
+            keyDict_.clear();
+            return;
+        }
+    }
+
     uint32_t min_key_id = 0;
     if (!readNumValue<uint32_t>(min_key_id, offset, summaryFile_)) {
         std::cerr << "[SSTableComp::readSummaryHeader] Problem reading min_key\n";
         return;
     }
 
-    summary_.min = id_to_key[min_key_id];
+    summary_.min = keyFor(min_key_id);
 
     uint32_t max_key_id = 0;
     if (!readNumValue<uint32_t>(max_key_id, offset, summaryFile_)) {
@@ -580,12 +535,105 @@ void SSTableComp::readSummaryHeader()
         return;
     }
 
-    summary_.max = id_to_key[max_key_id];
+    summary_.max = keyFor(max_key_id);
 
 
     summary_data_start = offset;
 }
 
+std::string SSTableComp::encodeKeyDict(const std::vector<std::string>& keys)
+{
+    string dict;
+    uint32_t count = keys.size();
+    dict.append(reinterpret_cast<const char*>(&count), sizeof(count));
+
+    uint32_t buckets = (count + KEY_DICT_BUCKET - 1) / KEY_DICT_BUCKET;
+    size_t starts_pos = dict.size();
+    dict.append((size_t)buckets * sizeof(uint32_t), '\0');
+
+    for (uint32_t i = 0; i < count; ++i) {
+        const string& key = keys[i];
+        if (i % KEY_DICT_BUCKET == 0) {
+            uint32_t start = dict.size();
+            std::memcpy(&dict[starts_pos + (i / KEY_DICT_BUCKET) * sizeof(uint32_t)], &start, sizeof(start));
+            dict.append(varenc::encodeVarint<uint64_t>(key.size()));
+            dict.append(key);
+            continue;
+        }
+
+        const string& prev = keys[i - 1];
+        size_t shared = 0;
+        size_t max_shared = std::min(prev.size(), key.size());
+        while (shared < max_shared && prev[shared] == key[shared]) shared++;
+
+        dict.append(varenc::encodeVarint<uint64_t>(shared));
+        dict.append(varenc::encodeVarint<uint64_t>(key.size() - shared));
+        dict.append(key, shared, string::npos);
+    }
+
+    return dict;
+}
+
+std::string SSTableComp::keyFor(uint32_t id)
+{
+    if (!keyDict()) {
+        // Stara tabela: ID je iz globalne key_map
+        if (!legacyIds_ && legacyKeys_) legacyIds_ = &legacyKeys_();
+        if (!legacyIds_ || id >= legacyIds_->size()) {
+            std::cerr << "[SSTableComp::keyFor] Nepoznat ID kljuca " << id << "\n";
+            return "";
+        }
+        return (*legacyIds_)[id];
+    }
+
+    uint32_t count = 0;
+    if (keyDict_.size() < sizeof(count)) return "";
+    std::memcpy(&count, keyDict_.data(), sizeof(count));
+
+    size_t starts_end = sizeof(count) + (size_t)((count + KEY_DICT_BUCKET - 1) / KEY_DICT_BUCKET) * sizeof(uint32_t);
+    if (id >= count || starts_end > keyDict_.size()) {
+        std::cerr << "[SSTableComp::keyFor] Nepoznat ID kljuca " << id << "\n";
+        return "";
+    }
+
+    uint32_t start = 0;
+    std::memcpy(&start, keyDict_.data() + sizeof(count) + (id / KEY_DICT_BUCKET) * sizeof(uint32_t), sizeof(start));
+
+    size_t pos = start;
+    auto readVarint = [&](uint64_t& value) {
+        value = 0;
+        size_t shift = 0;
+        while (pos < keyDict_.size() && shift < 64) {
+            if (varenc::decodeVarint<uint64_t>(keyDict_[pos++], value, shift)) return true;
+        }
+        return false;
+    };
+
+    // Prvi kljuc bucket-a je ceo, ostali samo dopunjuju prethodni
+    string key;
+    uint64_t len = 0;
+    if (!readVarint(len) || len > keyDict_.size() - pos) return "";
+    key.assign(keyDict_, pos, len);
+    pos += len;
+
+    for (uint32_t i = 0; i < id % KEY_DICT_BUCKET; ++i) {
+        uint64_t shared = 0, non_shared = 0;
+        if (!readVarint(shared) || !readVarint(non_shared)) return "";
+        if (shared > key.size() || non_shared > keyDict_.size() - pos) return "";
+        key.resize(shared);
+        key.append(keyDict_, pos, non_shared);
+        pos += non_shared;
+    }
+
+    return key;
+}
+
+uint32_t SSTableComp::idFor(const std::string& key) const
+{
+    auto it = std::lower_bound(buildKeys_.begin(), buildKeys_.end(), key);
+    return static_cast<uint32_t>(it - buildKeys_.begin());
+}
+
 uint64_t SSTableComp::findRecordOffset(const std::string& key, bool& in_file)
 {
     prepare();
@@ -612,7 +660,7 @@ uint64_t SSTableComp::findRecordOffset(const std::string& key, bool& in_file)
     for (int i = 0; i < summary_.count; i++) {
         readNumValue<uint32_t>(r_key_id, file_offset, summaryFile_);
 
-        r_key = id_to_key[r_key_id];
+        r_key = keyFor(r_key_id);
 
 
         if (r_key > key) {
@@ -629,7 +677,7 @@ uint64_t SSTableComp::findRecordOffset(const std::string& key, bool& in_file)
         if (is_single_file_mode_ && file_offset + sizeof(r_key_id) >= toc.summary_offset) break;
         if (!readNumValue<uint32_t>(r_key_id, file_offset, indexFile_)) break;
 
-        r_key = id_to_key[r_key_id];
+        r_key = keyFor(r_key_id);
 
         if (r_key > key) {
             break;
@@ -643,14 +691,6 @@ uint64_t SSTableComp::findRecordOffset(const std::string& key, bool& in_file)
     }
 
     uint64_t fileOffset = off;
-    // const uint64_t header =
-    //     sizeof(uint)
-    //   + sizeof(Wal_record_type)
-    //   + sizeof(uint64_t)
-    //   + sizeof(char)
-    //   + sizeof(uint64_t)
-    //   + sizeof(uint32_t);
-
     const uint64_t header_max_len = sizeof(uint) + sizeof(ull) + 1 + 1 + sizeof(uint64_t) + sizeof(uint32_t);
 
     while (true) {
@@ -663,29 +703,9 @@ uint64_t SSTableComp::findRecordOffset(const std::string& key, bool& in_file)
 
         uint64_t recordStart = fileOffset;
 
-        uint crc = 0;
-        readNumValue<uint>(crc, fileOffset, dataFile_);
-
-        Wal_record_type flag;
-        readBytes(&flag, sizeof(flag), fileOffset, dataFile_);
-
-        uint64_t ts = 0;
-        readNumValue(ts, fileOffset, dataFile_);
-
-        char tomb;
-        readBytes(&tomb, sizeof(tomb), fileOffset, dataFile_);
-        bool isTomb = static_cast<bool>(tomb);
-
-        uint64_t v_size = 0;
-        if (!isTomb) {
-            readBytes(&v_size, sizeof(v_size), fileOffset, dataFile_);
-        }
-
-        uint32_t r_key_id = 0;
-        readNumValue(r_key_id, fileOffset, dataFile_);
-        std::string rkey = id_to_key[r_key_id];
-
-        fileOffset += v_size; // skip value
+        // Zapis podeljen preko blokova se preskace ceo, da nastavak ne bi bio citan kao novi zapis
+        std::string rkey;
+        if (!skipRecord(fileOffset, rkey)) break;
 
         if (rkey == key) {
             return recordStart;
@@ -701,6 +721,47 @@ uint64_t SSTableComp::findRecordOffset(const std::string& key, bool& in_file)
     return std::numeric_limits<uint64_t>::max();
 }
 
+bool SSTableComp::skipRecord(uint64_t& offset, std::string& key)
+{
+    uint64_t start = offset;
+    uint crc = 0;
+    if (!readNumValue<uint>(crc, offset, dataFile_)) return false;
+    uint64_t crc_size = offset - start;
+
+    Wal_record_type flag;
+    if (!readBytes(&flag, sizeof(flag), offset, dataFile_)) return false;
+
+    start = offset;
+    uint64_t ts = 0;
+    if (!readNumValue(ts, offset, dataFile_)) return false;
+    uint64_t ts_size = offset - start;
+
+    char tomb;
+    if (!readBytes(&tomb, sizeof(tomb), offset, dataFile_)) return false;
+    bool isTomb = (std::byte(tomb) & TOMBSTONE_DELETED) != std::byte{ 0 };
+
+    uint64_t v_size = 0;
+    if (!isTomb && !readBytes(&v_size, sizeof(v_size), offset, dataFile_)) return false;
+
+    uint32_t r_key_id = 0;
+    if (!readNumValue(r_key_id, offset, dataFile_)) return false;
+    key = keyFor(r_key_id);
+    offset += v_size;
+
+    // Nastavci imaju isti crc, timestamp i tombstone, a od polja duzine samo deo vrednosti
+    while (flag == Wal_record_type::FIRST || flag == Wal_record_type::MIDDLE) {
+        offset += crc_size;
+        if (!readBytes(&flag, sizeof(flag), offset, dataFile_)) return false;
+        offset += ts_size + sizeof(tomb);
+
+        v_size = 0;
+        if (!isTomb && !readBytes(&v_size, sizeof(v_size), offset, dataFile_)) return false;
+        offset += v_size;
+        if (offset > toc.data_end) return false;
+    }
+    return true;
+}
+
 Record SSTableComp::getNextRecord(uint64_t& offset, bool& error, bool& eof) {
     prepare();
     
@@ -734,7 +795,7 @@ Record SSTableComp::getNextRecord(uint64_t& offset, bool& error, bool& eof) {
     char tomb;
     readBytes(&tomb, sizeof(tomb), offset, dataFile_);
 
-    bool isTomb = (bool)tomb;
+    bool isTomb = (std::byte(tomb) & TOMBSTONE_DELETED) != std::byte{ 0 };
 
     uint64_t v_size = 0;
     if(!isTomb) readBytes(&v_size, sizeof(v_size), offset, dataFile_);
@@ -744,7 +805,7 @@ Record SSTableComp::getNextRecord(uint64_t& offset, bool& error, bool& eof) {
     readNumValue(r_key_id, offset, dataFile_);
     uint64_t r_key_size = offset - start;
 
-    string rkey = id_to_key[r_key_id];
+    string rkey = keyFor(r_key_id);
 
     std::string rvalue;
     rvalue.resize(v_size);
@@ -791,7 +852,7 @@ Record SSTableComp::getNextRecord(uint64_t& offset, bool& error, bool& eof) {
     return r;
 }
 
-bool SSTableComp::validate() {
+bool SSTableComp::validateRecords() {
     // 1. Učitavamo metapodatke (TOC i Merkle stablo)
     prepare();
     readMetaFromFile();
@@ -804,7 +865,7 @@ bool SSTableComp::validate() {
     }
 
     std::cout << "\n[Validate] Započeta validacija za SSTable: " << dataFile_ << std::endl;
-    std::cout << "[Validate] Očekivani (sačuvani) Root Hash: " << rootHash_ << std::endl;
+    std::cout << "[Validate] Očekivani (sačuvani) Root Hash: " << printableHash(rootHash_) << std::endl;
 
     // 3. Čitamo sve rekorde iz data fajla da bismo rekonstruisali stanje
     std::vector<Record> records;
@@ -822,22 +883,17 @@ bool SSTableComp::validate() {
         }
     }
 
-    // 4. Kreiramo novo Merkle stablo od trenutnih vrednosti u fajlu
-    std::vector<std::string> currentValues;
-    currentValues.reserve(records.size());
-    for (const auto& rec : records) {
-        currentValues.push_back(std::string(reinterpret_cast<const char*>(rec.value.data()), rec.value.size()));
-    }
-
     // Ako nema rekorda, a imamo root hash, to je greška
-    if (currentValues.empty() && !rootHash_.empty()) {
+    if (records.empty() && !rootHash_.empty()) {
         std::cout << "[Validate] GREŠKA: Tabela bi trebalo da sadrži podatke, ali je prazna!" << std::endl;
         return false;
     }
 
-    MerkleTree newMerkleTree(currentValues);
-    std::string newRootHash = newMerkleTree.getRootHash();
-    std::cout << "[Validate] Trenutni (izračunati) Root Hash:  " << newRootHash << std::endl;
+    // 4. Kreiramo novo Merkle stablo od trenutnih vrednosti u fajlu
+    std::string newRootHash;
+    std::vector<std::string> newLeafHashes;
+    computeMerkle(records, newRootHash, newLeafHashes);
+    std::cout << "[Validate] Trenutni (izračunati) Root Hash:  " << printableHash(newRootHash) << std::endl;
 
     // 5. Poredimo root hasheve
     if (newRootHash == rootHash_) {
@@ -847,7 +903,6 @@ bool SSTableComp::validate() {
 
     // 6. Ako hashevi NISU isti, započinjemo detaljnu analizu problema
     std::cout << "[Validate] GREŠKA: Podaci u SSTable su izmenjeni! Detaljna analiza:" << std::endl;
-    std::vector<std::string> newLeafHashes = newMerkleTree.getLeaves();
 
     size_t max_leaves = std::max(originalLeafHashes_.size(), newLeafHashes.size());
 
@@ -860,8 +915,8 @@ bool SSTableComp::validate() {
             if (originalLeafHashes_[i] != newLeafHashes[i]) {
                 std::cout << "  -> IZMENA na rekordu sa indeksom " << i << "." << std::endl;
                 std::cout << "     Ključ rekorda: " << records[i].key << std::endl;
-                std::cout << "     Originalni hash vrednosti: " << originalLeafHashes_[i] << std::endl;
-                std::cout << "     Trenutni hash vrednosti:   " << newLeafHashes[i] << std::endl;
+                std::cout << "     Originalni hash vrednosti: " << printableHash(originalLeafHashes_[i]) << std::endl;
+                std::cout << "     Trenutni hash vrednosti:   " << printableHash(newLeafHashes[i]) << std::endl;
             }
         }
         else if (original_exists && !new_exists) {
@@ -873,7 +928,7 @@ bool SSTableComp::validate() {
             // Slučaj 3: Hash ne postoji u originalu, ali postoji u novoj verziji -> Rekord je dodat
             std::cout << "  -> DODAT novi rekord na indeksu " << i << "." << std::endl;
             std::cout << "     Ključ rekorda: " << records[i].key << std::endl;
-            std::cout << "     Hash vrednosti: " << newLeafHashes[i] << std::endl;
+            std::cout << "     Hash vrednosti: " << printableHash(newLeafHashes[i]) << std::endl;
         }
     }
 
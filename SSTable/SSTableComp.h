@@ -7,6 +7,7 @@
 #include <stdexcept>
 #include <iostream>
 #include <map>
+#include <functional>
 //#include <additional/sha.h> // OpenSSL za SHA256 heširanje
 
 #include "../Wal/wal.h"
@@ -16,6 +17,10 @@
 
 class SSTableComp : public SSTable {
 public:
+    // Kljucevi globalne key_map (po ID-u), potrebni samo tabelama bez TOC_FLAG_KEY_DICT.
+    // Poziva se tek kada zatreba, pa se stara mapa ne cita dok se ne otvori stara tabela.
+    using LegacyKeyLoader = std::function<const std::vector<std::string>& ()>;
+
     /*
      * Konstruktor prima putanje do tri fajla:
      *  - dataFile (npr. "data.sst")
@@ -29,16 +34,12 @@ public:
         const std::string& summaryFile,
         const std::string& metaFile,
         Block_manager* bmp,
-        unordered_map<string, uint32_t>& key_to_id,
-        vector<string>& id_to_key,
-        uint32_t& nextId);
+        LegacyKeyLoader legacyKeys);
 
 
     SSTableComp(const std::string& dataFile,
         Block_manager* bmp,
-        unordered_map<string, uint32_t>& map,
-        vector<string>& id_to_key,
-        uint32_t& nextId);
+        LegacyKeyLoader legacyKeys);
 
     /**
      * build(...) - gradi SSTable iz niza Record-ova (npr. dobijenih iz memtable).
@@ -66,34 +67,59 @@ public:
 
     Record getNextRecord(uint64_t& offset, bool& error, bool& eof) override;
     
-    bool validate() override;
-    
     uint64_t findRecordOffset(const std::string& key, bool& in_file) override;
 
 protected:
     std::vector<IndexEntry> writeDataMetaFiles(std::vector<Record>& sortedRecords) override;
+    bool validateRecords() override;
 
     // Snima 'index_' u indexFile_
     std::vector<IndexEntry> writeIndexToFile() override;
 
     // void readIndexFromFile();
 
-    // Snima 'bloom_' u filterFile_
-    void writeBloomToFile() override;
+    // Snima filter u filterFile_
+    void writeFilterToFile() override;
 
-    // Ucitava 'bloom_' iz filterFile_ ako vec nije
-    void readBloomFromFile() override;
+    // Ucitava filter iz filterFile_
+    void readFilterFromFile() override;
     void readSummaryHeader() override;
 
     void writeSummaryToFile() override;
     void writeMetaToFile() override;
     void readMetaFromFile() override;
 
+    // Deo filter fajla: [varint duzina][bajtovi] (filter kljuceva, pa prefiks i range filter)
+    void appendFilterSection(string& payload, const std::vector<byte>& raw) const;
+    bool readFilterSection(uint64_t& offset, std::vector<byte>& raw);
+
 
     uint64_t summary_data_start;
 
-    unordered_map<string, uint32_t>& key_to_id;
-    vector<string>& id_to_key;
-    uint32_t& nextID;
+    /**
+     * Recnik kljuceva (TOC_FLAG_KEY_DICT), u summary delu odmah iza broja summary unosa:
+     *   [varint duzina] [uint32 n] [uint32 pocetak bucket-a]*ceil(n / KEY_DICT_BUCKET) [bucket-i]
+     *   bucket: [varint duzina][prvi kljuc], pa za ostale [varint shared][varint non_shared][sufiks]
+     * U recniku su svi razliciti kljucevi tabele, sortirani, pa je ID kljuca njegov redni broj.
+     * Kljuc po ID-u se dekodira iz jednog bucket-a (front coding), a recnik je u memoriji
+     * samo dok je tabela otvorena.
+     */
+    static constexpr uint32_t KEY_DICT_BUCKET = 16;
+
+    bool keyDict() const { return (toc.flags & TOC_FLAG_KEY_DICT) != 0; }
+    static std::string encodeKeyDict(const std::vector<std::string>& keys);
+    // Kljuc sa ID-em id, iz recnika tabele ili (stare tabele) iz globalne mape; "" za nepoznat ID
+    std::string keyFor(uint32_t id);
+    // ID kljuca tabele koja se upravo gradi
+    uint32_t idFor(const std::string& key) const;
+
+    std::vector<std::string> buildKeys_; // kljucevi tabele, samo dok traje build
+    std::string keyDict_;                // ucitan recnik, bez polja duzine
+
+    // Prelazi preko zapisa na offsetu (i njegovih nastavaka u sledecim blokovima ako je podeljen),
+    // bez citanja vrednosti. key je kljuc zapisa; false ako zapis ne moze da se procita.
+    bool skipRecord(uint64_t& offset, std::string& key);
 
+    LegacyKeyLoader legacyKeys_;
+    const std::vector<std::string>* legacyIds_ = nullptr;
 };
\ No newline at end of file
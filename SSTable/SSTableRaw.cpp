@@ -1,7 +1,9 @@
 ﻿#include "SSTableRaw.h"
 #include "../Utils/VarEncoding.h"
+#include "../MurmurHash3/MurmurHash3.h"
 // #include "../LSM/SSTableIterator.h"
 #include <filesystem>
+#include <string_view>
 
 SSTableRaw::SSTableRaw(const std::string& dataFile,
 	const std::string& indexFile,
@@ -105,6 +107,23 @@ vector<Record> SSTableRaw::get(const std::string& key) {
     prepare();
     vector<Record> matches;
 
+    if (blockFormat()) {
+        // Kljucevi u tabeli su jedinstveni, pa je dovoljan jedan zapis
+        bool found, error = false, eof = false;
+        Record hashed;
+        if (getWithBlockHash(key, found, hashed)) {
+            if (found) matches.push_back(hashed);
+            return matches;
+        }
+
+        uint64_t offset = findRecordOffset(key, found);
+        if (!found) return matches;
+
+        Record r = getNextRecordFromBlock(offset, error, eof);
+        if (!error) matches.push_back(r);
+        return matches;
+    }
+
     // 3) binarna pretraga -> offset
     bool found;
     uint64_t fileOffset = findRecordOffset(key, found);
@@ -211,15 +230,15 @@ vector<Record> SSTableRaw::get(const std::string& key) {
 std::vector<IndexEntry>
 SSTableRaw::writeDataMetaFiles(std::vector<Record>& sortedRecords)
 {
+    if (Config::sstable_block_format) {
+        return writeDataBlocks(sortedRecords);
+    }
+
     toc.data_offset = (sizeof(toc)/block_size + 1)*block_size; // Mesto za toc
 
     std::vector<IndexEntry> ret;
     ret.reserve(sortedRecords.size());
 
-    // Merkle tree
-    std::vector<std::string> data_for_merkle;
-    data_for_merkle.reserve(sortedRecords.size());
-
     ull offset = toc.data_offset;
 
     int block_id = toc.data_offset/block_size;
@@ -235,9 +254,6 @@ SSTableRaw::writeDataMetaFiles(std::vector<Record>& sortedRecords)
 
     for (auto& r : sortedRecords) {
 
-        data_for_merkle.push_back(r.key + r.value);
-
-    
         IndexEntry ie;
         ie.key = r.key;
         ie.offset = offset;
@@ -255,7 +271,7 @@ SSTableRaw::writeDataMetaFiles(std::vector<Record>& sortedRecords)
             // concat.insert(concat.end(), remaining, (byte)0); write_block valjda vec paduje
             offset += remaining;
 
-            bmp->write_block({block_id++, dataFile_}, concat);
+            writeDataBlock(block_id++, concat);
             concat.clear();
             remaining = block_size;
         }
@@ -297,7 +313,7 @@ SSTableRaw::writeDataMetaFiles(std::vector<Record>& sortedRecords)
  
 
             // Flushujemo blok
-            bmp->write_block({block_id++, dataFile_}, concat);
+            writeDataBlock(block_id++, concat);
             concat.clear();
 
             rec.key = rec.key.substr(key_written);
@@ -345,7 +361,7 @@ SSTableRaw::writeDataMetaFiles(std::vector<Record>& sortedRecords)
                 
                 if (flag == Wal_record_type::MIDDLE){
                     // Flushujemo blok
-                    bmp->write_block({block_id++, dataFile_}, concat);
+                    writeDataBlock(block_id++, concat);
                     concat.clear();
 
 
@@ -376,31 +392,58 @@ SSTableRaw::writeDataMetaFiles(std::vector<Record>& sortedRecords)
 
             // Flush
             if(remaining==len){
-                bmp->write_block({block_id++, dataFile_}, concat);
+                writeDataBlock(block_id++, concat);
                 concat.clear();
             }
         }
     }
 
     if (!concat.empty()) 
-        bmp->write_block({block_id, dataFile_}, concat);
+        writeDataBlock(block_id, concat);
 
     if(is_single_file_mode_) toc.index_offset = (block_id+1)*block_size;
     toc.data_end = block_id*block_size + concat.size();
 
+    // Merkle stablo pravi build, nad vrednostima zapisa
+    return ret;
+}
 
-    if (!data_for_merkle.empty()) {
-        try {
-            MerkleTree merkle_tree(data_for_merkle);
-            this->rootHash_ = merkle_tree.getRootHash();
-            this->originalLeafHashes_ = merkle_tree.getLeaves();
-            std::cout << "[SSTable] Merkle Tree created with root: " << this->rootHash_ << std::endl;
+std::vector<IndexEntry> SSTableRaw::appendIndexPartitions(const std::vector<IndexEntry>& entries, size_t minEntries, std::string& payload) const
+{
+    // Jedan unos po particiji, offset je relativan u odnosu na pocetak indeksa
+    std::vector<IndexEntry> ret;
+
+    size_t from = 0;
+    while (from < entries.size()) {
+        // Particiju (sa duzinom ispred) punimo do block_size bajtova, ali u njoj je uvek
+        // bar minEntries kljuceva, da bi svaki sledeci nivo bio manji
+        size_t to = from;
+        size_t bytes = 2 * sizeof(uint32_t);
+        while (to < entries.size()) {
+            size_t entry_len = sizeof(uint32_t) + sizeof(uint64_t) + entries[to].key.size();
+            if (to - from >= minEntries && bytes + entry_len > static_cast<size_t>(block_size)) break;
+            bytes += entry_len;
+            to++;
         }
-        catch (const std::exception& e) {
-            std::cerr << "Error creating Merkle Tree: " << e.what() << std::endl;
+
+        // Particija koja ne staje u ostatak bloka pocinje od sledeceg bloka
+        size_t used = payload.size() % block_size;
+        if (used > 0 && used + bytes > static_cast<size_t>(block_size)) {
+            payload.append(block_size - used, '\0');
         }
-    }
 
+        IndexEntry partEntry;
+        partEntry.key = entries[from].key;
+        partEntry.offset = payload.size();
+        ret.push_back(partEntry);
+
+        string block = encodeKeyBlock(entries, from, to);
+        uint32_t len = block.size();
+        payload.append(reinterpret_cast<const char*>(&len), sizeof(len));
+        payload.append(block);
+
+        from = to;
+    }
 
     return ret;
 }
@@ -409,41 +452,32 @@ std::vector<IndexEntry> SSTableRaw::writeIndexToFile()
 {
     uint64_t start_offset = toc.index_offset; // Set in data writer
 
-
-    std::vector<IndexEntry> ret;
-
     string payload;
 
-    uint64_t count = index_.size();
-    payload.append(reinterpret_cast<char*>(&count), sizeof(count));
-
-    uint64_t offset = 8ULL;
-
-    for (auto& ie : index_) {
-        IndexEntry summEntry;
-        summEntry.key = ie.key;
-        summEntry.offset = offset;
-        ret.push_back(summEntry);
+    // Particije nad index_, pa nad njima nivoi particija dok koren ne stane u jedan blok
+    std::vector<IndexEntry> ret = appendIndexPartitions(index_, 1, payload);
+    indexLevels_ = 1;
 
-        uint64_t kSize = ie.key.size();
-        payload.append(reinterpret_cast<char*>(&kSize), sizeof(kSize));
-        payload.append(ie.key.data(), kSize);
-        payload.append(reinterpret_cast<char*>(&ie.offset), sizeof(ie.offset));
-
-        offset += sizeof(kSize) + kSize + sizeof(ie.offset);
+    auto rootSize = [](const std::vector<IndexEntry>& entries) {
+        size_t bytes = 2 * sizeof(uint32_t);
+        for (const auto& e : entries) bytes += sizeof(uint32_t) + sizeof(uint64_t) + e.key.size();
+        return bytes;
+    };
+    while (ret.size() > 1 && rootSize(ret) > static_cast<size_t>(block_size)) {
+        ret = appendIndexPartitions(ret, 2, payload);
+        indexLevels_++;
     }
 
+    // Summary je koren indeksa i pokazuje na svaku particiju najviseg nivoa
+    summary_sparsity = 1;
+
     int block_id = start_offset/block_size;
     size_t total_bytes = payload.size();
-    offset = 0;
+    size_t offset = 0;
 
     while (offset + block_size <= total_bytes) {
         string chunk = payload.substr(offset, block_size);
         bmp->write_block({block_id++, indexFile_}, chunk);
-
-        const uint64_t* val = reinterpret_cast<const uint64_t*>(chunk.data());
-        std::cout << *val << "\n";
-        
         offset += block_size;
     }
 
@@ -472,14 +506,13 @@ void SSTableRaw::writeSummaryToFile() {
     payload.append(summary_.min);
     payload.append(summary_.max);
 
+    uint32_t levels = indexLevels_;
+    payload.append(reinterpret_cast<const char*>(&levels), sizeof(levels));
 
-    for (auto& summEntry : summary_.summary) {
-        uint64_t kSize = summEntry.key.size();
-        payload.append(reinterpret_cast<char*>(&kSize), sizeof(kSize));
-        payload.append(summEntry.key.data(), kSize);
-        payload.append(reinterpret_cast<char*>(&summEntry.offset), sizeof(summEntry.offset));
-
-    }
+    string block = encodeKeyBlock(summary_.summary, 0, summary_.summary.size());
+    uint32_t len = block.size();
+    payload.append(reinterpret_cast<const char*>(&len), sizeof(len));
+    payload.append(block);
 
     int block_id = start_offset/block_size;
     uint64_t total_bytes = payload.size();
@@ -531,22 +564,19 @@ void SSTableRaw::readMetaFromFile() {
     }
 }
 
-void SSTableRaw::writeBloomToFile()
+void SSTableRaw::writeFilterToFile()
 {
     uint64_t start_offset = toc.filter_offset; // Set in summary writer
 
 
-    std::vector<byte> raw = bloom_.serialize();
-
-    uint64_t len = raw.size();
-
     string payload;
+    appendFilterSection(payload, serializeFilter());
 
-    payload.append(reinterpret_cast<const char*>(&len), sizeof(len));
-
-    for (const auto& i : raw) {
-        payload.append(reinterpret_cast<const char*>(&i), sizeof(i));
-    }
+    // Prefiks i range filter idu odmah iza filtera kljuceva, redom, svaki samo uz svoj TOC flag
+    if (has_prefix_filter_) appendFilterSection(payload, serializePrefixFilter());
+    if (has_range_filter_) appendFilterSection(payload, range_filter_.serialize());
+    // Brisanja opsega su uvek poslednja (TOC_VERSION_RANGE_TOMBSTONES), i kada ih nema
+    appendFilterSection(payload, serializeRangeTombstones());
 
     int block_id = start_offset/block_size;
     size_t total_bytes = payload.size();
@@ -601,23 +631,46 @@ void SSTableRaw::writeMetaToFile() { // (ili SSTableComp::writeMetaToFile)
 }
 
 
-void SSTableRaw::readBloomFromFile()
+void SSTableRaw::readFilterFromFile()
 {
     uint64_t fileOffset = 0;
 
     fileOffset = toc.filter_offset;
 
-    uint64_t len = 0;
-    if (!readBytes(&len, sizeof(len), fileOffset, filterFile_) || len == 0) {
-        return;
+    std::vector<byte> raw;
+    if (!readFilterSection(fileOffset, raw)) return;
+    loadFilter(raw);
+
+    if (toc.flags & TOC_FLAG_PREFIX_FILTER) {
+        if (!readFilterSection(fileOffset, raw)) return;
+        loadPrefixFilter(raw);
+    }
+    if (toc.flags & TOC_FLAG_RANGE_FILTER) {
+        if (!readFilterSection(fileOffset, raw)) return;
+        loadRangeFilter(raw);
+    }
+    if (toc.version >= TOC_VERSION_RANGE_TOMBSTONES) {
+        if (!readFilterSection(fileOffset, raw)) return;
+        loadRangeTombstones(raw);
     }
+}
 
-    std::vector<byte> raw(len);
-    if (!readBytes(raw.data(), len, fileOffset, filterFile_)) {
-        return;
+void SSTableRaw::appendFilterSection(string& payload, const std::vector<byte>& raw) const
+{
+    uint64_t len = raw.size();
+    payload.append(reinterpret_cast<const char*>(&len), sizeof(len));
+    payload.append(reinterpret_cast<const char*>(raw.data()), raw.size());
+}
+
+bool SSTableRaw::readFilterSection(uint64_t& offset, std::vector<byte>& raw)
+{
+    uint64_t len = 0;
+    if (!readBytes(&len, sizeof(len), offset, filterFile_) || len == 0) {
+        return false;
     }
 
-    bloom_ = BloomFilter::deserialize(raw);
+    raw.resize(len);
+    return readBytes(raw.data(), len, offset, filterFile_);
 }
 
 void SSTableRaw::readSummaryHeader()
@@ -678,49 +731,11 @@ uint64_t SSTableRaw::findRecordOffset(const std::string& key, bool& found)
         return toc.data_offset;
     }
 
-    size_t fileOffset = toc.summary_offset + summary_.min.size() + summary_.max.size() + 3*sizeof(uint64_t);
-    
-    uint64_t kSize;
-    bool error;
-
-    uint64_t offset_in_index = 0ULL;
-    
-    string rKey;
-    for(int i = 0; i < summary_.count; i++) {
-        readBytes(&kSize, sizeof(kSize), fileOffset, summaryFile_);
-
-        rKey.resize(kSize);
-        readBytes(&rKey[0], kSize, fileOffset, summaryFile_);
-
-        if(rKey > key) {
-            break;
-        }
-
-        readBytes(&offset_in_index, sizeof(offset_in_index), fileOffset, summaryFile_);
+    if (blockFormat()) {
+        return findRecordOffsetInBlocks(key, found);
     }
 
-    fileOffset = offset_in_index + toc.index_offset;
-    uint64_t offset_in_data;
-
-
-    for(;;) {
-        readBytes(&kSize, sizeof(kSize), fileOffset, indexFile_);
-        
-        rKey.resize(kSize);
-        readBytes(&rKey[0], kSize, fileOffset, indexFile_);
-
-        if (rKey > key) {
-            break;
-        }
-
-        readBytes(&offset_in_data, sizeof(offset_in_data), fileOffset, indexFile_);
-
-        if (rKey == key) {
-            break;
-        }
-    }
-
-    fileOffset = offset_in_data;
+    uint64_t fileOffset = findDataOffsetInIndex(key);
 
     const uint64_t header_len =  sizeof(uint) + sizeof(ull) + 1 + 1 + sizeof(ull) + sizeof(ull);
 
@@ -822,8 +837,91 @@ uint64_t SSTableRaw::findRecordOffset(const std::string& key, bool& found)
     return std::numeric_limits<uint64_t>::max();
 }
 
+uint64_t SSTableRaw::findDataOffsetInIndex(const std::string& key)
+{
+    if (toc.version >= TOC_VERSION_KEY_BLOCKS) {
+        if (summaryBlock_.empty()) {
+            uint64_t offset = toc.summary_offset + summary_.min.size() + summary_.max.size() + 3*sizeof(uint64_t);
+            indexLevels_ = 1;
+            if (toc.version >= TOC_VERSION_PARTITIONED_INDEX &&
+                !readBytes(&indexLevels_, sizeof(indexLevels_), offset, summaryFile_)) {
+                std::cerr << "[SSTableRaw::findRecordOffset] Problem reading index levels\n";
+                return toc.data_offset;
+            }
+            if (!readKeyBlock(offset, summaryFile_, summaryBlock_)) {
+                std::cerr << "[SSTableRaw::findRecordOffset] Problem reading summary block\n";
+                return toc.data_offset;
+            }
+        }
+
+        // Koren (summary) -> particije indeksa, nivo po nivo -> offset u data fajlu,
+        // u svakom koraku binarna pretraga. Particije se citaju kroz kes blokova.
+        uint64_t offset = 0;
+        searchKeyBlock(summaryBlock_, key, offset);
+
+        string indexBlock;
+        for (uint32_t level = 0; level < indexLevels_; ++level) {
+            uint64_t fileOffset = toc.index_offset + offset;
+            if (!readKeyBlock(fileOffset, indexFile_, indexBlock)) {
+                std::cerr << "[SSTableRaw::findRecordOffset] Problem reading index block\n";
+                return toc.data_offset;
+            }
+            searchKeyBlock(indexBlock, key, offset);
+        }
+        return offset;
+    }
+
+    // Stari format (verzija 1): summary i index se citaju kljuc po kljuc
+    size_t fileOffset = toc.summary_offset + summary_.min.size() + summary_.max.size() + 3*sizeof(uint64_t);
+    
+    uint64_t kSize;
+
+    uint64_t offset_in_index = 0ULL;
+    
+    string rKey;
+    for(int i = 0; i < summary_.count; i++) {
+        readBytes(&kSize, sizeof(kSize), fileOffset, summaryFile_);
+
+        rKey.resize(kSize);
+        readBytes(&rKey[0], kSize, fileOffset, summaryFile_);
+
+        if(rKey > key) {
+            break;
+        }
+
+        readBytes(&offset_in_index, sizeof(offset_in_index), fileOffset, summaryFile_);
+    }
+
+    fileOffset = offset_in_index + toc.index_offset;
+    uint64_t offset_in_data;
+
+
+    for(;;) {
+        readBytes(&kSize, sizeof(kSize), fileOffset, indexFile_);
+        
+        rKey.resize(kSize);
+        readBytes(&rKey[0], kSize, fileOffset, indexFile_);
+
+        if (rKey > key) {
+            break;
+        }
+
+        readBytes(&offset_in_data, sizeof(offset_in_data), fileOffset, indexFile_);
+
+        if (rKey == key) {
+            break;
+        }
+    }
+
+    return offset_in_data;
+}
+
 Record SSTableRaw::getNextRecord(uint64_t& offset, bool& error, bool& eof) {
 
+    if (blockFormat()) {
+        return getNextRecordFromBlock(offset, error, eof);
+    }
+
     const uint64_t header_len =  sizeof(uint) + sizeof(ull) + 1 + 1 + sizeof(ull) + sizeof(ull);
     // TODO: OVAJ DEO TREBA POPRAVITI, ovaj drugi. Za sada ga ignorisem
     if (offset >= toc.data_end /* || offset < toc.data_offset*/) {
@@ -914,7 +1012,7 @@ Record SSTableRaw::getNextRecord(uint64_t& offset, bool& error, bool& eof) {
     return r;
 }
 
-bool SSTableRaw::validate() {
+bool SSTableRaw::validateRecords() {
     // 1. Učitavamo metapodatke (TOC i Merkle stablo)
     prepare();
     readMetaFromFile();
@@ -927,7 +1025,7 @@ bool SSTableRaw::validate() {
     }
 
     std::cout << "\n[Validate] Započeta validacija za SSTable: " << dataFile_ << std::endl;
-    std::cout << "[Validate] Očekivani (sačuvani) Root Hash: " << rootHash_ << std::endl;
+    std::cout << "[Validate] Očekivani (sačuvani) Root Hash: " << printableHash(rootHash_) << std::endl;
 
     // 3. Čitamo sve rekorde iz data fajla da bismo rekonstruisali stanje
     std::vector<Record> records;
@@ -943,22 +1041,17 @@ bool SSTableRaw::validate() {
         records.push_back(rec);
     }
 
-    // 4. Kreiramo novo Merkle stablo od trenutnih vrednosti u fajlu
-    std::vector<std::string> currentValues;
-    currentValues.reserve(records.size());
-    for (const auto& rec : records) {
-        currentValues.push_back(std::string(reinterpret_cast<const char*>(rec.value.data()), rec.value.size()));
-    }
-
     // Ako nema rekorda, a imamo root hash, to je greška
-    if (currentValues.empty() && !rootHash_.empty()) {
+    if (records.empty() && !rootHash_.empty()) {
         std::cout << "[Validate] GREŠKA: Tabela bi trebalo da sadrži podatke, ali je prazna!" << std::endl;
         return false;
     }
 
-    MerkleTree newMerkleTree(currentValues);
-    std::string newRootHash = newMerkleTree.getRootHash();
-    std::cout << "[Validate] Trenutni (izračunati) Root Hash:  " << newRootHash << std::endl;
+    // 4. Kreiramo novo Merkle stablo od trenutnih vrednosti u fajlu
+    std::string newRootHash;
+    std::vector<std::string> newLeafHashes;
+    computeMerkle(records, newRootHash, newLeafHashes);
+    std::cout << "[Validate] Trenutni (izračunati) Root Hash:  " << printableHash(newRootHash) << std::endl;
 
     // 5. Poredimo root hasheve
     if (newRootHash == rootHash_) {
@@ -968,7 +1061,6 @@ bool SSTableRaw::validate() {
 
     // 6. Ako hashevi NISU isti, započinjemo detaljnu analizu problema
     std::cout << "[Validate] GREŠKA: Podaci u SSTable su izmenjeni! Detaljna analiza:" << std::endl;
-    std::vector<std::string> newLeafHashes = newMerkleTree.getLeaves();
 
     size_t max_leaves = std::max(originalLeafHashes_.size(), newLeafHashes.size());
 
@@ -981,8 +1073,8 @@ bool SSTableRaw::validate() {
             if (originalLeafHashes_[i] != newLeafHashes[i]) {
                 std::cout << "  -> IZMENA na rekordu sa indeksom " << i << "." << std::endl;
                 std::cout << "     Ključ rekorda: " << records[i].key << std::endl;
-                std::cout << "     Originalni hash vrednosti: " << originalLeafHashes_[i] << std::endl;
-                std::cout << "     Trenutni hash vrednosti:   " << newLeafHashes[i] << std::endl;
+                std::cout << "     Originalni hash vrednosti: " << printableHash(originalLeafHashes_[i]) << std::endl;
+                std::cout << "     Trenutni hash vrednosti:   " << printableHash(newLeafHashes[i]) << std::endl;
             }
         }
         else if (original_exists && !new_exists) {
@@ -994,9 +1086,570 @@ bool SSTableRaw::validate() {
             // Slučaj 3: Hash ne postoji u originalu, ali postoji u novoj verziji -> Rekord je dodat
             std::cout << "  -> DODAT novi rekord na indeksu " << i << "." << std::endl;
             std::cout << "     Ključ rekorda: " << records[i].key << std::endl;
-            std::cout << "     Hash vrednosti: " << newLeafHashes[i] << std::endl;
+            std::cout << "     Hash vrednosti: " << printableHash(newLeafHashes[i]) << std::endl;
         }
     }
 
     return false;
-}
\ No newline at end of file
+}
+
+// ----- Blok format data dela -----
+
+std::vector<IndexEntry>
+SSTableRaw::writeDataBlocks(std::vector<Record>& sortedRecords)
+{
+    toc.data_offset = (sizeof(toc)/block_size + 1)*block_size; // Mesto za toc
+    toc.flags |= TOC_FLAG_BLOCK_FORMAT;
+
+    const size_t restart_interval = std::max(1, Config::block_restart_interval);
+
+    const BlockCodec* codec = BlockCodec::byName(Config::block_compression);
+    if (codec == nullptr) {
+        std::cerr << "[SSTableRaw] Nepoznat kodek '" << Config::block_compression << "', blokovi ostaju nekompresovani\n";
+    }
+    else if (codec->id() != CodecId::None) {
+        toc.flags |= TOC_FLAG_BLOCK_CODEC;
+    }
+    string compressed;
+
+    std::vector<IndexEntry> ret;
+    ret.reserve(sortedRecords.size());
+
+    string payload; // ceo data deo, na kraju se deli na blokove block managera
+    string block;
+    std::vector<uint32_t> restarts;
+    std::vector<std::pair<uint32_t, uint8_t>> keyHashes; // (hes kljuca, restart tacka) za hes indeks
+    string prevKey;
+    size_t counter = 0;
+
+    auto append_field = [&](const void* data, size_t len) {
+        block.append(reinterpret_cast<const char*>(data), len);
+    };
+
+    auto finish_block = [&]() {
+        for (uint32_t restart : restarts) {
+            append_field(&restart, sizeof(restart));
+        }
+        uint32_t restart_count = restarts.size();
+
+        // Kanta pamti restart tacku u bajtu, pa blok sa previse restart tacaka ostaje bez hes indeksa
+        if (Config::block_hash_index && restart_count < HASH_BUCKET_COLLISION) {
+            // Oko 0.75 kljuceva po kanti
+            uint16_t bucket_count = static_cast<uint16_t>(std::min<size_t>(keyHashes.size() * 4 / 3 + 1, 65535));
+            string buckets(bucket_count, static_cast<char>(HASH_BUCKET_EMPTY));
+            for (const auto& [hash, restart] : keyHashes) {
+                uint8_t& bucket = reinterpret_cast<uint8_t&>(buckets[hash % bucket_count]);
+                if (bucket == HASH_BUCKET_EMPTY) bucket = restart;
+                else if (bucket != restart) bucket = HASH_BUCKET_COLLISION;
+            }
+            block.append(buckets);
+            append_field(&bucket_count, sizeof(bucket_count));
+            restart_count |= BLOCK_HASH_INDEX_FLAG;
+        }
+        append_field(&restart_count, sizeof(restart_count));
+
+        if (blockCodec()) {
+            // Kompresovan blok ostaje samo ako je kraci i ima bar bajt po zapisu (offset je redni broj zapisa)
+            const BlockCodec* used = codec;
+            codec->compress(block, compressed);
+            if (compressed.size() >= block.size() || compressed.size() < counter) {
+                used = BlockCodec::byId(static_cast<uint8_t>(CodecId::None));
+                compressed = block;
+            }
+            compressed.push_back(static_cast<char>(used->id()));
+            block.swap(compressed);
+        }
+
+        uint32_t len = block.size();
+        payload.append(reinterpret_cast<const char*>(&len), sizeof(len));
+        payload.append(block);
+
+        block.clear();
+        restarts.clear();
+        keyHashes.clear();
+        counter = 0;
+    };
+
+    for (auto& r : sortedRecords) {
+        size_t shared = 0;
+        if (counter % restart_interval == 0) {
+            restarts.push_back(block.size());
+        }
+        else {
+            size_t limit = std::min(prevKey.size(), r.key.size());
+            while (shared < limit && prevKey[shared] == r.key[shared]) shared++;
+        }
+
+        if (Config::block_hash_index && restarts.size() < HASH_BUCKET_COLLISION) {
+            keyHashes.emplace_back(blockKeyHash(r.key), static_cast<uint8_t>(restarts.size() - 1));
+        }
+
+        // Index pokazuje na pocetak bloka, unutar bloka se trazi preko restart tacaka
+        IndexEntry ie;
+        ie.key = r.key;
+        ie.offset = toc.data_offset + payload.size();
+        ret.push_back(ie);
+
+        block.append(varenc::encodeVarint<uint64_t>(shared));
+        block.append(varenc::encodeVarint<uint64_t>(r.key.size() - shared));
+        block.append(varenc::encodeVarint<uint64_t>(r.value.size()));
+        append_field(&r.timestamp, sizeof(r.timestamp));
+        append_field(&r.tombstone, sizeof(r.tombstone));
+        append_field(&r.crc, sizeof(r.crc));
+        block.append(r.key, shared, string::npos);
+        block.append(r.value);
+
+        prevKey = r.key;
+        counter++;
+
+        if (block.size() >= static_cast<size_t>(block_size)) {
+            finish_block();
+        }
+    }
+
+    if (!block.empty()) finish_block();
+
+    int block_id = toc.data_offset/block_size;
+    for (size_t offset = 0; offset < payload.size(); offset += block_size) {
+        writeDataBlock(block_id++, payload.substr(offset, block_size));
+    }
+
+    toc.data_end = toc.data_offset + payload.size();
+    if(is_single_file_mode_) toc.index_offset = block_id*block_size;
+
+    return ret;
+}
+
+bool SSTableRaw::loadDataBlock(uint64_t blockOffset)
+{
+    if (blockOffset == blockOffset_) return true;
+
+    uint64_t offset = blockOffset;
+    uint32_t len = 0;
+    if (!readBytes(&len, sizeof(len), offset, dataFile_) || len < sizeof(uint32_t) || offset + len > toc.data_end) {
+        std::cerr << "[SSTableRaw::loadDataBlock] Neispravan blok na offsetu " << blockOffset << " u " << dataFile_ << "\n";
+        return false;
+    }
+
+    string data(len, '\0');
+    if (!readBytes(&data[0], len, offset, dataFile_)) {
+        std::cerr << "[SSTableRaw::loadDataBlock] Problem reading block at " << blockOffset << "\n";
+        return false;
+    }
+
+    if (blockCodec()) {
+        const BlockCodec* codec = BlockCodec::byId(static_cast<uint8_t>(data.back()));
+        string decoded;
+        if (codec == nullptr || !codec->decompress(data.data(), len - 1, decoded) || decoded.size() < sizeof(uint32_t)) {
+            std::cerr << "[SSTableRaw::loadDataBlock] Neispravan kompresovan blok na offsetu " << blockOffset << " u " << dataFile_ << "\n";
+            return false;
+        }
+        data = std::move(decoded);
+        len = data.size();
+    }
+
+    uint32_t restart_count;
+    std::memcpy(&restart_count, data.data() + len - sizeof(restart_count), sizeof(restart_count));
+
+    // Iza restart tacaka mogu biti kante hes indeksa i njihov broj
+    uint64_t trailer = sizeof(restart_count);
+    uint16_t bucket_count = 0;
+    if (restart_count & BLOCK_HASH_INDEX_FLAG) {
+        restart_count &= ~BLOCK_HASH_INDEX_FLAG;
+        if (trailer + sizeof(bucket_count) > len) {
+            std::cerr << "[SSTableRaw::loadDataBlock] Neispravan hes indeks u bloku " << blockOffset << "\n";
+            return false;
+        }
+        std::memcpy(&bucket_count, data.data() + len - trailer - sizeof(bucket_count), sizeof(bucket_count));
+        trailer += sizeof(bucket_count) + bucket_count;
+    }
+
+    if (restart_count == 0 || (uint64_t)restart_count * sizeof(uint32_t) + trailer > len) {
+        std::cerr << "[SSTableRaw::loadDataBlock] Neispravan broj restart tacaka u bloku " << blockOffset << "\n";
+        return false;
+    }
+
+    block_ = std::move(data);
+    blockOffset_ = blockOffset;
+    blockRestarts_ = restart_count;
+    blockEntriesEnd_ = len - trailer - restart_count * sizeof(uint32_t);
+    blockHashOffset_ = len - trailer;
+    blockHashBuckets_ = bucket_count;
+    blockDiskEnd_ = offset; // offset je sada na kraju bloka
+
+    blockEntries_.clear();
+    if (blockCodec()) {
+        // Offset zapisa je redni broj u bloku, pa jednom prolazimo kroz blok i pamtimo pozicije
+        std::string key;
+        for (size_t pos = 0; pos < blockEntriesEnd_;) {
+            blockEntries_.push_back(pos);
+            pos = decodeBlockEntry(pos, key, nullptr);
+            if (pos == string::npos) {
+                std::cerr << "[SSTableRaw::loadDataBlock] Neispravan zapis u bloku " << blockOffset << "\n";
+                blockOffset_ = std::numeric_limits<uint64_t>::max();
+                return false;
+            }
+        }
+    }
+
+    blockEnds_[blockDiskEnd_] = blockOffset;
+    if (blockEnds_.size() > MAX_BLOCK_ENDS) {
+        // Izbacujemo blok najdalji od ovog (sekvencijalno citanje tako brise one iza sebe)
+        if (blockOffset - blockEnds_.begin()->second > std::prev(blockEnds_.end())->second - blockOffset) {
+            blockEnds_.erase(blockEnds_.begin());
+        }
+        else {
+            blockEnds_.erase(std::prev(blockEnds_.end()));
+        }
+    }
+    return true;
+}
+
+uint64_t SSTableRaw::dataBlockStart(uint64_t offset)
+{
+    if (blockOffset_ != std::numeric_limits<uint64_t>::max() &&
+        offset >= blockOffset_ && offset < blockDiskEnd_) {
+        return blockOffset_;
+    }
+
+    auto it = blockEnds_.upper_bound(offset);
+    if (it != blockEnds_.end() && it->second <= offset) {
+        return it->second;
+    }
+
+    // Kraj poznatog bloka ispred offseta je pocetak sledeceg bloka; odatle idemo napred
+    uint64_t start = it == blockEnds_.begin() ? toc.data_offset : std::prev(it)->first;
+    while (start < offset && start < toc.data_end) {
+        if (!loadDataBlock(start)) return offset;
+        if (offset < blockDiskEnd_) return start;
+        start = blockDiskEnd_;
+    }
+    return offset;
+}
+
+uint64_t SSTableRaw::entryOffset(size_t pos) const
+{
+    if (pos == 0) return blockOffset_;
+    if (!blockCodec()) return blockOffset_ + sizeof(uint32_t) + pos;
+    return blockOffset_ + (std::lower_bound(blockEntries_.begin(), blockEntries_.end(), pos) - blockEntries_.begin());
+}
+
+bool SSTableRaw::entryPosition(uint64_t offset, size_t& pos) const
+{
+    if (offset == blockOffset_) {
+        pos = 0;
+        return true;
+    }
+    if (!blockCodec()) {
+        pos = offset - blockOffset_ - sizeof(uint32_t);
+        return pos < blockEntriesEnd_;
+    }
+
+    uint64_t index = offset - blockOffset_;
+    if (index >= blockEntries_.size()) return false;
+    pos = blockEntries_[index];
+    return true;
+}
+
+uint32_t SSTableRaw::restartPoint(uint32_t i) const
+{
+    uint32_t restart;
+    std::memcpy(&restart, block_.data() + blockEntriesEnd_ + i * sizeof(uint32_t), sizeof(restart));
+    return restart;
+}
+
+size_t SSTableRaw::decodeBlockEntry(size_t pos, std::string& key, Record* r) const
+{
+    auto read_varint = [&](uint64_t& value) {
+        value = 0;
+        size_t shift = 0;
+        bool finished = false;
+        while (!finished && pos < blockEntriesEnd_) {
+            finished = varenc::decodeVarint<uint64_t>(block_[pos++], value, shift);
+        }
+        return finished;
+    };
+
+    uint64_t shared, non_shared, value_size;
+    if (!read_varint(shared) || !read_varint(non_shared) || !read_varint(value_size)) {
+        return string::npos;
+    }
+
+    uint64_t ts;
+    std::byte tomb;
+    uint32_t crc;
+    const size_t fixed_len = sizeof(ts) + sizeof(tomb) + sizeof(crc);
+
+    if (shared > key.size() || pos + fixed_len + non_shared + value_size > blockEntriesEnd_) {
+        return string::npos;
+    }
+
+    std::memcpy(&ts, block_.data() + pos, sizeof(ts));
+    pos += sizeof(ts);
+    std::memcpy(&tomb, block_.data() + pos, sizeof(tomb));
+    pos += sizeof(tomb);
+    std::memcpy(&crc, block_.data() + pos, sizeof(crc));
+    pos += sizeof(crc);
+
+    key.resize(shared);
+    key.append(block_, pos, non_shared);
+    pos += non_shared;
+
+    if (r != nullptr) {
+        r->crc = crc;
+        r->timestamp = ts;
+        r->tombstone = tomb;
+        r->key = key;
+        r->value.assign(block_, pos, value_size);
+        r->key_size = r->key.size();
+        r->value_size = value_size;
+    }
+
+    return pos + value_size;
+}
+
+uint64_t SSTableRaw::findRecordOffsetInBlocks(const std::string& key, bool& found)
+{
+    found = false;
+    uint64_t blockStart = findDataOffsetInIndex(key);
+
+    while (blockStart < toc.data_end) {
+        if (!loadDataBlock(blockStart)) break;
+
+        // Binarna pretraga: poslednja restart tacka ciji je kljuc <= key
+        uint32_t lo = 0, hi = blockRestarts_;
+        while (hi - lo > 1) {
+            uint32_t mid = lo + (hi - lo) / 2;
+            std::string restartKey;
+            if (decodeBlockEntry(restartPoint(mid), restartKey, nullptr) == string::npos) {
+                std::cerr << "[SSTableRaw::findRecordOffset] Neispravan zapis u bloku " << blockStart << "\n";
+                return std::numeric_limits<uint64_t>::max();
+            }
+            if (restartKey <= key) lo = mid;
+            else hi = mid;
+        }
+
+        // Od restart tacke linearno, dok ne dodjemo do prvog kljuca >= key
+        std::string prevKey, rkey;
+        size_t pos = restartPoint(lo);
+        while (pos < blockEntriesEnd_) {
+            prevKey = rkey;
+            size_t next = decodeBlockEntry(pos, rkey, nullptr);
+            if (next == string::npos) {
+                std::cerr << "[SSTableRaw::findRecordOffset] Neispravan zapis u bloku " << blockStart << "\n";
+                return std::numeric_limits<uint64_t>::max();
+            }
+
+            if (rkey >= key) {
+                found = rkey == key;
+                uint64_t offset = entryOffset(pos);
+                // getNextRecord odavde ne mora ponovo od restart tacke
+                lastEnd_ = offset;
+                lastKey_ = prevKey;
+                return offset;
+            }
+            pos = next;
+        }
+
+        // Svi kljucevi u bloku su manji, prelazimo na sledeci blok
+        blockStart = blockDiskEnd_;
+    }
+
+    return std::numeric_limits<uint64_t>::max();
+}
+
+uint32_t SSTableRaw::blockKeyHash(const std::string& key)
+{
+    uint32_t hash = 0;
+    MurmurHash3_x86_32(key.data(), static_cast<int>(key.size()), 0, &hash);
+    return hash;
+}
+
+bool SSTableRaw::getWithBlockHash(const std::string& key, bool& found, Record& r)
+{
+    found = false;
+    if (key > summary_.max || key < summary_.min) return false;
+
+    uint64_t blockStart = findDataOffsetInIndex(key);
+    if (blockStart >= toc.data_end || !loadDataBlock(blockStart) || blockHashBuckets_ == 0) return false;
+
+    uint8_t restart = static_cast<uint8_t>(block_[blockHashOffset_ + blockKeyHash(key) % blockHashBuckets_]);
+    if (restart == HASH_BUCKET_COLLISION) return false;
+
+    std::string rkey;
+    if (restart != HASH_BUCKET_EMPTY) {
+        if (restart >= blockRestarts_) return false;
+
+        // Ako je kljuc u bloku, u intervalu je ove restart tacke
+        size_t pos = restartPoint(restart);
+        size_t end = restart + 1u < blockRestarts_ ? restartPoint(restart + 1) : blockEntriesEnd_;
+        while (pos < end) {
+            std::string prevKey = rkey;
+            size_t next = decodeBlockEntry(pos, rkey, nullptr);
+            if (next == string::npos) return false;
+
+            if (rkey == key) {
+                found = decodeBlockEntry(pos, prevKey, &r) != string::npos;
+                return found;
+            }
+            // Kljuc je izmedju dva kljuca bloka, a nije u bloku
+            if (rkey > key) return true;
+            pos = next;
+        }
+    }
+
+    // Kljuca nema u bloku; sigurno ga nema u tabeli samo ako blok ima i veci kljuc,
+    // inace moze biti u sledecem bloku (index ne mora imati svaki kljuc)
+    rkey.clear();
+    if (decodeBlockEntry(restartPoint(blockRestarts_ - 1), rkey, nullptr) == string::npos) return false;
+    return key < rkey;
+}
+
+bool SSTableRaw::dataRangeForKeys(const std::string& min_key, const std::string& max_key, uint64_t& begin, uint64_t& end)
+{
+    prepare();
+    if (!blockFormat()) return SSTable::dataRangeForKeys(min_key, max_key, begin, end);
+
+    // Offset zapisa u kompresovanom bloku nije bajt na disku, pa opseg ide po granicama blokova iz indeksa
+    if (min_key > summary_.max || max_key < summary_.min) return false;
+
+    begin = findDataOffsetInIndex(min_key);
+    uint64_t lastBlock = findDataOffsetInIndex(max_key);
+    // Ako se poslednji blok ne moze procitati, proveravamo sve do kraja data dela
+    end = loadDataBlock(lastBlock) ? blockDiskEnd_ : toc.data_end;
+    return begin < end;
+}
+
+Record SSTableRaw::getNextRecordFromBlock(uint64_t& offset, bool& error, bool& eof)
+{
+    Record r;
+    prepare();
+
+    if (offset >= toc.data_end) {
+        error = true;
+        return r;
+    }
+
+    uint64_t start = dataBlockStart(offset);
+    if (!loadDataBlock(start)) {
+        error = true;
+        return r;
+    }
+
+    size_t pos;
+    if (!entryPosition(offset, pos)) {
+        error = true;
+        return r;
+    }
+
+    std::string key;
+    if (offset == lastEnd_) {
+        key = lastKey_;
+    }
+    else {
+        // Prethodni kljuc ne znamo: krecemo od poslednje restart tacke pre pos
+        uint32_t lo = 0, hi = blockRestarts_;
+        while (hi - lo > 1) {
+            uint32_t mid = lo + (hi - lo) / 2;
+            if (restartPoint(mid) <= pos) lo = mid;
+            else hi = mid;
+        }
+
+        size_t p = restartPoint(lo);
+        while (p < pos && p != string::npos) {
+            p = decodeBlockEntry(p, key, nullptr);
+        }
+        if (p != pos) {
+            error = true;
+            return r;
+        }
+    }
+
+    size_t next = decodeBlockEntry(pos, key, &r);
+    if (next == string::npos) {
+        error = true;
+        return r;
+    }
+
+    // Posle poslednjeg zapisa u bloku prelazimo na pocetak sledeceg bloka
+    if (next >= blockEntriesEnd_) offset = blockDiskEnd_;
+    else offset = entryOffset(next);
+
+    lastEnd_ = offset;
+    lastKey_ = std::move(key);
+
+    if (offset == toc.data_end) eof = true;
+
+    return r;
+}
+
+
+// ----- Blokovi kljuceva za index i summary -----
+
+std::string SSTableRaw::encodeKeyBlock(const std::vector<IndexEntry>& entries, size_t from, size_t to)
+{
+    string block;
+    uint32_t count = to - from;
+    block.append(reinterpret_cast<const char*>(&count), sizeof(count));
+
+    uint32_t key_end = 0;
+    for (size_t i = from; i < to; ++i) {
+        key_end += entries[i].key.size();
+        block.append(reinterpret_cast<const char*>(&key_end), sizeof(key_end));
+    }
+
+    for (size_t i = from; i < to; ++i) {
+        uint64_t offset = entries[i].offset;
+        block.append(reinterpret_cast<const char*>(&offset), sizeof(offset));
+    }
+
+    for (size_t i = from; i < to; ++i) {
+        block.append(entries[i].key);
+    }
+
+    return block;
+}
+
+bool SSTableRaw::searchKeyBlock(const std::string& block, const std::string& key, uint64_t& offset)
+{
+    uint32_t count = 0;
+    if (block.size() < sizeof(count)) return false;
+    std::memcpy(&count, block.data(), sizeof(count));
+
+    const size_t arrays_len = sizeof(count) + (size_t)count * (sizeof(uint32_t) + sizeof(uint64_t));
+    if (count == 0 || arrays_len > block.size()) return false;
+
+    const char* key_ends = block.data() + sizeof(count);
+    const char* offsets = key_ends + count * sizeof(uint32_t);
+    const char* keys = block.data() + arrays_len;
+    const size_t keys_len = block.size() - arrays_len;
+
+    auto key_end = [&](uint32_t i) {
+        uint32_t end;
+        std::memcpy(&end, key_ends + i * sizeof(uint32_t), sizeof(end));
+        return std::min<size_t>(end, keys_len);
+    };
+
+    // Prvi kljuc > key, trazeni je onaj pre njega
+    uint32_t lo = 0, hi = count;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        size_t begin = mid == 0 ? 0 : key_end(mid - 1);
+        std::string_view midKey(keys + begin, key_end(mid) - std::min(begin, key_end(mid)));
+        if (midKey <= std::string_view(key)) lo = mid + 1;
+        else hi = mid;
+    }
+
+    // Kljuc manji od svih: pretraga nastavlja od prve particije (ili pocetka data dela)
+    std::memcpy(&offset, offsets + (lo == 0 ? 0 : lo - 1) * sizeof(uint64_t), sizeof(offset));
+    return lo != 0;
+}
+
+bool SSTableRaw::readKeyBlock(uint64_t& offset, const std::string& fileName, std::string& block) const
+{
+    uint32_t len = 0;
+    if (!readBytes(&len, sizeof(len), offset, fileName)) return false;
+
+    block.assign(len, '\0');
+    return readBytes(&block[0], len, offset, fileName);
+}
@@ -6,11 +6,14 @@
 #include <algorithm>
 #include <stdexcept>
 #include <iostream>
+#include <map>
+#include <limits>
 //#include <additional/sha.h> // OpenSSL za SHA256 heširanje
 
 #include "../Wal/wal.h"
 #include "../BloomFilter/BloomFilter.h"
 #include "SSTable.h"
+#include "BlockCodec.h"
 
 
 class SSTableRaw : public SSTable {
@@ -62,14 +65,14 @@ public:
         range_scan(const std::string& startKey, const std::string& endKey);
      */
 
-    bool validate() override;
-
     uint64_t findRecordOffset(const std::string& key, bool& found) override;
 
     Record getNextRecord(uint64_t& offset, bool& error, bool& eof) override;
 
 protected:
     std::vector<IndexEntry> writeDataMetaFiles(std::vector<Record>& sortedRecords) override;
+    bool validateRecords() override;
+    bool dataRangeForKeys(const std::string& min_key, const std::string& max_key, uint64_t& begin, uint64_t& end) override;
 
     // Snima 'index_' u indexFile_
     //std::vector<IndexEntry> writeIndexToFile() override;
@@ -77,14 +80,118 @@ protected:
 
     // void readIndexFromFile();
 
-    // Snima 'bloom_' u filterFile_
-    void writeBloomToFile() override;
+    // Snima filter u filterFile_
+    void writeFilterToFile() override;
 
-    // Ucitava 'bloom_' iz filterFile_ ako vec nije
-    void readBloomFromFile() override;
+    // Ucitava filter iz filterFile_
+    void readFilterFromFile() override;
     void readSummaryHeader() override;
 
     void writeSummaryToFile() override;
     void writeMetaToFile() override;
     void readMetaFromFile() override;
+
+private:
+    // Deo filter fajla: [uint64 duzina][bajtovi] (filter kljuceva, pa prefiks i range filter)
+    void appendFilterSection(string& payload, const std::vector<byte>& raw) const;
+    bool readFilterSection(uint64_t& offset, std::vector<byte>& raw);
+
+    /**
+     * Blok format data dela (TOC_FLAG_BLOCK_FORMAT):
+     *   blok:  [uint32 duzina] [zapisi...] [uint32 restart offset]*n [uint32 n]
+     *   zapis: [varint shared] [varint non_shared] [varint value_size]
+     *          [uint64 timestamp] [tombstone] [uint32 crc] [kljuc od shared-tog bajta] [value]
+     * Kljuc deli prvih `shared` bajtova sa prethodnim kljucem u bloku. Na svakih
+     * Config::block_restart_interval zapisa je restart tacka (shared = 0), pa se unutar
+     * bloka binarno pretrazuju restart tacke, a onda ide linearno do kljuca.
+     *
+     * Index i dalje ima kljuceve zapisa, ali offset pokazuje na pocetak bloka.
+     * Offset zapisa je pocetak bloka (prvi zapis) ili pozicija zapisa unutar bloka.
+     *
+     * Sa kodekom (TOC_FLAG_BLOCK_CODEC, Config::block_compression) blok na disku je
+     *   [uint32 duzina] [blok kompresovan kodekom] [uint8 CodecId]
+     * Pozicija unutar kompresovanog bloka nema veze sa mestom u fajlu, pa je offset zapisa
+     * pocetak bloka + redni broj zapisa u bloku. Blok se zapisuje kompresovan samo ako je kraci
+     * i ako ima bar onoliko bajtova koliko zapisa, da offseti ne predju u sledeci blok.
+     *
+     * Sa hes indeksom (Config::block_hash_index) najvisi bit od n je BLOCK_HASH_INDEX_FLAG, a izmedju
+     * restart tacaka i n je [uint8 kanta]*m [uint16 m]. Kanta (hes kljuca % m) je restart tacka ciji
+     * interval ima sve kljuceve bloka sa tim hesom, HASH_BUCKET_EMPTY ako ih nema ili
+     * HASH_BUCKET_COLLISION ako su u razlicitim intervalima. get tako ide pravo na interval kljuca,
+     * bez binarne pretrage restart tacaka. Blok sa vise od HASH_BUCKET_COLLISION restart tacaka nema hes indeks.
+     */
+    bool blockFormat() const { return (toc.flags & TOC_FLAG_BLOCK_FORMAT) != 0; }
+    bool blockCodec() const { return (toc.flags & TOC_FLAG_BLOCK_CODEC) != 0; }
+
+    static constexpr uint32_t BLOCK_HASH_INDEX_FLAG = 1u << 31;
+    static constexpr uint8_t HASH_BUCKET_EMPTY = 255;
+    static constexpr uint8_t HASH_BUCKET_COLLISION = 254;
+    static uint32_t blockKeyHash(const std::string& key);
+
+    std::vector<IndexEntry> writeDataBlocks(std::vector<Record>& sortedRecords);
+    uint64_t findRecordOffsetInBlocks(const std::string& key, bool& found);
+    // get preko hes indeksa bloka; false ako blok nema hes indeks ili hes nije dovoljan (kolizija,
+    // kljuc mozda u sledecem bloku), pa get ide uobicajenim putem
+    bool getWithBlockHash(const std::string& key, bool& found, Record& r);
+    Record getNextRecordFromBlock(uint64_t& offset, bool& error, bool& eof);
+
+    // Prolazi kroz summary i index, vraca offset u data fajlu od kog se trazi kljuc
+    uint64_t findDataOffsetInIndex(const std::string& key);
+
+    /**
+     * Blok kljuceva (index i summary od TOC verzije 2):
+     *   [uint32 n] [uint32 kraj kljuca]*n [uint64 offset]*n [kljucevi jedan za drugim]
+     * U fajlu je ispred bloka uint32 duzina. Nizovi su fiksne sirine, pa se ucitan blok
+     * binarno pretrazuje bez parsiranja kljuceva redom.
+     */
+    static std::string encodeKeyBlock(const std::vector<IndexEntry>& entries, size_t from, size_t to);
+    // Offset poslednjeg kljuca <= key; ako je key manji od svih kljuceva u bloku,
+    // offset prvog kljuca i false
+    static bool searchKeyBlock(const std::string& block, const std::string& key, uint64_t& offset);
+    bool readKeyBlock(uint64_t& offset, const std::string& fileName, std::string& block) const;
+
+    /**
+     * Particionisan index (od TOC_VERSION_PARTITIONED_INDEX):
+     * index deo je niz nivoa particija (blokova kljuceva), od particija nad index_ ka korenu.
+     * Particija staje u jedan blok fajla i ne prelazi njegovu granicu, pa se ucitava jednim
+     * citanjem kroz kes blokova. Nivoi se dodaju dok koren ne stane u blok; koren je blok u
+     * summary fajlu (ispred njega uint32 broj nivoa ispod korena) i jedini ostaje u memoriji,
+     * pa memorija otvorene tabele ne raste sa velicinom tabele.
+     * Tabele verzija 2-4 imaju jedan nivo, bez poravnanja.
+     */
+    std::vector<IndexEntry> appendIndexPartitions(const std::vector<IndexEntry>& entries, size_t minEntries, std::string& payload) const;
+
+    std::string summaryBlock_; // koren indeksa, ucitava se pri prvoj pretrazi
+    uint32_t indexLevels_ = 1; // nivoi particija ispod korena
+
+    // Ucitava blok koji pocinje na blockOffset u block_ (ako vec nije ucitan)
+    bool loadDataBlock(uint64_t blockOffset);
+    // Pocetak bloka u kom je offset. Ako blok nije medju zapamcenim, ide blok po blok
+    // od najblizeg poznatog pocetka ispred offseta.
+    uint64_t dataBlockStart(uint64_t offset);
+    // Dekodira zapis na poziciji pos u block_; key na ulazu je prethodni kljuc. Vraca poziciju sledeceg zapisa.
+    size_t decodeBlockEntry(size_t pos, std::string& key, Record* r) const;
+    // Restart tacka i
+    uint32_t restartPoint(uint32_t i) const;
+    // Offset zapisa na poziciji pos u ucitanom bloku, i obrnuto (false ako offset nije zapis ovog bloka)
+    uint64_t entryOffset(size_t pos) const;
+    bool entryPosition(uint64_t offset, size_t& pos) const;
+
+    uint64_t blockOffset_ = std::numeric_limits<uint64_t>::max();
+    std::string block_;             // sadrzaj bloka bez polja duzine
+    size_t blockEntriesEnd_ = 0;    // gde pocinje niz restart tacaka
+    uint32_t blockRestarts_ = 0;
+    size_t blockHashOffset_ = 0;    // gde pocinju kante hes indeksa
+    uint16_t blockHashBuckets_ = 0; // 0 ako blok nema hes indeks
+    uint64_t blockDiskEnd_ = 0;     // gde u fajlu pocinje sledeci blok
+    std::vector<size_t> blockEntries_; // pozicije zapisa u bloku, samo sa kodekom
+
+    // kraj bloka -> pocetak, za poslednje citane blokove. Ogranicen na prozor oko trenutnog bloka,
+    // da memorija otvorene tabele ne raste sa brojem procitanih blokova.
+    static constexpr size_t MAX_BLOCK_ENDS = 64;
+    std::map<uint64_t, uint64_t> blockEnds_;
+
+    // Poslednji procitan zapis, da sekvencijalno citanje ne krece od restart tacke
+    uint64_t lastEnd_ = std::numeric_limits<uint64_t>::max();
+    std::string lastKey_;
 };
\ No newline at end of file
@@ -1,7 +1,881 @@
 #include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <filesystem>
+#include <fstream>
+#include <cstddef>
+#include <stdexcept>
 #include "SSTManager.h"
+#include "BlockCodec.h"
+#include "../MurmurHash3/MurmurHash3.h"
+#include "../Utils/VarEncoding.h"
 using namespace std;
 
+// Vrednosti kakve engine cuva: tekstualni zapisi korisnika, serijalizovani Bloom filteri (TypesManager) i hesevi
+static vector<string> napraviKorpus(size_t n) {
+	const char* gradovi[] = { "Novi Sad", "Beograd", "Nis", "Kragujevac", "Subotica" };
+	mt19937 rng(42);
+	vector<string> vrednosti;
+	vrednosti.reserve(n);
+
+	for (size_t i = 0; i < n; i++) {
+		switch (i % 4) {
+		case 0:
+		case 1: {
+			string v = "{\"ime\":\"Korisnik " + to_string(rng() % 100000) + "\",\"grad\":\"" + gradovi[rng() % 5]
+				+ "\",\"email\":\"korisnik" + to_string(rng() % 100000) + "@example.com\",\"poeni\":" + to_string(rng() % 10000) + "}";
+			vrednosti.push_back(v);
+			break;
+		}
+		case 2: {
+			BloomFilter bf(50, 0.01);
+			for (int k = 0; k < 10; k++) bf.add("element" + to_string(rng() % 1000));
+			vector<byte> bytes = bf.serialize();
+			vrednosti.emplace_back(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+			break;
+		}
+		default: {
+			string v(32, '\0');
+			for (auto& c : v) c = static_cast<char>(rng());
+			vrednosti.push_back(v);
+		}
+		}
+	}
+	return vrednosti;
+}
+
+// Odnos kompresije i brzina dekompresije po kodeku, na blokovima od ~4 KB
+void uporediKodeke() {
+	cout << "===== Kodeci data blokova: blokovi od 4 KB =====\n";
+
+	vector<string> vrednosti = napraviKorpus(200000);
+	vector<string> blokovi(1);
+	for (const auto& v : vrednosti) {
+		if (blokovi.back().size() >= 4096) blokovi.emplace_back();
+		blokovi.back().append(v);
+	}
+
+	size_t original = 0;
+	for (const auto& b : blokovi) original += b.size();
+
+	for (CodecId id : { CodecId::None, CodecId::LZ }) {
+		const BlockCodec* codec = BlockCodec::byId(static_cast<uint8_t>(id));
+
+		vector<string> kompresovani(blokovi.size());
+		auto start = chrono::steady_clock::now();
+		size_t kompresovano = 0;
+		for (size_t i = 0; i < blokovi.size(); i++) {
+			codec->compress(blokovi[i], kompresovani[i]);
+			kompresovano += kompresovani[i].size();
+		}
+		double kompresija = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+		const int ponavljanja = 5;
+		string izlaz;
+		bool ispravno = true;
+		start = chrono::steady_clock::now();
+		for (int p = 0; p < ponavljanja; p++) {
+			for (size_t i = 0; i < blokovi.size(); i++) {
+				ispravno &= codec->decompress(kompresovani[i].data(), kompresovani[i].size(), izlaz) && izlaz.size() == blokovi[i].size();
+			}
+		}
+		double dekompresija = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+
+		cout << fixed << setprecision(2)
+			<< setw(5) << codec->name()
+			<< " | odnos: " << (double)original / kompresovano
+			<< " | kompresija: " << original / kompresija / 1e6 << " MB/s"
+			<< " | dekompresija: " << ponavljanja * original / dekompresija / 1e9 << " GB/s"
+			<< " | ispravno: " << (ispravno ? "da" : "NE") << "\n";
+	}
+}
+
+// Prazan direktorijum podataka za jedan test
+static void pripremiDirektorijum(const string& ime) {
+	Config::data_directory = "./" + ime;
+	filesystem::remove_all(Config::data_directory);
+	filesystem::create_directories(Config::data_directory);
+}
+
+// n zapisa sa kljucevima kljuc000000, kljuc000001, ... (vec sortirani)
+static vector<Record> napraviZapise(size_t n, size_t duzinaVrednosti = 20) {
+	vector<Record> zapisi;
+	zapisi.reserve(n);
+	for (size_t i = 0; i < n; i++) {
+		char kljuc[16];
+		snprintf(kljuc, sizeof(kljuc), "kljuc%06zu", i);
+		Record r{};
+		r.key = kljuc;
+		r.value = "v" + to_string(i) + string(duzinaVrednosti, 'a' + i % 26);
+		r.key_size = r.key.size();
+		r.value_size = r.value.size();
+		r.timestamp = i + 1;
+		zapisi.push_back(r);
+	}
+	return zapisi;
+}
+
+// Cita tabelu od pocetka do kraja preko getNextRecord; pamti offset i kljuc svakog zapisa
+static bool procitajRedom(SSTable& tabela, vector<uint64_t>& offseti, vector<string>& kljucevi) {
+	uint64_t offset = tabela.getDataStartOffset();
+	while (true) {
+		bool error = false, eof = false;
+		offseti.push_back(offset);
+		Record r = tabela.getNextRecord(offset, error, eof);
+		if (error) return false;
+		kljucevi.push_back(r.key);
+		if (eof) return true;
+	}
+}
+
+static bool procitajNa(SSTable& tabela, uint64_t offset, const string& kljuc) {
+	bool error = false, eof = false;
+	Record r = tabela.getNextRecord(offset, error, eof);
+	return !error && r.key == kljuc;
+}
+
+// Blok format: tabela pamti samo prozor procitanih blokova, pa nastavak sa offseta
+// iz bloka koji je davno izbacen (ili nikad procitan) mora sam da nadje pocetak bloka
+static bool proveriPamcenjeBlokova() {
+	bool ispravno = true;
+	for (const char* kodek : { "none", "lz" }) {
+		Config::compress_sstable = false;
+		Config::sstable_block_format = true;
+		Config::block_compression = kodek;
+		Config::block_size = 256;
+		pripremiDirektorijum("proba_blokova");
+
+		Block_manager bm;
+		SSTManager sst(&bm);
+		vector<Record> zapisi = napraviZapise(3000);
+		sst.write(zapisi, 1);
+
+		vector<uint64_t> offseti;
+		vector<string> kljucevi;
+		{
+			vector<unique_ptr<SSTable>> tabele = sst.getTablesFromLevel(1);
+			ispravno &= tabele.size() == 1 && procitajRedom(*tabele[0], offseti, kljucevi);
+		}
+		ispravno &= kljucevi.size() == zapisi.size();
+		if (!ispravno) break;
+
+		// Nova instanca ne zna nijedan blok
+		vector<unique_ptr<SSTable>> tabele = sst.getTablesFromLevel(1);
+		SSTable& t = *tabele[0];
+		const size_t n = offseti.size();
+		ispravno &= procitajNa(t, offseti[n / 2 + 1], kljucevi[n / 2 + 1]);
+
+		// Dva naizmenicna citanja redom, preko mnogo vise blokova nego sto tabela pamti
+		for (size_t a = 0, b = n / 2; a < n / 2; a++, b++) {
+			ispravno &= procitajNa(t, offseti[a], kljucevi[a]);
+			ispravno &= procitajNa(t, offseti[b], kljucevi[b]);
+		}
+
+		for (size_t i : { (size_t)1, n / 3 + 1, n - 1 }) {
+			ispravno &= procitajNa(t, offseti[i], kljucevi[i]);
+		}
+	}
+
+	filesystem::remove_all(Config::data_directory);
+	cout << "Nastavak citanja posle izbacenih blokova | ispravno: " << (ispravno ? "da" : "NE") << "\n";
+	return ispravno;
+}
+
+// get svakog kljuca tabele i kljuceva kojih nema: ispred prvog, izmedju dva i iza poslednjeg
+static bool proveriGet(SSTable& tabela, const vector<Record>& zapisi) {
+	bool ispravno = true;
+	for (const Record& z : zapisi) {
+		vector<Record> nadjeni = tabela.get(z.key);
+		ispravno &= nadjeni.size() == 1 && nadjeni[0].value == z.value && nadjeni[0].timestamp == z.timestamp;
+		ispravno &= tabela.get(z.key + "x").empty();
+	}
+	ispravno &= tabela.get("kljuc").empty() && tabela.get("kljuc999999").empty() && tabela.get("a").empty();
+	return ispravno;
+}
+
+// Upisuje zapise na nivo 1 sa trenutnim Config-om, pa proverava get i citanje redom
+static bool proveriTabelu(const string& opis, const vector<Record>& zapisi) {
+	pripremiDirektorijum("proba_tabele");
+	bool ispravno;
+	{
+		Block_manager bm;
+		SSTManager sst(&bm);
+		sst.write(zapisi, 1);
+
+		vector<unique_ptr<SSTable>> tabele = sst.getTablesFromLevel(1);
+		vector<uint64_t> offseti;
+		vector<string> kljucevi;
+		ispravno = tabele.size() == 1 && proveriGet(*tabele[0], zapisi) && procitajRedom(*tabele[0], offseti, kljucevi);
+		ispravno &= kljucevi.size() == zapisi.size() && equal(kljucevi.begin(), kljucevi.end(), zapisi.begin(),
+			[](const string& k, const Record& z) { return k == z.key; });
+	}
+	filesystem::remove_all(Config::data_directory);
+	if (!ispravno) cout << "  tabela ne radi: " << opis << "\n";
+	return ispravno;
+}
+
+// Pretraga kroz blokove kljuceva (index i summary) i kroz data blokove sa i bez kodeka i hes indeksa
+static bool proveriPretraguBlokova() {
+	Config::compress_sstable = false;
+	Config::sstable_block_format = false;
+	Config::block_size = 256;
+	Config::index_sparsity = 4;
+	Config::summary_sparsity = 4;
+	vector<Record> zapisi = napraviZapise(2000);
+	bool ispravno = proveriTabelu("blokovi kljuceva", zapisi);
+	Config::index_sparsity = 32;
+	Config::summary_sparsity = 64;
+
+	Config::sstable_block_format = true;
+	Config::block_restart_interval = 4;
+	for (const char* kodek : { "none", "lz" }) {
+		for (bool hes : { false, true }) {
+			Config::block_compression = kodek;
+			Config::block_hash_index = hes;
+			ispravno &= proveriTabelu(string("kodek ") + kodek + (hes ? ", hes indeks" : ""), zapisi);
+		}
+	}
+
+	// Jedan blok, svaki kljuc u svom intervalu: kljucevi iz razlicitih intervala sa istom kantom
+	// daju HASH_BUCKET_COLLISION, pa get mora da padne na binarnu pretragu restart tacaka
+	Config::block_size = 4096;
+	Config::block_restart_interval = 1;
+	Config::block_compression = "none";
+	vector<Record> blok = napraviZapise(60);
+	vector<int> kante(blok.size() * 4 / 3 + 1, 0);
+	for (const Record& z : blok) {
+		uint32_t hes = 0;
+		MurmurHash3_x86_32(z.key.data(), static_cast<int>(z.key.size()), 0, &hes);
+		kante[hes % kante.size()]++;
+	}
+	ispravno &= any_of(kante.begin(), kante.end(), [](int n) { return n > 1; });
+	ispravno &= proveriTabelu("kolizija u hes indeksu", blok);
+
+	Config::block_hash_index = false;
+	Config::block_restart_interval = 16;
+	cout << "Pretraga kroz blokove kljuceva i data blokove | ispravno: " << (ispravno ? "da" : "NE") << "\n";
+	return ispravno;
+}
+
+// Zapisi jedne tabele: kljucevi prefiks000, prefiks001, ...
+static vector<Record> zapisiTabele(const string& prefiks, size_t n, uint64_t timestamp) {
+	vector<Record> zapisi;
+	for (size_t i = 0; i < n; i++) {
+		char broj[8];
+		snprintf(broj, sizeof(broj), "%03zu", i);
+		Record r{};
+		r.key = prefiks + broj;
+		r.value = prefiks + "-vrednost-" + broj;
+		r.key_size = r.key.size();
+		r.value_size = r.value.size();
+		r.timestamp = timestamp;
+		zapisi.push_back(r);
+	}
+	return zapisi;
+}
+
+// Kes otvorenih tabela manji od broja tabela: get-ovi naizmenicno otvaraju i izbacuju tabele,
+// a tabela uklonjena sa nivoa ne sme da ostane vidljiva kroz kes
+static bool proveriKesOtvorenihTabela() {
+	bool ispravno = true;
+	Config::sstable_block_format = false;
+	Config::block_size = 256;
+	Config::max_open_tables = 2;
+	for (bool kompresija : { false, true }) {
+		Config::compress_sstable = kompresija;
+		pripremiDirektorijum("proba_kesa");
+		{
+			Block_manager bm;
+			SSTManager sst(&bm);
+			const vector<string> prefiksi = { "a", "b", "c", "d", "e" };
+			for (size_t t = 0; t < prefiksi.size(); t++) {
+				sst.write(zapisiTabele(prefiksi[t], 50, t + 1), 1);
+			}
+
+			for (int krug = 0; krug < 2; krug++) {
+				for (size_t i = 0; i < 50; i += 7) {
+					for (const string& p : prefiksi) {
+						char broj[8];
+						snprintf(broj, sizeof(broj), "%03zu", i);
+						optional<string> v = sst.get(p + broj);
+						ispravno &= v.has_value() && *v == p + "-vrednost-" + broj;
+					}
+				}
+			}
+
+			// Uklanjamo tabelu "c" (kao kompakcija), dok je mozda otvorena u kesu
+			ispravno &= sst.get("c010").has_value();
+			vector<unique_ptr<SSTable>> tabele = sst.getTablesFromLevel(1);
+			vector<unique_ptr<SSTable>> uklonjene;
+			for (auto& t : tabele) {
+				if (t->getSummaryMin() == "c000") uklonjene.push_back(std::move(t));
+			}
+			ispravno &= uklonjene.size() == 1;
+			sst.removeSSTables(uklonjene);
+
+			ispravno &= !sst.get("c010").has_value() && sst.get("b010").has_value() && sst.get("d010").has_value();
+			ispravno &= sst.getTablesFromLevel(1).size() == 4;
+		}
+		filesystem::remove_all(Config::data_directory);
+	}
+	Config::max_open_tables = 64;
+
+	cout << "Kes otvorenih tabela | ispravno: " << (ispravno ? "da" : "NE") << "\n";
+	return ispravno;
+}
+
+// Opsezi kljuceva nivoa: na nivou bez preklapanja get ide u jednu tabelu, a posle upisa
+// tabele koja se preklapa sa ostalima opsezi se prave ponovo i pobedjuje najnoviji zapis
+static bool proveriOpsegeNivoa() {
+	bool ispravno = true;
+	Config::compress_sstable = false;
+	Config::sstable_block_format = false;
+	Config::block_size = 256;
+	pripremiDirektorijum("proba_opsega");
+	{
+		Block_manager bm;
+		SSTManager sst(&bm);
+		sst.write(zapisiTabele("a", 20, 1), 1);
+		sst.write(zapisiTabele("e", 20, 2), 1);
+		sst.write(zapisiTabele("c", 20, 3), 1);
+
+		ispravno &= sst.get("a000") == optional<string>("a-vrednost-000");
+		ispravno &= sst.get("c019") == optional<string>("c-vrednost-019");
+		ispravno &= sst.get("e010") == optional<string>("e-vrednost-010");
+		// Izmedju tabela, ispred prve i iza poslednje
+		for (const char* nema : { "b000", "a020", "0", "d", "e999", "z" }) {
+			ispravno &= !sst.get(nema).has_value();
+		}
+
+		// Nova tabela preklapa "c" i "e" i ima novije vrednosti za deo kljuceva
+		vector<Record> novi = { zapisiTabele("c", 20, 4)[5], zapisiTabele("e", 20, 4)[15] };
+		for (Record& r : novi) {
+			r.value = "nova";
+			r.value_size = r.value.size();
+		}
+		sst.write(novi, 1);
+
+		ispravno &= sst.get("c005") == optional<string>("nova") && sst.get("e015") == optional<string>("nova");
+		ispravno &= sst.get("c006") == optional<string>("c-vrednost-006") && sst.get("e014") == optional<string>("e-vrednost-014");
+		ispravno &= sst.get("a010") == optional<string>("a-vrednost-010") && !sst.get("d").has_value();
+	}
+	filesystem::remove_all(Config::data_directory);
+
+	cout << "Opsezi kljuceva nivoa | ispravno: " << (ispravno ? "da" : "NE") << "\n";
+	return ispravno;
+}
+
+static TableMeta opisTabele(int nivo, int id) {
+	TableMeta t;
+	t.level = nivo;
+	t.id = id;
+	t.min_key = "min" + to_string(id);
+	t.max_key = "max" + to_string(id);
+	t.size = 1000 + id;
+	t.entry_count = 10;
+	return t;
+}
+
+static vector<int> idTabela(const map<int, vector<TableMeta>>& nivoi, int nivo) {
+	vector<int> id;
+	auto it = nivoi.find(nivo);
+	if (it != nivoi.end()) {
+		for (const TableMeta& t : it->second) id.push_back(t.id);
+	}
+	return id;
+}
+
+// MANIFEST posle prekinutog upisa (zaglavlje sa besmislenom duzinom, skracen payload) i
+// posle prelaska na novi fajl sa snapshot-om
+static bool proveriManifest() {
+	pripremiDirektorijum("proba_manifesta");
+	const string putanja = Config::data_directory + "/MANIFEST";
+	map<int, vector<TableMeta>> nivoi;
+	int sledeciId = 0;
+	bool ispravno = true;
+
+	{
+		Manifest m(putanja);
+		ispravno &= !m.replay(nivoi, sledeciId);
+		for (int id = 0; id < 5; id++) {
+			VersionEdit izmena;
+			izmena.added.push_back(opisTabele(1, id));
+			ispravno &= m.append(izmena);
+		}
+	}
+	const uint64_t ispravnaDuzina = filesystem::file_size(putanja);
+
+	// Zaglavlje upisano do kraja, a duzina je smece: replay ne sme da alocira 4 GB
+	{
+		ofstream out(putanja, ios::binary | ios::app);
+		uint32_t zaglavlje[2] = { 12345, 0xFFFFFFF0u };
+		out.write(reinterpret_cast<const char*>(zaglavlje), sizeof(zaglavlje));
+		out << "abc";
+	}
+	{
+		Manifest m(putanja);
+		ispravno &= m.replay(nivoi, sledeciId) && idTabela(nivoi, 1) == vector<int>{ 0, 1, 2, 3, 4 } && sledeciId == 5;
+		ispravno &= filesystem::file_size(putanja) == ispravnaDuzina;
+
+		VersionEdit izmena;
+		izmena.removed.emplace_back(1, 4);
+		izmena.added.push_back(opisTabele(2, 5));
+		ispravno &= m.append(izmena);
+	}
+
+	// Poslednji zapis bez poslednjih bajtova payload-a
+	filesystem::resize_file(putanja, filesystem::file_size(putanja) - 3);
+	{
+		Manifest m(putanja);
+		ispravno &= m.replay(nivoi, sledeciId) && idTabela(nivoi, 1) == vector<int>{ 0, 1, 2, 3, 4 } && nivoi.count(2) == 0;
+		ispravno &= filesystem::file_size(putanja) == ispravnaDuzina;
+	}
+
+	// Mali prag: MANIFEST se vise puta zamenjuje snapshot-om. Na kraju je uklonjena tabela sa
+	// najvecim ID-em, pa sledeci ID mora doci iz snapshot-a.
+	filesystem::remove(putanja);
+	{
+		Manifest m(putanja, 512);
+		m.replay(nivoi, sledeciId);
+		for (int id = 0; id < 100; id++) {
+			VersionEdit izmena;
+			izmena.added.push_back(opisTabele(1 + id % 3, id));
+			if (id % 10 != 1 && id > 0) izmena.removed.emplace_back(1 + (id - 1) % 3, id - 1);
+			ispravno &= m.append(izmena);
+			ispravno &= filesystem::file_size(putanja) <= 2 * 512;
+		}
+		VersionEdit izmena;
+		izmena.removed.emplace_back(1 + 99 % 3, 99);
+		ispravno &= m.append(izmena);
+	}
+	{
+		Manifest m(putanja);
+		ispravno &= m.replay(nivoi, sledeciId) && sledeciId == 100;
+		size_t tabela = 0;
+		for (const auto& nivo : nivoi) {
+			for (const TableMeta& t : nivo.second) {
+				ispravno &= t.id % 10 == 0 && t.level == 1 + t.id % 3 && t.min_key == "min" + to_string(t.id)
+					&& t.size == 1000u + t.id;
+				tabela++;
+			}
+		}
+		ispravno &= tabela == 10 && !filesystem::exists(putanja + ".tmp");
+	}
+
+	filesystem::remove_all(Config::data_directory);
+	cout << "MANIFEST posle prekinutog upisa i snapshot-a | ispravno: " << (ispravno ? "da" : "NE") << "\n";
+	return ispravno;
+}
+
+// Prefiks filter koristi ekstraktor upisan uz tabelu, a ne trenutni Config: posle promene
+// ekstraktora stare tabele i dalje iskljucuju prefikse kojih nemaju
+static bool proveriEkstraktorPrefiksa() {
+	struct Slucaj { int duzinaPri; string delimiterPri; int duzinaPosle; string delimiterPosle; };
+	const vector<Slucaj> slucajevi = { { 4, "", 0, "_" }, { 0, ":", 6, "" }, { 0, ":", 0, "_" } };
+
+	bool ispravno = true;
+	Config::sstable_block_format = false;
+	Config::block_size = 256;
+	for (bool kompresija : { false, true }) {
+		for (const Slucaj& s : slucajevi) {
+			Config::compress_sstable = kompresija;
+			Config::prefix_filter_length = s.duzinaPri;
+			Config::prefix_filter_delimiter = s.delimiterPri;
+			pripremiDirektorijum("proba_prefiksa");
+			{
+				Block_manager bm;
+				SSTManager sst(&bm);
+				vector<Record> zapisi;
+				for (const string& p : { "ana:", "bob:", "cid:" }) {
+					vector<Record> deo = zapisiTabele(p, 30, 1);
+					zapisi.insert(zapisi.end(), deo.begin(), deo.end());
+				}
+				sst.write(zapisi, 1);
+			}
+
+			Config::prefix_filter_length = s.duzinaPosle;
+			Config::prefix_filter_delimiter = s.delimiterPosle;
+			{
+				Block_manager bm;
+				SSTManager sst(&bm);
+				vector<unique_ptr<SSTable>> tabele = sst.getTablesFromLevel(1);
+				ispravno &= tabele.size() == 1;
+				if (tabele.size() != 1) continue;
+				SSTable& t = *tabele[0];
+				ispravno &= t.mayContainPrefix("ana:") && t.mayContainPrefix("bob:01") && t.mayContainPrefix("cid:029");
+				// Filter ima slucajan seed, pa ne ocekujemo da iskljuci bas svaki prefiks kog nema;
+				// sa pogresnim ekstraktorom ne bi iskljucio nijedan
+				int iskljuceno = 0;
+				for (int i = 0; i < 100; i++) {
+					iskljuceno += !t.mayContainPrefix("x" + to_string(10 + i) + ":00");
+				}
+				ispravno &= iskljuceno >= 80;
+				// Kraci od izdvojenog prefiksa: filter ne moze da odluci
+				ispravno &= t.mayContainPrefix("zz") && t.mayContainPrefix("");
+			}
+		}
+	}
+	Config::prefix_filter_length = 0;
+	Config::prefix_filter_delimiter = "";
+
+	// Tabela bez prefiks filtera za svaki prefiks kaze "mozda"
+	pripremiDirektorijum("proba_prefiksa");
+	{
+		Block_manager bm;
+		SSTManager sst(&bm);
+		sst.write(zapisiTabele("ana:", 10, 1), 1);
+		vector<unique_ptr<SSTable>> tabele = sst.getTablesFromLevel(1);
+		ispravno &= tabele.size() == 1 && tabele[0]->mayContainPrefix("zzz:");
+	}
+	filesystem::remove_all(Config::data_directory);
+
+	cout << "Ekstraktor prefiks filtera posle promene Config-a | ispravno: " << (ispravno ? "da" : "NE") << "\n";
+	return ispravno;
+}
+
+// Kompresovane tabele sa svojim recnikom kljuceva: svaka tabela ima ID-eve od nule, pa bi
+// zajednicka mapa pomesala kljuceve. Posle ponovnog otvaranja nema globalne key_map.
+static bool proveriRecnikKljuceva() {
+	bool ispravno = true;
+	Config::compress_sstable = true;
+	Config::sstable_block_format = false;
+	Config::block_size = 256;
+	for (bool jedanFajl : { false, true }) {
+		Config::sstable_single_file = jedanFajl;
+		ispravno &= proveriTabelu(jedanFajl ? "recnik kljuceva, jedan fajl" : "recnik kljuceva", napraviZapise(500));
+
+		pripremiDirektorijum("proba_recnika");
+		{
+			Block_manager bm;
+			SSTManager sst(&bm);
+			sst.write(zapisiTabele("a", 50, 1), 1);
+			sst.write(zapisiTabele("b", 50, 2), 1);
+		}
+		{
+			Block_manager bm;
+			SSTManager sst(&bm);
+			sst.write(zapisiTabele("c", 30, 3), 1);
+			for (const string& p : { "a", "b", "c" }) {
+				for (int i = 0; i < 30; i += 3) {
+					char broj[8];
+					snprintf(broj, sizeof(broj), "%03d", i);
+					ispravno &= sst.get(p + broj) == optional<string>(p + "-vrednost-" + broj);
+				}
+			}
+			ispravno &= !sst.get("b050").has_value() && !sst.get("c030").has_value();
+		}
+		ispravno &= !filesystem::exists(Config::data_directory + "/key_map");
+	}
+	Config::sstable_single_file = false;
+	filesystem::remove_all(Config::data_directory);
+
+	cout << "Recnik kljuceva po tabeli | ispravno: " << (ispravno ? "da" : "NE") << "\n";
+	return ispravno;
+}
+
+// Varint iz memorije mora dati isto sto i dekodiranje bajt po bajt, i za granicne vrednosti
+template <typename UInt>
+static bool proveriVarint(UInt vrednost) {
+	string kodiran = varenc::encodeVarint<UInt>(vrednost);
+	// Iza varinta je smece, dekoder mora stati na poslednjem bajtu
+	vector<uint8_t> bafer(varenc::maxVarintLen<UInt>() + 4, 0xFF);
+	memcpy(bafer.data(), kodiran.data(), kodiran.size());
+
+	UInt izMemorije = 0;
+	size_t procitano = varenc::decodeVarint<UInt>(bafer.data(), izMemorije);
+
+	UInt poBajtu = 0;
+	size_t pomeraj = 0, i = 0;
+	while (!varenc::decodeVarint<UInt>(kodiran[i++], poBajtu, pomeraj)) {}
+
+	return procitano == kodiran.size() && izMemorije == vrednost && poBajtu == vrednost;
+}
+
+// Baferovano citanje blokova: varint-ovi ukljucujuci 9-bajtne timestamp-ove, kroz male blokove,
+// pa su polja summary-ja i indeksa i preko granice bloka
+static bool proveriBaferovanoCitanje() {
+	bool ispravno = true;
+	for (uint32_t v : { 0u, 1u, 127u, 128u, 16383u, 16384u, (1u << 21) - 1, 1u << 28, UINT32_MAX }) {
+		ispravno &= proveriVarint<uint32_t>(v);
+	}
+	for (uint64_t v : { (uint64_t)0, (uint64_t)1 << 35, (uint64_t)1 << 56, ((uint64_t)1 << 63) - 1, (uint64_t)1 << 63, UINT64_MAX }) {
+		ispravno &= proveriVarint<uint64_t>(v);
+	}
+	vector<uint8_t> nezavrsen(varenc::maxVarintLen<uint64_t>(), 0x80);
+	uint64_t v = 0;
+	ispravno &= varenc::decodeVarint<uint64_t>(nezavrsen.data(), v) == 0;
+
+	Config::compress_sstable = true;
+	Config::sstable_block_format = false;
+	Config::index_sparsity = 1;
+	Config::summary_sparsity = 2;
+	vector<Record> zapisi = napraviZapise(300);
+	for (size_t i = 0; i < zapisi.size(); i++) {
+		zapisi[i].timestamp = ((uint64_t)1 << 62) + i * 977;
+		zapisi[i].crc = static_cast<uint32_t>(i * 2654435761u);
+	}
+	for (int velicina : { 64, 100, 256 }) {
+		Config::block_size = velicina;
+		ispravno &= proveriTabelu("baferovano citanje, blok " + to_string(velicina), zapisi);
+	}
+	Config::index_sparsity = 32;
+	Config::summary_sparsity = 64;
+
+	cout << "Baferovano citanje varint-ova | ispravno: " << (ispravno ? "da" : "NE") << "\n";
+	return ispravno;
+}
+
+// Velike vrednosti u value logu: citanje, GC segmenta sa mrtvim bajtovima i pokazivac koji ne moze da se procita
+static bool proveriValueLog() {
+	bool ispravno = true;
+	Config::compress_sstable = false;
+	Config::sstable_block_format = false;
+	Config::block_size = 256;
+	Config::value_log_threshold = 64;
+	Config::value_log_file_size = 4096;
+	Config::value_log_gc_percent = 50;
+	pripremiDirektorijum("proba_vloga");
+	auto velike = [](const string& prefiks, size_t n, uint64_t ts) {
+		vector<Record> zapisi = zapisiTabele(prefiks, n, ts);
+		for (Record& r : zapisi) {
+			r.value += string(100, r.key.back());
+			r.value_size = r.value.size();
+		}
+		return zapisi;
+	};
+	{
+		Block_manager bm;
+		SSTManager sst(&bm);
+		vector<Record> x = velike("x", 20, 1), y = velike("y", 20, 2);
+		sst.write(x, 1);
+		sst.write(y, 1);
+		for (const Record& r : x) ispravno &= sst.get(r.key) == optional<string>(r.value);
+		for (const Record& r : y) ispravno &= sst.get(r.key) == optional<string>(r.value);
+
+		// Segment 0 drzi sve "x" i pocetak "y"; bez tabele "x" je vecinom mrtav, pa GC prepisuje "y" i brise ga
+		vector<unique_ptr<SSTable>> tabele = sst.getTablesFromLevel(1), stare;
+		for (unique_ptr<SSTable>& t : tabele) {
+			if (t->getSummaryMin() == "x000") stare.push_back(std::move(t));
+		}
+		ispravno &= stare.size() == 1;
+		sst.removeSSTables(stare);
+		sst.collectValueLogGarbage();
+		ispravno &= !filesystem::exists(Config::data_directory + "/vlog/vlog_0.log");
+		for (const Record& r : y) ispravno &= sst.get(r.key) == optional<string>(r.value);
+		ispravno &= !sst.get("x005").has_value();
+
+		// Novija vrednost je u value logu koji vise ne postoji: get prijavljuje gresku umesto starije vrednosti sa nivoa 2
+		vector<Record> z = zapisiTabele("z", 5, 3);
+		sst.write(z, 2);
+		sst.write(velike("z", 5, 4), 1);
+		filesystem::remove_all(Config::data_directory + "/vlog");
+		for (const Record& r : z) {
+			try {
+				sst.get(r.key);
+				ispravno = false;
+			}
+			catch (const runtime_error&) {}
+		}
+	}
+	filesystem::remove_all(Config::data_directory);
+	Config::value_log_threshold = 0;
+	Config::value_log_file_size = 64 * 1024 * 1024;
+
+	cout << "Value log i GC | ispravno: " << (ispravno ? "da" : "NE") << "\n";
+	return ispravno;
+}
+
+// Sredjena lista brisanja opsega (sortirana, bez preklapanja) daje isti timestamp kao linearni prolaz
+static bool proveriSredjenaBrisanjaOpsega() {
+	bool ispravno = true;
+	mt19937 gen(7);
+	auto kljuc = [](int i) {
+		char buf[8];
+		snprintf(buf, sizeof(buf), "k%02d", i);
+		return string(buf);
+	};
+	for (int proba = 0; proba < 200; proba++) {
+		vector<RangeTombstone> brisanja;
+		size_t n = gen() % 12;
+		for (size_t i = 0; i < n; i++) {
+			int a = gen() % 40, b = gen() % 40;
+			brisanja.push_back(RangeTombstone{ kljuc(min(a, b)), kljuc(max(a, b)), 1 + gen() % 5 });
+		}
+		vector<RangeTombstone> sredjena = brisanja;
+		coalesceRangeTombstones(sredjena);
+
+		for (size_t i = 0; i < sredjena.size(); i++) {
+			ispravno &= sredjena[i].begin < sredjena[i].end && sredjena[i].timestamp > 0;
+			if (i > 0) ispravno &= !(sredjena[i].begin < sredjena[i - 1].end);
+		}
+		for (int i = 0; i <= 40; i++) {
+			for (const string& k : { kljuc(i), kljuc(i) + "x" }) {
+				uint64_t ocekivano = 0;
+				for (const RangeTombstone& t : brisanja) {
+					if (t.covers(k)) ocekivano = max(ocekivano, t.timestamp);
+				}
+				ispravno &= coveringTimestamp(sredjena, k) == ocekivano;
+			}
+		}
+	}
+
+	cout << "Sredjena brisanja opsega | ispravno: " << (ispravno ? "da" : "NE") << "\n";
+	return ispravno;
+}
+
+// Fajl tabele na nivou 1 cije ime pocinje sa prefiksom (npr. "summary_raw_")
+static string fajlTabele(const string& prefiks) {
+	for (const auto& f : filesystem::directory_iterator(Config::data_directory + "/level_1")) {
+		if (f.path().filename().string().rfind(prefiks, 0) == 0) return f.path().string();
+	}
+	return "";
+}
+
+// Broj nivoa particija ispod korena, iz summary dela (od TOC_VERSION_PARTITIONED_INDEX)
+static uint32_t nivoiIndeksa(TOC& toc, const vector<Record>& zapisi) {
+	ifstream data(fajlTabele("data_raw_"), ios::binary);
+	data.read(reinterpret_cast<char*>(&toc), sizeof(toc));
+	ifstream summary(fajlTabele("summary_raw_"), ios::binary);
+	summary.seekg(toc.summary_offset + 3 * sizeof(uint64_t) + zapisi.front().key.size() + zapisi.back().key.size());
+	uint32_t nivoi = 0;
+	summary.read(reinterpret_cast<char*>(&nivoi), sizeof(nivoi));
+	return summary ? nivoi : 0;
+}
+
+// get, prvi/poslednji kljuc i citanje redom jedine tabele na nivou 1, sa novim Block_manager-om
+static bool proveriOtvorenuTabelu(const vector<Record>& zapisi) {
+	Block_manager bm;
+	SSTManager sst(&bm);
+	vector<unique_ptr<SSTable>> tabele = sst.getTablesFromLevel(1);
+	if (tabele.size() != 1) return false;
+
+	vector<uint64_t> offseti;
+	vector<string> kljucevi;
+	bool ispravno = proveriGet(*tabele[0], zapisi) && procitajRedom(*tabele[0], offseti, kljucevi);
+	ispravno &= tabele[0]->getSummaryMin() == zapisi.front().key && tabele[0]->getSummaryMax() == zapisi.back().key;
+	ispravno &= kljucevi.size() == zapisi.size() && equal(kljucevi.begin(), kljucevi.end(), zapisi.begin(),
+		[](const string& k, const Record& z) { return k == z.key; });
+	return ispravno;
+}
+
+// Index u vise nivoa particija (mali blokovi, mnogo kljuceva) i tabele verzija 2-4 sa jednim nivoom,
+// bez broja nivoa u summary delu
+static bool proveriParticionisanIndeks() {
+	bool ispravno = true;
+	Config::compress_sstable = false;
+	Config::index_sparsity = 1;
+	Config::block_size = 128;
+	vector<Record> zapisi = napraviZapise(3000, 10);
+	for (bool blokFormat : { false, true }) {
+		Config::sstable_block_format = blokFormat;
+		pripremiDirektorijum("proba_particija");
+		{
+			Block_manager bm;
+			SSTManager sst(&bm);
+			sst.write(zapisi, 1);
+		}
+		TOC toc;
+		uint32_t nivoi = nivoiIndeksa(toc, zapisi);
+		ispravno &= toc.version >= TOC_VERSION_PARTITIONED_INDEX && nivoi > 2;
+		ispravno &= proveriOtvorenuTabelu(zapisi);
+		if (!ispravno) cout << "  particionisan index ne radi, blok format: " << blokFormat << ", nivoa: " << nivoi << "\n";
+	}
+	Config::sstable_block_format = false;
+
+	// Sa vecim blokom koren staje u jedan blok iznad jednog nivoa particija, kao u starim tabelama
+	Config::block_size = 4096;
+	Config::index_sparsity = 4;
+	zapisi = napraviZapise(300, 10);
+	for (uint64_t verzija : { TOC_VERSION_KEY_BLOCKS, TOC_VERSION_MERKLE_BLOCKS, TOC_VERSION_RANGE_TOMBSTONES }) {
+		pripremiDirektorijum("proba_particija");
+		{
+			Block_manager bm;
+			SSTManager sst(&bm);
+			sst.write(zapisi, 1);
+		}
+		TOC toc;
+		ispravno &= nivoiIndeksa(toc, zapisi) == 1;
+
+		// Izbacujemo broj nivoa iz summary dela i vracamo verziju u TOC-u
+		string putanja = fajlTabele("summary_raw_");
+		string summary;
+		{
+			ifstream in(putanja, ios::binary);
+			summary.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+		}
+		summary.erase(toc.summary_offset + 3 * sizeof(uint64_t) + zapisi.front().key.size() + zapisi.back().key.size(), sizeof(uint32_t));
+		summary.append(sizeof(uint32_t), '\0'); // Block_manager cita cele blokove
+		ofstream(putanja, ios::binary | ios::trunc).write(summary.data(), summary.size());
+		fstream data(fajlTabele("data_raw_"), ios::binary | ios::in | ios::out);
+		data.seekp(offsetof(TOC, version));
+		data.write(reinterpret_cast<const char*>(&verzija), sizeof(verzija));
+		data.close();
+
+		bool stara = proveriOtvorenuTabelu(zapisi);
+		if (!stara) cout << "  tabela verzije " << verzija << " ne radi\n";
+		ispravno &= stara;
+	}
+	filesystem::remove_all(Config::data_directory);
+	Config::index_sparsity = 32;
+
+	cout << "Particionisan index | ispravno: " << (ispravno ? "da" : "NE") << "\n";
+	return ispravno;
+}
+
+// Hes indeks data blokova u jednom fajlu i u vise fajlova, za razlicite restart intervale. Tabela se
+// cita i kada je podesavanje u Config-u promenjeno posle upisa. Blok sa previse restart tacaka nema indeks.
+static bool proveriHesIndeksBlokova() {
+	bool ispravno = true;
+	Config::compress_sstable = false;
+	Config::sstable_block_format = true;
+	Config::block_compression = "none";
+	Config::block_size = 512;
+	vector<Record> zapisi = napraviZapise(1500);
+	for (bool jedanFajl : { false, true }) {
+		Config::sstable_single_file = jedanFajl;
+		for (int interval : { 1, 4, 16 }) {
+			Config::block_restart_interval = interval;
+			uintmax_t velicina[2] = { 0, 0 };
+			for (bool hes : { false, true }) {
+				Config::block_hash_index = hes;
+				pripremiDirektorijum("proba_hes_indeksa");
+				{
+					Block_manager bm;
+					SSTManager sst(&bm);
+					sst.write(zapisi, 1);
+				}
+				velicina[hes] = filesystem::file_size(fajlTabele(jedanFajl ? "sstable_sf_raw_" : "data_raw_"));
+
+				bool radi = proveriOtvorenuTabelu(zapisi);
+				Config::block_hash_index = !hes;
+				radi &= proveriOtvorenuTabelu(zapisi);
+				if (!radi) {
+					cout << "  hes indeks ne radi: " << (jedanFajl ? "jedan fajl" : "vise fajlova")
+						<< ", interval " << interval << (hes ? ", upisan sa indeksom" : ", upisan bez indeksa") << "\n";
+				}
+				ispravno &= radi;
+			}
+			ispravno &= velicina[1] > velicina[0];
+		}
+	}
+	Config::sstable_single_file = false;
+
+	// Vise od 254 restart tacke u bloku: blok se upisuje bez indeksa i get ide binarnom pretragom
+	Config::block_size = 16384;
+	Config::block_restart_interval = 1;
+	Config::block_hash_index = true;
+	ispravno &= proveriTabelu("blok bez mesta za hes indeks", napraviZapise(1500, 4));
+
+	filesystem::remove_all(Config::data_directory);
+	Config::block_hash_index = false;
+	Config::block_restart_interval = 16;
+	Config::sstable_block_format = false;
+
+	cout << "Hes indeks data blokova | ispravno: " << (ispravno ? "da" : "NE") << "\n";
+	return ispravno;
+}
+
 int main() {
 	//Config::load_init_configuration();
 	cout << "Evo ti\n";
@@ -9,7 +883,15 @@ int main() {
 	string key = "key";
 	bool deleted = 1;
 
+	if (!proveriPamcenjeBlokova() || !proveriPretraguBlokova() || !proveriKesOtvorenihTabela() ||
+		!proveriOpsegeNivoa() || !proveriManifest() ||
+		!proveriEkstraktorPrefiksa() || !proveriRecnikKljuceva() ||
+		!proveriBaferovanoCitanje() || !proveriValueLog() || !proveriSredjenaBrisanjaOpsega() ||
+		!proveriParticionisanIndeks() || !proveriHesIndeksBlokova()) {
+		return 1;
+	}
 
+	uporediKodeke();
 
 	return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,148 @@
+#include "ValueLog.h"
+#include "../Config/Config.h"
+#include "../MurmurHash3/MurmurHash3.h"
+#include "../Utils/VarEncoding.h"
+#include <filesystem>
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+
+namespace fs = std::filesystem;
+
+// Varint iz stringa, bez citanja preko kraja (pokazivac i zaglavlje zapisa mogu biti osteceni)
+static bool readVarint(const std::string& in, size_t& pos, uint64_t& value) {
+    value = 0;
+    size_t bitOffset = 0;
+    while (pos < in.size() && bitOffset < 64) {
+        if (varenc::decodeVarint<uint64_t>(in[pos++], value, bitOffset)) return true;
+    }
+    return false;
+}
+
+ValueLog::ValueLog(const std::string& directory) : directory_(directory), active_(0) {
+    // vlog_<id>.log; novi segment dobija ID posle najveceg postojeceg
+    if (fs::exists(directory_) && fs::is_directory(directory_)) {
+        for (const auto& entry : fs::directory_iterator(directory_)) {
+            if (!entry.is_regular_file()) continue;
+
+            std::string filename = entry.path().filename().string();
+            if (filename.rfind("vlog_", 0) != 0 || entry.path().extension() != ".log") continue;
+
+            try {
+                uint32_t id = std::stoul(filename.substr(5, filename.size() - 5 - 4));
+                segments_[id] = entry.file_size();
+                active_ = std::max(active_, id + 1);
+            }
+            catch (const std::exception&) {
+                std::cerr << "[ValueLog] Ne validan format: " << filename << "\n";
+            }
+        }
+    }
+}
+
+std::string ValueLog::segmentPath(uint32_t id) const {
+    return directory_ + "/vlog_" + std::to_string(id) + ".log";
+}
+
+uint32_t ValueLog::checksum(const char* data, size_t len) {
+    uint32_t hash = 0;
+    MurmurHash3_x86_32(data, static_cast<int>(len), 0, &hash);
+    return hash;
+}
+
+std::string ValueLog::append(const std::string& key, const std::string& value) {
+    // Segment se otvara tek pri prvom upisu, pa baza bez velikih vrednosti nema ni jedan
+    const uint64_t limit = std::max(1, Config::value_log_file_size);
+    if (out_.is_open() && segments_[active_] >= limit) {
+        out_.close();
+        active_++;
+    }
+    if (!out_.is_open()) {
+        fs::create_directories(directory_);
+        out_.open(segmentPath(active_), std::ios::binary | std::ios::app);
+        if (!out_.is_open()) {
+            std::cerr << "[ValueLog] Failed to open " << segmentPath(active_) << "\n";
+        }
+        segments_[active_] = 0;
+    }
+
+    std::string body = varenc::encodeVarint<uint64_t>(key.size());
+    body.append(varenc::encodeVarint<uint64_t>(value.size()));
+    body.append(key);
+    body.append(value);
+
+    uint32_t sum = checksum(body.data(), body.size());
+    out_.write(reinterpret_cast<const char*>(&sum), sizeof(sum));
+    out_.write(body.data(), body.size());
+
+    Pointer ptr;
+    ptr.segment = active_;
+    ptr.offset = segments_[active_];
+    ptr.length = sizeof(sum) + body.size();
+    segments_[active_] += ptr.length;
+
+    std::string encoded = varenc::encodeVarint<uint32_t>(ptr.segment);
+    encoded.append(varenc::encodeVarint<uint64_t>(ptr.offset));
+    encoded.append(varenc::encodeVarint<uint64_t>(ptr.length));
+    return encoded;
+}
+
+void ValueLog::flush() {
+    if (out_.is_open()) out_.flush();
+}
+
+bool ValueLog::decodePointer(const std::string& encoded, Pointer& ptr) {
+    size_t pos = 0;
+    uint64_t segment = 0;
+    if (!readVarint(encoded, pos, segment) || !readVarint(encoded, pos, ptr.offset) ||
+        !readVarint(encoded, pos, ptr.length) || pos != encoded.size()) {
+        return false;
+    }
+    ptr.segment = static_cast<uint32_t>(segment);
+    return true;
+}
+
+bool ValueLog::read(const std::string& pointer, std::string& value) const {
+    Pointer ptr;
+    if (!decodePointer(pointer, ptr) || ptr.length < sizeof(uint32_t)) {
+        std::cerr << "[ValueLog] Neispravan pokazivac u value log\n";
+        return false;
+    }
+
+    std::ifstream in(segmentPath(ptr.segment), std::ios::binary);
+    std::string entry(ptr.length, '\0');
+    if (!in.is_open() || !in.seekg(ptr.offset) || !in.read(&entry[0], ptr.length)) {
+        std::cerr << "[ValueLog] Zapis " << ptr.segment << ":" << ptr.offset << " ne postoji\n";
+        return false;
+    }
+
+    uint32_t sum;
+    std::memcpy(&sum, entry.data(), sizeof(sum));
+    if (sum != checksum(entry.data() + sizeof(sum), entry.size() - sizeof(sum))) {
+        std::cerr << "[ValueLog] Zapis " << ptr.segment << ":" << ptr.offset << " je ostecen\n";
+        return false;
+    }
+
+    size_t pos = sizeof(sum);
+    uint64_t keyLen = 0, valueLen = 0;
+    if (!readVarint(entry, pos, keyLen) || !readVarint(entry, pos, valueLen) ||
+        pos + keyLen + valueLen != entry.size()) {
+        std::cerr << "[ValueLog] Zapis " << ptr.segment << ":" << ptr.offset << " je ostecen\n";
+        return false;
+    }
+
+    value.assign(entry, pos + keyLen, valueLen);
+    return true;
+}
+
+void ValueLog::removeSegment(uint32_t id) {
+    if (id == active_) return;
+
+    std::error_code ec;
+    fs::remove(segmentPath(id), ec);
+    if (ec) {
+        std::cerr << "[ValueLog] Failed to remove " << segmentPath(id) << ": " << ec.message() << "\n";
+        return;
+    }
+    segments_.erase(id);
+}
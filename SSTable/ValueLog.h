@@ -0,0 +1,63 @@
+#pragma once
+
+#include <string>
+#include <map>
+#include <fstream>
+#include <cstdint>
+#include <cstddef>
+
+// Bajt tombstone zapisa u SSTabeli: bit 0 - obrisan, bit 1 - vrednost je u value logu,
+// a u tabeli je umesto nje pokazivac (ValueLog::append)
+constexpr std::byte TOMBSTONE_DELETED{ 1 };
+constexpr std::byte TOMBSTONE_VALUE_POINTER{ 2 };
+
+/**
+ * ValueLog - append-only log velikih vrednosti (kljucevi i vrednosti razdvojeni, kao u WiscKey).
+ *
+ * SSTabela za vrednost od bar Config::value_log_threshold bajtova cuva samo pokazivac, pa
+ * kompakcija prepisuje samo kljuceve i pokazivace, a vrednost se upisuje jednom.
+ *
+ * Log je podeljen u segmente <data>/vlog/vlog_<id>.log. Upisuje se samo u aktivni segment:
+ * svako pokretanje pocinje novi, a kada predje Config::value_log_file_size prelazi se na sledeci.
+ * Segment se posle ne menja, samo se ceo brise kada ga nijedna tabela iz MANIFEST-a vise ne
+ * koristi (SSTManager::collectValueLogGarbage).
+ *
+ * Zapis: [uint32 checksum][varint duzina kljuca][varint duzina vrednosti][kljuc][vrednost],
+ * checksum je MurmurHash3 nad ostatkom zapisa.
+ * Pokazivac (vrednost zapisa u tabeli): [varint segment][varint offset][varint duzina zapisa].
+ */
+class ValueLog {
+public:
+    struct Pointer {
+        uint32_t segment = 0;
+        uint64_t offset = 0;
+        uint64_t length = 0; // duzina celog zapisa u logu
+    };
+
+    explicit ValueLog(const std::string& directory);
+
+    // Upisuje vrednost na kraj aktivnog segmenta i vraca pokazivac koji ide u tabelu
+    std::string append(const std::string& key, const std::string& value);
+    // Poziva se pre upisa tabele koja pokazuje na upravo dodate vrednosti
+    void flush();
+
+    // Cita vrednost na koju pokazuje pokazivac; false ako zapis ne postoji ili je ostecen
+    bool read(const std::string& pointer, std::string& value) const;
+
+    static bool decodePointer(const std::string& encoded, Pointer& ptr);
+
+    // Segmenti na disku: ID -> velicina u bajtovima
+    const std::map<uint32_t, uint64_t>& segments() const { return segments_; }
+    // Segment u koji se upisuje; GC ga ne dira
+    uint32_t activeSegment() const { return active_; }
+    void removeSegment(uint32_t id);
+
+private:
+    std::string directory_;
+    std::map<uint32_t, uint64_t> segments_;
+    uint32_t active_;
+    std::ofstream out_;
+
+    std::string segmentPath(uint32_t id) const;
+    static uint32_t checksum(const char* data, size_t len);
+};
@@ -1,43 +1,20 @@
 #include "SSTableCursor.h"
-#include <filesystem>
-#include <regex>
-
-namespace fs = std::filesystem;
 
 SSTableCursor::SSTableCursor(SSTManager* sstmp,
                              MemtableManager* mtmp)
                             : sst_manager(sstmp),
                               memt_manager(mtmp),
-                              prefix_scan_prepared(false),
-                              range_scan_prepared(false)
+                              memtableBoundIsPrefix(false),
+                              range_scan_prepared(false),
+                              prefix_scan_prepared(false)
 {
     read_tables();
 }
 
 
 void SSTableCursor::read_tables() {
-    const fs::path data_dir = Config::data_directory;
-    const std::regex re("^level_(\\d+)$");
-    std::vector<int> levels;
-
-    if (fs::exists(data_dir) && fs::is_directory(data_dir)) {
-        for (auto const& entry : fs::directory_iterator(data_dir)) {
-
-            // Proveravamo da li je direktorijum
-            if (!fs::is_directory(entry.status())) continue;
-
-            std::string name = entry.path().filename().string();
-            std::smatch m;
-            if (std::regex_match(name, m, re)) {
-                try {
-                    int lvl = std::stoi(m[1].str());
-                    levels.push_back(lvl);
-                } catch (const std::exception& e) {
-                    // Ignorisi
-                }
-            }
-        }
-    }
+    // Nivoi iz trenutne verzije (MANIFEST), bez listanja data direktorijuma
+    std::vector<int> levels = sst_manager->getLevels();
 
     for(int l : levels) {
         vector<unique_ptr<SSTable>> sst_from_level = sst_manager->getTablesFromLevel(l);
@@ -47,6 +24,9 @@ void SSTableCursor::read_tables() {
         for (auto &uptr : sst_from_level) {
             std::shared_ptr<SSTable> sptr = std::shared_ptr<SSTable>(std::move(uptr));
             sstables.push_back(sptr);
+            // Brisanje opsega vazi i za kljuceve iz drugih tabela, pa se skupljaju iz svih
+            const vector<RangeTombstone>& tombstones = sptr->rangeTombstones();
+            sstRangeTombstones.insert(sstRangeTombstones.end(), tombstones.begin(), tombstones.end());
             // candidates.emplace_back(sptr);
             SSTableIterator ssti(sptr); // Pravimo novi iterator. Pocinje sa offset = data_start.
             sst_iterators.push_back(ssti);
@@ -60,7 +40,7 @@ vector<Record> SSTableCursor::prefix_scan(const std::string& prefix, int page_si
     vector<Record> ret;
     ret.reserve(page_size);
     
-    if(candidates.empty() && memtableCandidates.empty()){
+    if(candidates.empty() && !memtableHasNext()){
         end = true;
         return ret;
     }
@@ -126,22 +106,17 @@ vector<Record> SSTableCursor::prefix_scan(const std::string& prefix, int page_si
         // Imamo listu kandidata koji svi imaju isti, najmanji kljuc.
 
         // Da li u memtabeli ima manji?
-        if(!memtableCandidates.empty()) {
-            if(memtableCandidates.back().key < min_key) {
-                Record r;
-                r.key = memtableCandidates.back().key;
-                r.value = memtableCandidates.back().value;
-                r.timestamp = memtableCandidates.back().timestamp;
-                r.tombstone = static_cast<std::byte>(memtableCandidates.back().tombstone);
-                ret.push_back(r);
-                memtableCandidates.pop_back();
+        if(memtableHasNext()) {
+            if(memtableIter->key() < min_key) {
+                if(!memtableIter->tombstone() && !rangeDeleted(memtableIter->key(), memtableIter->timestamp())) ret.push_back(memtableRecord());
+                memtableIter->next();
                 
-                if(ret.size() == page_size && (!candidates.empty() || memtableCandidates.empty())) {
+                if(ret.size() == page_size && (!candidates.empty() || !memtableHasNext())) {
                     end = false;
                     return ret;
                 }
     
-                if(candidates.empty() && memtableCandidates.empty()){
+                if(candidates.empty() && !memtableHasNext()){
                     end = true;
                     return ret;
                 }
@@ -163,20 +138,23 @@ vector<Record> SSTableCursor::prefix_scan(const std::string& prefix, int page_si
         Record winner = min_candidates[newest_idx]->curr_record;
 
         // Ako u memtabeli isti kljuc, skidamo i njega.
-        if(!memtableCandidates.empty()) {
-            if(memtableCandidates.back().key == winner.key) {
+        if(memtableHasNext()) {
+            if(memtableIter->key() == winner.key) {
                 // Ako je u memtabeli noviji zapis
-                if(memtableCandidates.back().timestamp > winner.timestamp) {
-                    winner.value = memtableCandidates.back().value;
-                    winner.timestamp = memtableCandidates.back().timestamp;
-                    winner.tombstone = static_cast<byte>(memtableCandidates.back().tombstone);
+                if(memtableIter->timestamp() > winner.timestamp) {
+                    winner.value = memtableIter->value();
+                    winner.timestamp = memtableIter->timestamp();
+                    winner.tombstone = static_cast<byte>(memtableIter->tombstone());
                 }
-                memtableCandidates.pop_back();
+                memtableIter->next();
             }
         }
 
-        bool tombstone = static_cast<bool>(winner.tombstone);
-        if(!tombstone) ret.push_back(winner);
+        bool tombstone = (winner.tombstone & TOMBSTONE_DELETED) != std::byte{0} || rangeDeleted(winner.key, winner.timestamp);
+        if(!tombstone) {
+            sst_manager->loadValue(winner);
+            ret.push_back(winner);
+        }
 
         // Pomeramo sve iteratore za kandidate koji su imali min kljuc
         for(int i = 0; i < min_candidates.size(); ++i) {
@@ -196,31 +174,24 @@ vector<Record> SSTableCursor::prefix_scan(const std::string& prefix, int page_si
             
         }
  
-        if(ret.size() == page_size && (!candidates.empty() || memtableCandidates.empty())) {
+        if(ret.size() == page_size && (!candidates.empty() || !memtableHasNext())) {
             end = false;
             return ret;
         }
 
-        if(candidates.empty() && memtableCandidates.empty()){
+        if(candidates.empty() && !memtableHasNext()){
             end = true;
             return ret;
         } 
     }
 
-    size_t needed = page_size - ret.size();
-    size_t take = min(needed, memtableCandidates.size());
-
-    for(int i = 0; i < take; ++i) {
-        auto memEntry = memtableCandidates.back();
-        Record r;
-        r.key = memEntry.key;
-        r.value = memEntry.value;
-        r.timestamp = memEntry.timestamp;
-        ret.push_back(r);
-        memtableCandidates.pop_back();
+    // SSTabele su potrosene, ostatak strane popunjavamo iz memtable
+    while(ret.size() < page_size && memtableHasNext()) {
+        if(!memtableIter->tombstone() && !rangeDeleted(memtableIter->key(), memtableIter->timestamp())) ret.push_back(memtableRecord());
+        memtableIter->next();
     }
 
-    end = memtableCandidates.empty();
+    end = !memtableHasNext();
 
     return ret;
 }
@@ -231,7 +202,7 @@ vector<Record> SSTableCursor::range_scan(const std::string& min_key, const std::
     vector<Record> ret;
     ret.reserve(page_size);
     
-    if(candidates.empty() && memtableCandidates.empty()){
+    if(candidates.empty() && !memtableHasNext()){
         end = true;
         return ret;
     }
@@ -297,21 +268,17 @@ vector<Record> SSTableCursor::range_scan(const std::string& min_key, const std::
         // Imamo listu kandidata koji svi imaju isti, najmanji kljuc.
 
         // Da li u memtabeli ima manji?
-        if(!memtableCandidates.empty()) {
-            if(memtableCandidates.back().key < min_key_sst) {
-                Record r;
-                r.key = memtableCandidates.back().key;
-                r.value = memtableCandidates.back().value;
-                r.timestamp = memtableCandidates.back().timestamp;
-                ret.push_back(r);
-                memtableCandidates.pop_back();
+        if(memtableHasNext()) {
+            if(memtableIter->key() < min_key_sst) {
+                if(!memtableIter->tombstone() && !rangeDeleted(memtableIter->key(), memtableIter->timestamp())) ret.push_back(memtableRecord());
+                memtableIter->next();
                 
-                if(ret.size() == page_size && (!candidates.empty() || memtableCandidates.empty())) {
+                if(ret.size() == page_size && (!candidates.empty() || !memtableHasNext())) {
                     end = false;
                     return ret;
                 }
     
-                if(candidates.empty() && memtableCandidates.empty()){
+                if(candidates.empty() && !memtableHasNext()){
                     end = true;
                     return ret;
                 }
@@ -334,20 +301,23 @@ vector<Record> SSTableCursor::range_scan(const std::string& min_key, const std::
         Record winner = min_candidates[newest_idx]->curr_record;
 
         // Ako u memtabeli isti kljuc, skidamo i njega.
-        if(!memtableCandidates.empty()) {
-            if(memtableCandidates.back().key == winner.key) {
+        if(memtableHasNext()) {
+            if(memtableIter->key() == winner.key) {
                 // Ako je u memtabeli noviji zapis
-                if(memtableCandidates.back().timestamp > winner.timestamp) {
-                    winner.value = memtableCandidates.back().value;
-                    winner.timestamp = memtableCandidates.back().timestamp;
-                    winner.tombstone = static_cast<byte>(memtableCandidates.back().tombstone);
+                if(memtableIter->timestamp() > winner.timestamp) {
+                    winner.value = memtableIter->value();
+                    winner.timestamp = memtableIter->timestamp();
+                    winner.tombstone = static_cast<byte>(memtableIter->tombstone());
                 }
-                memtableCandidates.pop_back();
+                memtableIter->next();
             }
         }
 
-        bool tombstone = static_cast<bool>(winner.tombstone);
-        if(!tombstone) ret.push_back(winner);
+        bool tombstone = (winner.tombstone & TOMBSTONE_DELETED) != std::byte{0} || rangeDeleted(winner.key, winner.timestamp);
+        if(!tombstone) {
+            sst_manager->loadValue(winner);
+            ret.push_back(winner);
+        }
 
 
         // Pomeramo sve iteratore za kandidate koji su imali min kljuc
@@ -368,31 +338,24 @@ vector<Record> SSTableCursor::range_scan(const std::string& min_key, const std::
             else candidates.erase(min_iterators[i]);
         }
 
-        if(ret.size() == page_size && (!candidates.empty() || memtableCandidates.empty())) {
+        if(ret.size() == page_size && (!candidates.empty() || !memtableHasNext())) {
             end = false;
             return ret;
         }
 
-        if(candidates.empty() && memtableCandidates.empty()){
+        if(candidates.empty() && !memtableHasNext()){
             end = true;
             return ret;
         }
     }
 
-    size_t needed = page_size - ret.size();
-    size_t take = min(needed, memtableCandidates.size());
-
-    for(int i = 0; i < take; ++i) {
-        auto memEntry = memtableCandidates.back();
-        Record r;
-        r.key = memEntry.key;
-        r.value = memEntry.value;
-        r.timestamp = memEntry.timestamp;
-        ret.push_back(r);
-        memtableCandidates.pop_back();
+    // SSTabele su potrosene, ostatak strane popunjavamo iz memtable
+    while(ret.size() < page_size && memtableHasNext()) {
+        if(!memtableIter->tombstone() && !rangeDeleted(memtableIter->key(), memtableIter->timestamp())) ret.push_back(memtableRecord());
+        memtableIter->next();
     }
 
-    end = memtableCandidates.empty();
+    end = !memtableHasNext();
 
     return ret;
     
@@ -403,22 +366,19 @@ void SSTableCursor::prepare_prefix_scan(const std::string& prefix) {
     if(range_scan_prepared) reset();
 
 
-    // Pripremamo kandidate iz memtabele
-    memtableCandidates = memt_manager->getAllEntries();
-    vector<MemtableEntry> temp;
-
-    for(auto r : memtableCandidates) {
-        if(r.key.rfind(prefix, 0) == 0) {
-            temp.push_back(move(r));
-        }
-    }
-
-    memtableCandidates = temp;
-    
-    std::sort(memtableCandidates.begin(), memtableCandidates.end(),  [](auto& a, auto& b){ return a.key > b.key; }); 
+    // Pripremamo kandidate iz memtabele - iterator staje na prvi kljuc sa prefiksom
+    memtableIter = memt_manager->newIterator();
+    memtableIter->seek(prefix);
+    memtableBound = prefix;
+    memtableBoundIsPrefix = true;
+    rangeTombstones = sstRangeTombstones;
+    vector<RangeTombstone> memtableTombstones = memt_manager->getRangeTombstones();
+    rangeTombstones.insert(rangeTombstones.end(), memtableTombstones.begin(), memtableTombstones.end());
+    coalesceRangeTombstones(rangeTombstones);
 
     for(int i = 0; i < sstables.size(); ++i) {
         if(sstables[i]->getSummaryMax() < prefix) continue;
+        if(!sstables[i]->mayContainPrefix(prefix)) continue; // prefiks filter: tabela sigurno nema taj prefiks
 
         Record r;
         
@@ -450,23 +410,20 @@ void SSTableCursor::prepare_range_scan(const std::string& min_key,const std::str
     if(prefix_scan_prepared) reset();
 
 
-    // Pripremamo kandidate iz memtabele
-    memtableCandidates = memt_manager->getAllEntries();
-    vector<MemtableEntry> temp;
-
-    for(auto r : memtableCandidates) {
-        if(r.key <= max_key && r.key >= min_key) {
-            temp.push_back(move(r));
-        }
-    }
-
-    memtableCandidates = temp;
-    
-    std::sort(memtableCandidates.begin(), memtableCandidates.end(),  [](auto& a, auto& b){ return a.key > b.key; }); 
+    // Pripremamo kandidate iz memtabele - iterator staje na prvi kljuc >= min_key
+    memtableIter = memt_manager->newIterator();
+    memtableIter->seek(min_key);
+    memtableBound = max_key;
+    memtableBoundIsPrefix = false;
+    rangeTombstones = sstRangeTombstones;
+    vector<RangeTombstone> memtableTombstones = memt_manager->getRangeTombstones();
+    rangeTombstones.insert(rangeTombstones.end(), memtableTombstones.begin(), memtableTombstones.end());
+    coalesceRangeTombstones(rangeTombstones);
 
 
     for(int i = 0; i < sstables.size(); ++i) {
         if(sstables[i]->getSummaryMax() < min_key || sstables[i]->getSummaryMin() > max_key) continue;
+        if(!sstables[i]->mayContainRange(min_key, max_key)) continue; // range filter: nijedan kljuc nije u opsegu
 
         bool in_file;
         uint64_t start_offset = sstables[i]->findRecordOffset(min_key, in_file);
@@ -488,4 +445,24 @@ void SSTableCursor::reset(){
     }
     range_scan_prepared = false;
     prefix_scan_prepared = false;
+}
+
+bool SSTableCursor::memtableHasNext() const {
+    if(!memtableIter || !memtableIter->valid()) return false;
+
+    if(memtableBoundIsPrefix) return memtableIter->key().rfind(memtableBound, 0) == 0;
+    return memtableIter->key() <= memtableBound;
+}
+
+Record SSTableCursor::memtableRecord() const {
+    Record r;
+    r.key = memtableIter->key();
+    r.value = memtableIter->value();
+    r.timestamp = memtableIter->timestamp();
+    r.tombstone = static_cast<std::byte>(memtableIter->tombstone());
+    return r;
+}
+
+bool SSTableCursor::rangeDeleted(const std::string& key, uint64_t timestamp) const {
+    return timestamp < coveringTimestamp(rangeTombstones, key);
 }
\ No newline at end of file
@@ -33,7 +33,19 @@ private:
     list<Candidate> candidates;
     vector<SSTableIterator> sst_iterators;
 
-    vector<MemtableEntry> memtableCandidates;
+    // Iterator nad memtable; cita se samo deo unutar granica trenutnog scan-a
+    unique_ptr<MemtableIterator> memtableIter;
+    std::string memtableBound;   // prefiks (prefix scan) ili max_key (range scan)
+    bool memtableBoundIsPrefix;
+
+    // Da li je memtable iterator na zapisu unutar granica scan-a
+    bool memtableHasNext() const;
+    Record memtableRecord() const;
+
+    // Brisanja opsega iz svih tabela (read_tables) i iz memtable (pri pripremi scan-a)
+    vector<RangeTombstone> sstRangeTombstones;
+    vector<RangeTombstone> rangeTombstones;
+    bool rangeDeleted(const std::string& key, uint64_t timestamp) const;
 
     void prepare_prefix_scan(const std::string& prefix);
     void prepare_range_scan(const std::string& min_key,const std::string& max_key);
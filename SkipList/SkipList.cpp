@@ -128,6 +128,17 @@ SkipList::Node* SkipList::getNode(const std::string& key) const {
     return nullptr;
 }
 
+SkipList::NodeHandle SkipList::lowerBound(const std::string& key) const {
+    // Isti spust kao u getNode, samo vracamo i cvor sa vecim kljucem
+    Node* current = head;
+    for (int i = currentLevel; i >= 0; i--) {
+        while (current->forward[i] != nullptr && current->forward[i]->key < key) {
+            current = current->forward[i];
+        }
+    }
+    return current->forward[0];
+}
+
 vector<pair<string, string>> SkipList::getAllKeyValuePairs() const {
     vector<pair<string, string>> result;
     Node* current = head->forward[0];
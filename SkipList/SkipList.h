@@ -70,6 +70,14 @@ public:
     size_t Size() const { return size; }
 
     vector<pair<string, string>> getAllKeyValuePairs() const;
+
+    // Za iteratore: cvor se cita direktno, bez kopiranja zapisa
+    using NodeHandle = const Node*;
+
+    // Prvi cvor sa kljucem >= key (nullptr ako takav ne postoji)
+    NodeHandle lowerBound(const string& key) const;
+    NodeHandle first() const { return head->forward[0]; }
+    static NodeHandle next(NodeHandle node) { return node->forward[0]; }
     
     // vraca sve zapise u jednom prolasku
 	vector<Data> getAllEntries() const;
@@ -207,6 +207,33 @@ void System::del(const string& key) {
     memtable->remove(key);
 }
 
+void System::deleteRange(const string& begin, const string& end) {
+    if (!checkRateLimit()) {
+        return; // Request denied by rate limiter
+    }
+    if (!(begin < end)) {
+        cout << "[SYSTEM] Empty range, nothing to delete.\n";
+        return;
+    }
+
+    cout << "Deleted range from wal\n";
+    wal->delRange(begin, end);
+
+    // kes ne zna za brisanje opsega, pa iz njega odmah izbacujemo sve kljuceve opsega
+    vector<string> cached;
+    for (const auto& entry : cache->cache_map) {
+        if (begin <= entry.first && entry.first < end) {
+            cached.push_back(entry.first);
+        }
+    }
+    for (const string& key : cached) {
+        cache->del(key);
+    }
+
+    cout << "Deleted range from memtable\n";
+    memtable->removeRange(begin, end);
+}
+
 void System::add_records_to_cache(vector<Record> records) {
     int lenght;
     for (Record r : records) {
@@ -256,24 +283,28 @@ optional<string> System::get(const string& key) {
         VRACA NULLOPT AKO KLJUC NE POSTOJI
         VRACA STRING VALUE AKO KLJUC POSTOJI
     */
+    string_view value;
+    if (!getView(key, value)) {
+        return nullopt;
+    }
+    return string(value);
+}
 
+bool System::getView(const string& key, string_view& value) {
     if (!checkRateLimit()) {
         cout << "Premasili ste broj upita po jedinici vremena, probajte kasnije\n OVO BI MOGLO BOLJE";
-        return nullopt; // Request denied by rate limiter
+        return false; // Request denied by rate limiter
     }
 
     bool deleted;
-    // searching memtable
-    auto value = memtable->get(key, deleted);
+    // searching memtable - value pokazuje direktno u memtable
+    if (memtable->getView(key, value, deleted)) {
+        return true;
+    }
 
     // key exists in memtable, but is deleted
     if (deleted) {
-        return nullopt;
-    }
-
-    // key exists in memtable, return value
-    else if (value.has_value()) {
-        return value.value();
+        return false;
     }
 
     // key doesnt exists in memtable. Read path goes forward
@@ -283,28 +314,29 @@ optional<string> System::get(const string& key) {
     vector<byte> bytes = cache->get(key, exists);
     // key exists in cache, return it
     if (exists) {
-        // converting from vector<byte> to string ret
-        string ret(bytes.size(), '\0');
-        memcpy(ret.data(), bytes.data(), bytes.size());
-
-        deleted = false;
-        return ret;
+        // converting from vector<byte> to string
+        pinnedValue.assign(reinterpret_cast<const char*>(bytes.data()), bytes.size());
+        value = pinnedValue;
+        return true;
     }
 
     // searching sstable (disc)
-    value = sstable->get(key);
+    optional<string> fromDisk = sstable->get(key);
+    if (fromDisk == nullopt) {
+        return false;
+    }
 
     // update cache
-    if (value != nullopt) {
-        int lenght = value.value().size();
+    int lenght = fromDisk.value().size();
 
-        vector<byte> valueInBytes(lenght);
-        memcpy(valueInBytes.data(), value.value().data(), lenght);
+    vector<byte> valueInBytes(lenght);
+    memcpy(valueInBytes.data(), fromDisk.value().data(), lenght);
 
-        cache->put(key, valueInBytes);
-    }
+    cache->put(key, valueInBytes);
 
-    return value;
+    pinnedValue = std::move(fromDisk.value());
+    value = pinnedValue;
+    return true;
 }
 
 void System::debugWal() const {
@@ -436,4 +468,13 @@ void System::validateSSTables(int level) {
     else {
         std::cerr << "[SYSTEM ERROR] SSTManager nije inicijalizovan." << std::endl;
     }
+}
+
+void System::validateSSTables(int level, const std::string& min_key, const std::string& max_key) {
+    if (sstable) {
+        sstable->validateTablesForLevel(level, min_key, max_key);
+    }
+    else {
+        std::cerr << "[SYSTEM ERROR] SSTManager nije inicijalizovan." << std::endl;
+    }
 }
\ No newline at end of file
@@ -29,8 +29,14 @@ public:
 
 	void put(const std::string& key, const std::string& value);
 	void del(const std::string& key);
+	// Brise sve kljuceve iz [begin, end) jednim zapisom, bez citanja kljuceva iz opsega
+	void deleteRange(const std::string& begin, const std::string& end);
 	std::optional<std::string> get(const std::string& key);
 
+	// Kao get, ali bez kopiranja vrednosti iz memtable. value vazi do sledeceg poziva
+	// put/del/get/getView nad System-om. Vraca false ako kljuc ne postoji.
+	bool getView(const std::string& key, std::string_view& value);
+
 	TypesManager* getTypesManager();
 
 	void debugWal() const;
@@ -44,6 +50,7 @@ public:
 	void prefixScan(const std::string& prefix, int page_size);
 	void rangeScan(const std::string& min_Key, const std::string& max_key, int page_size);
 	void validateSSTables(int level);
+	void validateSSTables(int level, const std::string& min_key, const std::string& max_key);
 
 
 private:
@@ -62,4 +69,7 @@ private:
 	void loadTokenBucket();
 	bool checkRateLimit(); // Vraca true ako je prihvacen
 
+	// Vrednost procitana iz cache-a ili SSTabele, na koju pokazuje poslednji getView
+	std::string pinnedValue;
+
 };
\ No newline at end of file
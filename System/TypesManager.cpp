@@ -55,7 +55,7 @@ bool TypesManager::createBloomFilter(const string& key, int n, double p) {
 
     cout << "Creating Bloom Filter with key: " << key << ", n: " << n << ", p: " << p << endl;
 
-    BloomFilter bf(n, p);
+    BloomFilter bf(n, p, Config::bloom_filter_blocked);
     vector<byte> serializedBf = bf.serialize();
 
     system->put(storageKey, bytesToString(serializedBf));
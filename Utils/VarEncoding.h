@@ -35,4 +35,31 @@ namespace varenc {
         return !more;
     }
 
+    // Najvise bajtova koje zauzima varint tipa UInt (5 za uint32_t, 10 za uint64_t)
+    template<typename UInt>
+    constexpr size_t maxVarintLen() {
+        return (sizeof(UInt) * 8 + 6) / 7;
+    }
+
+    // Dekodira ceo varint iz memorije; in mora imati bar maxVarintLen<UInt>() bajtova.
+    // Vraca broj procitanih bajtova, ili 0 ako varint nije zavrsen u tom opsegu (ostecen zapis).
+    template<typename UInt>
+    size_t decodeVarint(const uint8_t* in, UInt& value) {
+        // Najcesci slucaj (mali brojevi, ID-evi, flegovi) je jedan bajt
+        if (in[0] < 0x80) {
+            value = in[0];
+            return 1;
+        }
+
+        UInt result = in[0] & 0x7F;
+        for (size_t i = 1; i < maxVarintLen<UInt>(); ++i) {
+            result |= UInt(in[i] & 0x7F) << (7 * i);
+            if (in[i] < 0x80) {
+                value = result;
+                return i + 1;
+            }
+        }
+        return 0;
+    }
+
 }
\ No newline at end of file
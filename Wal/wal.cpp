@@ -195,10 +195,10 @@ ull byte_to_ull(byte* c) {
 
 ull byte_to_uint(byte* c) {
 	uint ret = 0;
-	int broj;
+	uint broj;
 	for (ll i = 3; i >= 0; i--) {
-		broj = ((ll)c[i]);
-		ret += (broj << ((7 - i) * 8));
+		broj = ((uint)c[i]);
+		ret += (broj << ((3 - i) * 8));		// CRC je 4 bajta; pomeranje za 32+ bita je nedefinisano
 	}
 	return ret;
 }
@@ -498,6 +498,10 @@ void Wal::del(string key) {
 	write_record(key, "", (byte)1);
 }
 
+void Wal::delRange(string begin, string end) {
+	write_record(begin, end, TOMBSTONE_RANGE);
+}
+
 void Wal::delete_old_logs(string target_file) {
 	/**
 	 * Deletes WAL (Write-Ahead Logging) files in the "wal_logs" directory
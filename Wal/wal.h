@@ -20,13 +20,14 @@
 	wal.put("key", "data") upisuje data serijalizovan u fajl
 	wal.get("key") cita fajlove logova i vraca da li postoji key
 	wal.del("key") upisuje brisanje u fajl
+	wal.delRange("a", "b") upisuje brisanje opsega [a, b): key je pocetak, data kraj opsega
 
 	jedan record sastoji se iz:
 
 	4 bytova crc32 hash sum
 	1 byte flag
 	8 bytova timestamp (vreme u sekundama kad je upisan record)
-	1 byte tombstone (0 ako nije obrisan, 1 ako jeste)
+	1 byte tombstone (0 ako nije obrisan, 1 ako jeste, TOMBSTONE_RANGE za brisanje opsega)
 	8 byta keysize
 	8 byta datasize
 	keysize bytova key
@@ -34,6 +35,8 @@
 
 */
 
+constexpr std::byte TOMBSTONE_RANGE{ 4 };
+
 class Wal {
 private:
 	string log_directory;
@@ -61,6 +64,7 @@ public:
 
 	void put(string key, string data);
 	void del(string key);
+	void delRange(string begin, string end);
 
 	// returns ALL records that are in wal structure
 	vector<Record> get_all_records();